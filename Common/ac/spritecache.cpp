@@ -22,14 +22,24 @@
 #pragma warning (disable: 4996 4312)  // disable deprecation warnings
 #endif
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include "ac/common.h" // quit
 #include "ac/gamestructdefines.h"
 #include "ac/spritecache.h"
 #include "core/assetmanager.h"
 #include "debug/out.h"
 #include "gfx/bitmap.h"
+#include "util/bbop.h"
 #include "util/compress.h"
 #include "util/file.h"
+#include "util/filemapping.h"
 #include "util/stream.h"
 
 using namespace AGS::Common;
@@ -38,9 +48,6 @@ using namespace AGS::Common;
 extern void initialize_sprite(int);
 extern void pre_save_sprite(int);
 
-#define START_OF_LIST -1
-#define END_OF_LIST   -1
-
 const char *spindexid = "SPRINDEX";
 
 // TODO: should not be part of SpriteCache, but rather some asset management class?
@@ -56,10 +63,11 @@ SpriteInfo::SpriteInfo()
 }
 
 SpriteCache::SpriteData::SpriteData()
-    : Offset(0)
+    : Image(nullptr)
     , Size(0)
     , Flags(0)
-    , Image(nullptr)
+    , MruPrev(-1)
+    , MruNext(-1)
 {
 }
 
@@ -70,10 +78,46 @@ SpriteCache::SpriteData::~SpriteData()
 }
 
 
+// Max number of sprites waiting to be loaded by the background thread
+#define MAX_PREFETCH_QUEUE 256
+
+// State of the sprite prefetching, shared with the loading thread
+struct SpriteCache::PrefetchQueue
+{
+    struct Request
+    {
+        sprkey_t Index;
+        soff_t   Offset; // data offset
+    };
+    struct Result
+    {
+        bool Ok = false; // whether the sprite was read successfully
+        SpriteDataHeader Header; // color depth 0 means there's no sprite
+        std::vector<uint8_t> Pixels; // packed lines
+    };
+
+    std::unique_ptr<Stream> In; // separate stream for the loading thread
+    const FileMapping *Mapping = nullptr; // mapped sprite file, used instead of stream
+    SpriteFileVersion Version = kSprfVersion_Current;
+    SpriteCompression Compression = kSprCompress_None;
+    std::thread Thread;
+    std::mutex Mutex;
+    std::condition_variable RequestCond; // signals new request or stop
+    std::condition_variable ResultCond;  // signals finished loading
+    std::deque<Request> Requests;
+    std::unordered_map<sprkey_t, Result> Results;
+    size_t ResultsSize = 0; // pixel data size of the results
+    std::unordered_set<sprkey_t> Pending; // queued, loading or loaded
+    bool Stop = false;
+};
+
+
 SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos)
     : _sprInfos(sprInfos)
 {
-    _compressed = false;
+    _version = kSprfVersion_Current;
+    _compression = kSprCompress_None;
+    _useMapping = false;
     Init();
 }
 
@@ -121,13 +165,15 @@ void SpriteCache::Init()
     _cacheSize = 0;
     _lockedSize = 0;
     _maxCacheSize = (size_t)DEFAULTCACHESIZE_KB * 1024;
-    _liststart = -1;
-    _listend = -1;
+    _mruOldest = -1;
+    _mruNewest = -1;
     _lastLoad = -2;
 }
 
 void SpriteCache::Reset()
 {
+    StopPrefetch();
+    _mapping.reset();
     _stream.reset();
     // TODO: find out if it's safe to simply always delete _spriteData.Image with array element
     for (size_t i = 0; i < _spriteData.size(); ++i)
@@ -139,9 +185,7 @@ void SpriteCache::Reset()
         }
     }
     _spriteData.clear();
-
-    _mrulist.clear();
-    _mrubacklink.clear();
+    _spriteOffsets.clear();
 
     Init();
 }
@@ -158,10 +202,14 @@ void SpriteCache::SetSprite(sprkey_t index, Bitmap *sprite)
         Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SetSprite: attempt to assign nullptr to index %d", index);
         return;
     }
+    UnlinkSprite(index);
+    // the sprite loaded from the asset file no longer counts in the cache
+    if (_spriteData[index].Image)
+        _cacheSize -= _spriteData[index].Size;
     _spriteData[index].Image = sprite;
     _spriteData[index].Flags = SPRCACHEFLAG_LOCKED; // NOT from asset file
-    _spriteData[index].Offset = 0;
     _spriteData[index].Size = 0;
+    _spriteOffsets[index] = 0;
 #ifdef DEBUG_SPRITECACHE
     Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Debug, "SetSprite: (external) %d", index);
 #endif
@@ -194,6 +242,9 @@ void SpriteCache::SubstituteBitmap(sprkey_t index, Common::Bitmap *sprite)
 
 void SpriteCache::RemoveSprite(sprkey_t index, bool freeMemory)
 {
+    UnlinkSprite(index);
+    if (_spriteData[index].Image)
+        _cacheSize -= _spriteData[index].Size;
     if (freeMemory)
         delete _spriteData[index].Image;
     InitNullSpriteParams(index);
@@ -212,8 +263,7 @@ sprkey_t SpriteCache::EnlargeTo(sprkey_t topmost)
     size_t newsize = topmost + 1;
     _sprInfos.resize(newsize);
     _spriteData.resize(newsize);
-    _mrulist.resize(newsize);
-    _mrubacklink.resize(newsize);
+    _spriteOffsets.resize(newsize);
     return topmost;
 }
 
@@ -226,6 +276,7 @@ sprkey_t SpriteCache::GetFreeIndex()
         {
             _sprInfos[i] = SpriteInfo();
             _spriteData[i] = SpriteData();
+            _spriteOffsets[i] = 0;
             return i;
         }
     }
@@ -273,50 +324,58 @@ Bitmap *SpriteCache::operator [] (sprkey_t index)
 
     // Sprite exists in file but is not in mem, load it
     if ((_spriteData[index].Image == nullptr) && _spriteData[index].IsAssetSprite())
-        LoadSprite(index);
+    {
+        if (!TakePrefetched(index))
+            LoadSprite(index);
+    }
 
     // Locked sprite that shouldn't be put into MRU list
     if (_spriteData[index].IsLocked())
         return _spriteData[index].Image;
 
-    if (_liststart < 0)
-    {
-        _liststart = index;
-        _listend = index;
-        _mrulist[index] = END_OF_LIST;
-        _mrubacklink[index] = START_OF_LIST;
-    } 
-    else if (_listend != index)
-    {
-        // this is the oldest element being bumped to newest, so update start link
-        if (index == _liststart)
-        {
-            _liststart = _mrulist[index];
-            _mrubacklink[_liststart] = START_OF_LIST;
-        }
-        // already in list, link previous to next
-        else if (_mrulist[index] > 0)
-        {
-            _mrulist[_mrubacklink[index]] = _mrulist[index];
-            _mrubacklink[_mrulist[index]] = _mrubacklink[index];
-        }
+    TouchSprite(index);
+    return _spriteData[index].Image;
+}
 
-        // set this as the newest element in the list
-        _mrulist[index] = END_OF_LIST;
-        _mrulist[_listend] = index;
-        _mrubacklink[index] = _listend;
-        _listend = index;
-    }
+void SpriteCache::TouchSprite(sprkey_t index)
+{
+    if (_mruNewest == index)
+        return;
+    UnlinkSprite(index);
+    // set this as the newest element in the list
+    _spriteData[index].MruPrev = _mruNewest;
+    _spriteData[index].MruNext = -1;
+    if (_mruNewest >= 0)
+        _spriteData[_mruNewest].MruNext = index;
+    else
+        _mruOldest = index;
+    _mruNewest = index;
+}
 
-    return _spriteData[index].Image;
+void SpriteCache::UnlinkSprite(sprkey_t index)
+{
+    SpriteData &spr = _spriteData[index];
+    if (spr.MruPrev < 0 && _mruOldest != index)
+        return; // not in list
+    if (spr.MruPrev >= 0)
+        _spriteData[spr.MruPrev].MruNext = spr.MruNext;
+    else
+        _mruOldest = spr.MruNext;
+    if (spr.MruNext >= 0)
+        _spriteData[spr.MruNext].MruPrev = spr.MruPrev;
+    else
+        _mruNewest = spr.MruPrev;
+    spr.MruPrev = -1;
+    spr.MruNext = -1;
 }
 
 void SpriteCache::DisposeOldest()
 {
-    if (_liststart < 0)
+    if (_mruOldest < 0)
         return;
 
-    sprkey_t sprnum = _liststart;
+    sprkey_t sprnum = _mruOldest;
+    UnlinkSprite(sprnum);
 
     if ((_spriteData[sprnum].Image != nullptr) && !_spriteData[sprnum].IsLocked())
     {
@@ -333,34 +392,11 @@ void SpriteCache::DisposeOldest()
         _spriteData[sprnum].Image = nullptr;
     }
 
-    if (_liststart == _listend)
-    {
-        // there was one huge sprite, removing it has now emptied the cache completely
-        if (_cacheSize > 0)
-        {
-            Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SPRITE CACHE ERROR: Sprite cache should be empty, but still has %d bytes", _cacheSize);
-        }
-        _mrulist[_liststart] = 0;
-        _liststart = -1;
-        _listend = -1;
-    }
-    else
+    if (_mruOldest < 0 && _cacheSize > _lockedSize)
     {
-        sprkey_t oldstart = _liststart;
-        _liststart = _mrulist[_liststart];
-        _mrulist[oldstart] = 0;
-        _mrubacklink[_liststart] = START_OF_LIST;
-        if (oldstart == _liststart)
-        {
-            // Somehow, we have got a recursive link to itself, so we
-            // the game will freeze (since it is not actually freeing any
-            // memory)
-            // There must be a bug somewhere causing this, but for now
-            // let's just reset the cache
-            Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "RUNTIME CACHE ERROR: CACHE INCONSISTENT: RESETTING\n\tAt size %d (of %d), start %d end %d  fwdlink=%d",
-                        _cacheSize, _maxCacheSize, oldstart, _listend, _liststart);
-            DisposeAll();
-        }
+        // the list is empty, so only the locked sprites should be in cache now
+        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SPRITE CACHE ERROR: Sprite cache should be empty, but still has %d bytes",
+            _cacheSize - _lockedSize);
     }
 
 #ifdef DEBUG_SPRITECACHE
@@ -370,20 +406,21 @@ void SpriteCache::DisposeOldest()
 
 void SpriteCache::DisposeAll()
 {
-    _liststart = -1;
-    _listend = -1;
+    _mruOldest = -1;
+    _mruNewest = -1;
     for (size_t i = 0; i < _spriteData.size(); ++i)
     {
         if (!_spriteData[i].IsLocked() && // not locked
             _spriteData[i].IsAssetSprite()) // sprite from game resource
         {
+            if (_spriteData[i].Image)
+                _cacheSize -= _spriteData[i].Size;
             delete _spriteData[i].Image;
             _spriteData[i].Image = nullptr;
         }
-        _mrulist[i] = 0;
-        _mrubacklink[i] = 0;
+        _spriteData[i].MruPrev = -1;
+        _spriteData[i].MruNext = -1;
     }
-    _cacheSize = _lockedSize;
 }
 
 void SpriteCache::Precache(sprkey_t index)
@@ -403,6 +440,7 @@ void SpriteCache::Precache(sprkey_t index)
     _lockedSize += sprSize;
 
     _spriteData[index].Flags |= SPRCACHEFLAG_LOCKED;
+    UnlinkSprite(index); // locked sprites are not tracked in MRU list
 
 #ifdef DEBUG_SPRITECACHE
     Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Debug, "Precached %d", index);
@@ -418,15 +456,27 @@ void SpriteCache::SeekToSprite(sprkey_t index)
 {
     // If we didn't just load the previous sprite, seek to it
     if (index - 1 != _lastLoad)
-        _stream->Seek(_spriteData[index].Offset, kSeekBegin);
+        _stream->Seek(_spriteOffsets[index], kSeekBegin);
 }
 
-size_t SpriteCache::LoadSprite(sprkey_t index)
+size_t SpriteCache::GetPrefetchedSize()
+{
+    if (!_prefetch)
+        return 0;
+    std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+    return _prefetch->ResultsSize;
+}
+
+void SpriteCache::FreeMem()
 {
     int hh = 0;
 
-    while (_cacheSize > _maxCacheSize)
+    // the prefetched sprites waiting to be put into the cache take space too
+    const size_t prefetched_size = GetPrefetchedSize();
+    while (_cacheSize + prefetched_size > _maxCacheSize)
     {
+        if (_mruOldest < 0 && _cacheSize <= _maxCacheSize)
+            break; // nothing else may be disposed to make room for them
         DisposeOldest();
         hh++;
         if (hh > 1000)
@@ -435,62 +485,299 @@ size_t SpriteCache::LoadSprite(sprkey_t index)
             DisposeAll();
         }
     }
+}
 
-    if (index < 0 || (size_t)index >= _spriteData.size())
-        quit("sprite cache array index out of bounds");
+SpriteCompression SpriteCache::ReadSpriteFormat(Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp,
+    int width, int height, int coldep, size_t &data_size)
+{
+    if (vers >= kSprfVersion_StorageFormats)
+    {
+        SpriteCompression cmp = (SpriteCompression)in->ReadInt8();
+        data_size = (uint32_t)in->ReadInt32();
+        return cmp;
+    }
+    // older files have same compression for all sprites,
+    // and only compressed sprites have their data size written
+    if (file_cmp == kSprCompress_RLE)
+        data_size = (uint32_t)in->ReadInt32();
+    else
+        data_size = (size_t)width * height * coldep;
+    return file_cmp;
+}
 
-    sprkey_t load_index = GetDataIndex(index);
-    SeekToSprite(load_index);
+// Tells if the sprite properties read from the file make sense
+static bool IsValidSpriteHeader(const SpriteDataHeader &hdr)
+{
+    return (hdr.ColorDepth >= 1) && (hdr.ColorDepth <= 4) && (hdr.Width >= 0) && (hdr.Height >= 0);
+}
 
-    int coldep = _stream->ReadInt16();
+bool SpriteCache::ReadSpriteHeader(Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp, SpriteDataHeader &hdr)
+{
+    hdr = SpriteDataHeader();
+    hdr.ColorDepth = in->ReadInt16();
+    if (hdr.ColorDepth == 0)
+        return true;
+    hdr.Width = in->ReadInt16();
+    hdr.Height = in->ReadInt16();
+    if (!IsValidSpriteHeader(hdr))
+        return false;
+    hdr.Compression = ReadSpriteFormat(in, vers, file_cmp, hdr.Width, hdr.Height, hdr.ColorDepth, hdr.DataSize);
+    return true;
+}
 
-    if (coldep == 0)
+// Reads little-endian values from the memory buffer
+static inline int16_t MemReadInt16(const uint8_t *&p)
+{
+    int16_t v;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return BBOp::Int16FromLE(v);
+}
+
+static inline int32_t MemReadInt32(const uint8_t *&p)
+{
+    int32_t v;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return BBOp::Int32FromLE(v);
+}
+
+bool SpriteCache::ReadSpriteHeader(const uint8_t *&data, const uint8_t *data_end,
+    SpriteFileVersion vers, SpriteCompression file_cmp, SpriteDataHeader &hdr)
+{
+    hdr = SpriteDataHeader();
+    if (data + sizeof(int16_t) > data_end)
+        return false;
+    hdr.ColorDepth = MemReadInt16(data);
+    if (hdr.ColorDepth == 0)
+        return true;
+    if (data + 2 * sizeof(int16_t) > data_end)
+        return false;
+    hdr.Width = MemReadInt16(data);
+    hdr.Height = MemReadInt16(data);
+    if (!IsValidSpriteHeader(hdr))
+        return false;
+    hdr.Compression = file_cmp;
+    hdr.DataSize = (size_t)hdr.Width * hdr.Height * hdr.ColorDepth;
+    if (vers >= kSprfVersion_StorageFormats)
     {
-        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "LoadSprite: asked to load sprite %d (for slot %d) which does not exist.", load_index, index);
-        _lastLoad = load_index;
-        return 0;
+        if (data + sizeof(int8_t) + sizeof(int32_t) > data_end)
+            return false;
+        hdr.Compression = (SpriteCompression)*(data++);
+        hdr.DataSize = (uint32_t)MemReadInt32(data);
     }
+    else if (file_cmp == kSprCompress_RLE)
+    {
+        if (data + sizeof(int32_t) > data_end)
+            return false;
+        hdr.DataSize = (uint32_t)MemReadInt32(data);
+    }
+    return true;
+}
 
-    int wdd = _stream->ReadInt16();
-    int htt = _stream->ReadInt16();
-    // update the stored width/height
-    _sprInfos[index].Width = wdd;
-    _sprInfos[index].Height = htt;
-
-    _spriteData[index].Image = BitmapHelper::CreateBitmap(wdd, htt, coldep * 8);
-    if (_spriteData[index].Image == nullptr)
+bool SpriteCache::ReadSpritePixels(Stream *in, const SpriteDataHeader &hdr, uint8_t *pixels, size_t pitch)
+{
+    if (!IsValidSpriteHeader(hdr))
+        return false;
+    if (hdr.Compression != kSprCompress_None)
     {
-        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn, "LoadSprite: failed to init sprite %d, remapping to sprite 0.", index);
-        RemapSpriteToSprite0(index);
-        return 0;
+        // read the whole compressed data and unpack it from memory
+        std::vector<uint8_t> buf(hdr.DataSize);
+        if (in->Read(buf.data(), hdr.DataSize) != hdr.DataSize)
+            return false;
+        return ReadSpritePixels(buf.data(), buf.data() + buf.size(), hdr, pixels, pitch);
     }
 
-    Bitmap *image = _spriteData[index].Image;
-    if (this->_compressed) 
+    const int coldep = hdr.ColorDepth;
+    const size_t line_len = hdr.Width * coldep;
+    for (int y = 0; y < hdr.Height; ++y)
     {
-        _stream->ReadInt32(); // skip data size
-        UnCompressSprite(image, _stream.get());
+        uint8_t *line = pixels + y * pitch;
+        size_t read_len;
+        if (coldep == 2)
+            read_len = in->ReadArrayOfInt16((int16_t*)line, hdr.Width) * coldep;
+        else if (coldep == 4)
+            read_len = in->ReadArrayOfInt32((int32_t*)line, hdr.Width) * coldep;
+        else
+            read_len = in->Read(line, line_len);
+        if (read_len != line_len)
+            return false;
     }
-    else
+    return true;
+}
+
+bool SpriteCache::ReadSpritePixels(const uint8_t *data, const uint8_t *data_end, const SpriteDataHeader &hdr,
+    uint8_t *pixels, size_t pitch)
+{
+    const int coldep = hdr.ColorDepth;
+    if (!IsValidSpriteHeader(hdr))
+        return false;
+    if ((size_t)(data_end - data) < hdr.DataSize)
+        return false;
+    data_end = data + hdr.DataSize;
+    const size_t line_len = hdr.Width * coldep;
+
+    switch (hdr.Compression)
     {
-        if (coldep == 1)
+    case kSprCompress_None:
+        if (hdr.DataSize < line_len * hdr.Height)
+            return false;
+        for (int y = 0; y < hdr.Height; ++y, data += line_len)
+            memcpy(pixels + y * pitch, data, line_len);
+        break;
+    case kSprCompress_RLE:
+        // RLE unpacking converts the pixel values from little-endian itself
+        for (int y = 0; (y < hdr.Height) && data; ++y)
         {
-            for (hh = 0; hh < htt; hh++)
-                _stream->ReadArray(&image->GetScanLineForWriting(hh)[0], coldep, wdd);
+            uint8_t *line = pixels + y * pitch;
+            if (coldep == 1)
+                data = cunpackbitl(line, hdr.Width, data, data_end);
+            else if (coldep == 2)
+                data = cunpackbitl16((uint16_t*)line, hdr.Width, data, data_end);
+            else if (coldep == 4)
+                data = cunpackbitl32((uint32_t*)line, hdr.Width, data, data_end);
+            else
+                return false; // 24-bit sprites were never RLE compressed
         }
-        else if (coldep == 2)
+        return data != nullptr;
+    case kSprCompress_LZ4:
+        if (pitch == line_len)
         {
-            for (hh = 0; hh < htt; hh++)
-                _stream->ReadArrayOfInt16((int16_t*)&image->GetScanLineForWriting(hh)[0], wdd);
+            if (!lz4_decompress(data, hdr.DataSize, pixels, line_len * hdr.Height))
+                return false;
         }
         else
         {
-            for (hh = 0; hh < htt; hh++)
-                _stream->ReadArrayOfInt32((int32_t*)&image->GetScanLineForWriting(hh)[0], wdd);
+            std::vector<uint8_t> buf(line_len * hdr.Height);
+            if (!lz4_decompress(data, hdr.DataSize, buf.data(), buf.size()))
+                return false;
+            for (int y = 0; y < hdr.Height; ++y)
+                memcpy(pixels + y * pitch, &buf[y * line_len], line_len);
+        }
+        break;
+    default:
+        return false; // unknown compression
+    }
+
+#if AGS_PLATFORM_ENDIAN_BIG
+    // the raw pixels are stored in little-endian order
+    for (int y = 0; y < hdr.Height; ++y)
+    {
+        uint8_t *line = pixels + y * pitch;
+        if (coldep == 2)
+        {
+            for (int x = 0; x < hdr.Width; ++x)
+                ((int16_t*)line)[x] = BBOp::SwapBytesInt16(((int16_t*)line)[x]);
+        }
+        else if (coldep == 4)
+        {
+            for (int x = 0; x < hdr.Width; ++x)
+                ((int32_t*)line)[x] = BBOp::SwapBytesInt32(((int32_t*)line)[x]);
         }
     }
+#endif
+    return true;
+}
 
-    _lastLoad = load_index;
+// Creates the bitmap for the sprite and reads its pixels using the given function;
+// returns null if the bitmap could not be created or the pixels not read
+template <typename TReadPixels>
+static Bitmap *CreateSpriteImage(const SpriteDataHeader &hdr, TReadPixels read_pixels)
+{
+    Bitmap *image = BitmapHelper::CreateBitmap(hdr.Width, hdr.Height, hdr.ColorDepth * 8);
+    if (image == nullptr)
+        return nullptr;
+    if (!read_pixels(image->GetDataForWriting(), image->GetLineLength()))
+    {
+        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn, "ReadSpriteImage: failed to read sprite data (compression type %d)", hdr.Compression);
+        delete image;
+        return nullptr;
+    }
+    return image;
+}
+
+int SpriteCache::ReadSpriteImage(Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp, Bitmap *&image)
+{
+    image = nullptr;
+    SpriteDataHeader hdr;
+    if (!ReadSpriteHeader(in, vers, file_cmp, hdr) || hdr.ColorDepth == 0)
+        return hdr.ColorDepth; // no sprite, or the header is corrupt
+    image = CreateSpriteImage(hdr, [in, &hdr](uint8_t *pixels, size_t pitch)
+        { return ReadSpritePixels(in, hdr, pixels, pitch); });
+    return hdr.ColorDepth;
+}
+
+// Gets the sprite file data at the given offset from the mapping;
+// returns false if the offset is outside of the mapped data
+static bool GetMappedData(const FileMapping &mapping, soff_t offset, const uint8_t *&data, const uint8_t *&data_end)
+{
+    if (offset < mapping.GetOffset() || (size_t)(offset - mapping.GetOffset()) >= mapping.GetSize())
+        return false;
+    data = mapping.GetData() + (offset - mapping.GetOffset());
+    data_end = mapping.GetData() + mapping.GetSize();
+    return true;
+}
+
+int SpriteCache::ReadSpriteImage(const FileMapping &mapping, soff_t offset,
+    SpriteFileVersion vers, SpriteCompression file_cmp, Bitmap *&image)
+{
+    image = nullptr;
+    const uint8_t *data, *data_end;
+    SpriteDataHeader hdr;
+    if (!GetMappedData(mapping, offset, data, data_end) ||
+        !ReadSpriteHeader(data, data_end, vers, file_cmp, hdr))
+        return -1;
+    if (hdr.ColorDepth == 0)
+        return 0;
+    image = CreateSpriteImage(hdr, [data, data_end, &hdr](uint8_t *pixels, size_t pitch)
+        { return ReadSpritePixels(data, data_end, hdr, pixels, pitch); });
+    return hdr.ColorDepth;
+}
+
+size_t SpriteCache::LoadSprite(sprkey_t index)
+{
+    FreeMem();
+
+    if (index < 0 || (size_t)index >= _spriteData.size())
+        quit("sprite cache array index out of bounds");
+
+    sprkey_t load_index = GetDataIndex(index);
+    Bitmap *image = nullptr;
+    int coldep = 0;
+    if (_mapping)
+    {
+        // NOTE: this does not change the stream position, so _lastLoad is kept
+        coldep = ReadSpriteImage(*_mapping, _spriteOffsets[load_index], _version, _compression, image);
+        if (coldep != 0 && !image)
+            Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn, "LoadSprite: failed to read sprite %d from the mapped file, trying file stream.", load_index);
+    }
+    if (!_mapping || (coldep != 0 && !image))
+    {
+        SeekToSprite(load_index);
+        coldep = ReadSpriteImage(_stream.get(), _version, _compression, image);
+        if (coldep == 0 || image)
+            _lastLoad = load_index; // otherwise the stream is left in the middle of sprite data
+    }
+    if (coldep == 0)
+    {
+        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "LoadSprite: asked to load sprite %d (for slot %d) which does not exist.", load_index, index);
+        return 0;
+    }
+    return InitLoadedSprite(index, image, coldep);
+}
+
+size_t SpriteCache::InitLoadedSprite(sprkey_t index, Bitmap *image, int coldep)
+{
+    _spriteData[index].Image = image;
+    if (_spriteData[index].Image == nullptr)
+    {
+        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn, "LoadSprite: failed to init sprite %d, remapping to sprite 0.", index);
+        RemapSpriteToSprite0(index);
+        return 0;
+    }
+    // update the stored width/height
+    _sprInfos[index].Width = image->GetWidth();
+    _sprInfos[index].Height = image->GetHeight();
 
     // Stop it adding the sprite to the used list just because it's loaded
     // TODO: this messy hack is required, because initialize_sprite calls operator[]
@@ -505,9 +792,11 @@ size_t SpriteCache::LoadSprite(sprkey_t index)
     if (index != 0)  // leave sprite 0 locked
         _spriteData[index].Flags &= ~SPRCACHEFLAG_LOCKED;
 
-    // we need to store this because the main program might
-    // alter spritewidth/height if it resizes stuff
-    size_t size = _sprInfos[index].Width * _sprInfos[index].Height * coldep;
+    // take the size of the final image, because the engine might convert
+    // or resize the sprite when initializing it
+    Bitmap *final_image = _spriteData[index].Image;
+    size_t size = final_image ?
+        final_image->GetWidth() * final_image->GetHeight() * final_image->GetBPP() : 0;
     _spriteData[index].Size = size;
     _cacheSize += size;
 
@@ -518,13 +807,191 @@ size_t SpriteCache::LoadSprite(sprkey_t index)
     return size;
 }
 
+void SpriteCache::Prefetch(sprkey_t index)
+{
+    if (index < 0 || (size_t)index >= _spriteData.size())
+        return;
+    if (_spriteData[index].Image != nullptr || !_spriteData[index].IsAssetSprite())
+        return;
+    if (_filename.IsEmpty())
+        return;
+
+    if (!_prefetch)
+    {
+        std::unique_ptr<Stream> in;
+        if (!_mapping)
+        {
+            in.reset(Common::AssetManager::OpenAsset(_filename));
+            if (!in)
+                return;
+        }
+        _prefetch.reset(new PrefetchQueue());
+        _prefetch->In = std::move(in);
+        _prefetch->Mapping = _mapping.get();
+        _prefetch->Version = _version;
+        _prefetch->Compression = _compression;
+        try
+        {
+            _prefetch->Thread = std::thread(PrefetchThread, _prefetch.get());
+        }
+        catch (const std::system_error &)
+        {
+            Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "Prefetch: failed to start sprite loading thread");
+            _filename = ""; // don't try again
+            _prefetch.reset();
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+    if (_prefetch->Requests.size() >= MAX_PREFETCH_QUEUE)
+        return;
+    if (_lockedSize + _prefetch->ResultsSize >= _maxCacheSize)
+        return; // the loaded sprites waiting to be taken fill the cache already
+    if (!_prefetch->Pending.insert(index).second)
+        return; // already scheduled
+    PrefetchQueue::Request req;
+    req.Index = index;
+    req.Offset = _spriteOffsets[GetDataIndex(index)];
+    _prefetch->Requests.push_back(req);
+    _prefetch->RequestCond.notify_one();
+}
+
+void SpriteCache::PrefetchThread(PrefetchQueue *queue)
+{
+    std::unique_lock<std::mutex> lk(queue->Mutex);
+    for (;;)
+    {
+        queue->RequestCond.wait(lk, [queue]() { return queue->Stop || !queue->Requests.empty(); });
+        if (queue->Stop)
+            break;
+        PrefetchQueue::Request req = queue->Requests.front();
+        queue->Requests.pop_front();
+        lk.unlock();
+
+        // the pixels are read into the plain buffer, because bitmaps
+        // must be created on the main thread
+        PrefetchQueue::Result res;
+        SpriteDataHeader &hdr = res.Header;
+        if (queue->Mapping)
+        {
+            const uint8_t *data, *data_end;
+            if (GetMappedData(*queue->Mapping, req.Offset, data, data_end) &&
+                ReadSpriteHeader(data, data_end, queue->Version, queue->Compression, hdr))
+            {
+                res.Pixels.resize((size_t)hdr.Width * hdr.Height * hdr.ColorDepth);
+                res.Ok = hdr.ColorDepth == 0 ||
+                    ReadSpritePixels(data, data_end, hdr, res.Pixels.data(), hdr.Width * hdr.ColorDepth);
+            }
+        }
+        else
+        {
+            queue->In->Seek(req.Offset, kSeekBegin);
+            if (ReadSpriteHeader(queue->In.get(), queue->Version, queue->Compression, hdr))
+            {
+                res.Pixels.resize((size_t)hdr.Width * hdr.Height * hdr.ColorDepth);
+                res.Ok = hdr.ColorDepth == 0 ||
+                    ReadSpritePixels(queue->In.get(), hdr, res.Pixels.data(), hdr.Width * hdr.ColorDepth);
+            }
+        }
+        if (!res.Ok)
+            res.Pixels.clear();
+
+        lk.lock();
+        queue->ResultsSize += res.Pixels.size();
+        queue->Results[req.Index] = std::move(res);
+        queue->ResultCond.notify_all();
+    }
+}
+
+bool SpriteCache::TakePrefetched(sprkey_t index)
+{
+    if (!_prefetch)
+        return false;
+
+    std::unordered_map<sprkey_t, PrefetchQueue::Result> results;
+    bool found;
+    {
+        std::unique_lock<std::mutex> lk(_prefetch->Mutex);
+        found = _prefetch->Pending.count(index) > 0;
+        if (found)
+        {
+            // if the sprite is still in queue, move it to the front
+            for (auto it = _prefetch->Requests.begin(); it != _prefetch->Requests.end(); ++it)
+            {
+                if (it->Index == index)
+                {
+                    PrefetchQueue::Request req = *it;
+                    _prefetch->Requests.erase(it);
+                    _prefetch->Requests.push_front(req);
+                    break;
+                }
+            }
+            _prefetch->ResultCond.wait(lk, [this, index]() { return _prefetch->Results.count(index) > 0; });
+        }
+        results.swap(_prefetch->Results);
+        _prefetch->ResultsSize = 0;
+        for (const auto &r : results)
+            _prefetch->Pending.erase(r.first);
+    }
+
+    // Put all the loaded sprites into the cache
+    for (const auto &r : results)
+    {
+        sprkey_t spr = r.first;
+        if ((size_t)spr >= _spriteData.size() || _spriteData[spr].Image != nullptr ||
+            !_spriteData[spr].IsAssetSprite())
+            continue; // slot has changed meanwhile
+        const SpriteDataHeader &hdr = r.second.Header;
+        const std::vector<uint8_t> &pixels = r.second.Pixels;
+        if (!r.second.Ok)
+        {
+            // failed to read; let the requested sprite be loaded the usual way
+            if (spr == index)
+                found = false;
+            continue;
+        }
+        FreeMem();
+        if (hdr.ColorDepth == 0)
+        {
+            Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "LoadSprite: asked to load sprite %d which does not exist.", spr);
+            continue;
+        }
+        Bitmap *image = BitmapHelper::CreateBitmap(hdr.Width, hdr.Height, hdr.ColorDepth * 8);
+        if (image)
+        {
+            const size_t line_len = image->GetLineLength();
+            for (int y = 0; y < hdr.Height; ++y)
+                memcpy(image->GetScanLineForWriting(y), &pixels[y * line_len], line_len);
+        }
+        InitLoadedSprite(spr, image, hdr.ColorDepth);
+        // the requested sprite is added to the MRU list by the caller
+        if (spr != index && !_spriteData[spr].IsLocked() && _spriteData[spr].Image)
+            TouchSprite(spr);
+    }
+    return found;
+}
+
+void SpriteCache::StopPrefetch()
+{
+    if (!_prefetch)
+        return;
+    {
+        std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+        _prefetch->Stop = true;
+        _prefetch->RequestCond.notify_one();
+    }
+    _prefetch->Thread.join();
+    _prefetch.reset();
+}
+
 void SpriteCache::RemapSpriteToSprite0(sprkey_t index)
 {
     _sprInfos[index].Flags = _sprInfos[0].Flags;
     _sprInfos[index].Width = _sprInfos[0].Width;
     _sprInfos[index].Height = _sprInfos[0].Height;
     _spriteData[index].Image = nullptr;
-    _spriteData[index].Offset = _spriteData[0].Offset;
+    _spriteOffsets[index] = _spriteOffsets[0];
     _spriteData[index].Size = _spriteData[0].Size;
     _spriteData[index].Flags |= SPRCACHEFLAG_REMAPPED;
 #ifdef DEBUG_SPRITECACHE
@@ -534,44 +1001,89 @@ void SpriteCache::RemapSpriteToSprite0(sprkey_t index)
 
 const char *spriteFileSig = " Sprite File ";
 
-void SpriteCache::CompressSprite(Bitmap *sprite, Stream *out)
+void SpriteCache::WriteSprite(Stream *out, const uint8_t *pixels, size_t pitch,
+    int width, int height, int coldep, SpriteCompression cmp)
 {
-    const int depth = sprite->GetBPP();
-    if (depth == 1)
-    {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cpackbitl(&sprite->GetScanLineForWriting(y)[0], sprite->GetWidth(), out);
-    }
-    else if (depth == 2)
+    out->WriteInt16(coldep);
+    out->WriteInt16(width);
+    out->WriteInt16(height);
+
+    const size_t line_len = width * coldep;
+    const size_t data_size = line_len * height;
+    if (cmp == kSprCompress_LZ4)
     {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cpackbitl16((unsigned short *)&sprite->GetScanLine(y)[0], sprite->GetWidth(), out);
+        // gather the lines and convert them to little-endian before packing
+        std::vector<uint8_t> buf(data_size);
+        for (int y = 0; y < height; ++y)
+            memcpy(&buf[y * line_len], pixels + y * pitch, line_len);
+#if AGS_PLATFORM_ENDIAN_BIG
+        const size_t pixel_count = width * height;
+        if (coldep == 2)
+        {
+            for (size_t i = 0; i < pixel_count; ++i)
+                ((int16_t*)buf.data())[i] = BBOp::SwapBytesInt16(((int16_t*)buf.data())[i]);
+        }
+        else if (coldep == 4)
+        {
+            for (size_t i = 0; i < pixel_count; ++i)
+                ((int32_t*)buf.data())[i] = BBOp::SwapBytesInt32(((int32_t*)buf.data())[i]);
+        }
+#endif
+        std::vector<uint8_t> packed;
+        lz4_compress(buf.data(), buf.size(), packed);
+        // store the sprite as is if compression does not gain anything
+        if (packed.size() < data_size)
+        {
+            out->WriteInt8(kSprCompress_LZ4);
+            out->WriteInt32(packed.size());
+            out->WriteArray(packed.data(), packed.size(), 1);
+            return;
+        }
     }
-    else
+
+    out->WriteInt8(kSprCompress_None);
+    out->WriteInt32(data_size);
+    for (int y = 0; y < height; ++y)
     {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cpackbitl32((unsigned int *)&sprite->GetScanLine(y)[0], sprite->GetWidth(), out);
+        const uint8_t *line = pixels + y * pitch;
+        if (coldep == 2)
+            out->WriteArrayOfInt16((const int16_t*)line, width);
+        else if (coldep == 4)
+            out->WriteArrayOfInt32((const int32_t*)line, width);
+        else
+            out->Write(line, line_len);
     }
 }
 
-void SpriteCache::UnCompressSprite(Bitmap *sprite, Stream *in)
+bool SpriteCache::CopySprite(Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp,
+    Stream *out, bool compressed, SpriteDataHeader &hdr)
 {
-    const int depth = sprite->GetBPP();
-    if (depth == 1)
-    {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cunpackbitl(&sprite->GetScanLineForWriting(y)[0], sprite->GetWidth(), in);
-    }
-    else if (depth == 2)
+    if (!ReadSpriteHeader(in, vers, file_cmp, hdr))
+        return false;
+    if (hdr.ColorDepth == 0)
     {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cunpackbitl16((unsigned short*)&sprite->GetScanLineForWriting(y)[0], sprite->GetWidth(), in);
+        out->WriteInt16(0);
+        return true;
     }
-    else
+    if ((hdr.Compression != kSprCompress_None) != compressed)
+        return false;
+
+    out->WriteInt16(hdr.ColorDepth);
+    out->WriteInt16(hdr.Width);
+    out->WriteInt16(hdr.Height);
+    out->WriteInt8(hdr.Compression);
+    out->WriteInt32(hdr.DataSize);
+
+    const size_t buf_size = 100000;
+    std::vector<uint8_t> buf(std::min(hdr.DataSize, buf_size));
+    for (size_t copied = 0; copied < hdr.DataSize;)
     {
-        for (int y = 0; y < sprite->GetHeight(); y++)
-            cunpackbitl32((unsigned int*)&sprite->GetScanLineForWriting(y)[0], sprite->GetWidth(), in);
+        const size_t copy_size = std::min(hdr.DataSize - copied, buf_size);
+        in->Read(buf.data(), copy_size);
+        out->Write(buf.data(), copy_size);
+        copied += copy_size;
     }
+    return true;
 }
 
 int SpriteCache::SaveToFile(const char *filename, bool compressOutput, SpriteFileIndex &index)
@@ -580,15 +1092,7 @@ int SpriteCache::SaveToFile(const char *filename, bool compressOutput, SpriteFil
     if (output == nullptr)
         return -1;
 
-    if (compressOutput)
-    {
-        // re-open the file so that it can be seeked
-        delete output;
-        output = File::OpenFile(filename, Common::kFile_Open, Common::kFile_ReadWrite); // CHECKME why mode was "r+" here?
-        if (output == nullptr)
-            return -1;
-    }
-
+    const SpriteCompression compression = compressOutput ? kSprCompress_LZ4 : kSprCompress_None;
     int spriteFileIDCheck = (int)time(nullptr);
 
     // sprite file version
@@ -596,7 +1100,7 @@ int SpriteCache::SaveToFile(const char *filename, bool compressOutput, SpriteFil
 
     output->WriteArray(spriteFileSig, strlen(spriteFileSig), 1);
 
-    output->WriteInt8(compressOutput ? 1 : 0);
+    output->WriteInt8(compression);
     output->WriteInt32(spriteFileIDCheck);
 
     sprkey_t lastslot = FindTopmostSprite();
@@ -610,112 +1114,51 @@ int SpriteCache::SaveToFile(const char *filename, bool compressOutput, SpriteFil
     spriteheights.resize(numsprits);
     spriteoffs.resize(numsprits);
 
-    const int memBufferSize = 100000;
-    char *memBuffer = new char[memBufferSize];
-
     for (sprkey_t i = 0; i <= lastslot; ++i)
     {
         spriteoffs[i] = output->GetPosition();
 
-        // if compressing uncompressed sprites, load the sprite into memory
-        if ((_spriteData[i].Image == nullptr) && (this->_compressed != compressOutput))
+        if ((_spriteData[i].Image == nullptr) && (_spriteOffsets[i] != 0))
+        {
+            // not in memory -- seek to it in the source file
+            sprkey_t load_index = GetDataIndex(i);
+            SeekToSprite(load_index);
+            _lastLoad = load_index;
+
+            // the stored data is copied across if it is compressed (with
+            // any method) when the compression is requested, or raw when
+            // it's not; otherwise the sprite is loaded and re-encoded
+            SpriteDataHeader hdr;
+            if (CopySprite(_stream.get(), _version, _compression, output, compressOutput, hdr))
+            {
+                spritewidths[i] = hdr.Width;
+                spriteheights[i] = hdr.Height;
+                continue;
+            }
+
+            _lastLoad = -2; // the stream is in the middle of the sprite now
             (*this)[i];
+        }
 
         if (_spriteData[i].Image != nullptr)
         {
             // image in memory -- write it out
             pre_save_sprite(i);
             Bitmap *image = _spriteData[i].Image;
-            int bpss = image->GetColorDepth() / 8;
             spritewidths[i] = image->GetWidth();
             spriteheights[i] = image->GetHeight();
-            output->WriteInt16(bpss);
-            output->WriteInt16(spritewidths[i]);
-            output->WriteInt16(spriteheights[i]);
-
-            if (compressOutput)
-            {
-                size_t lenloc = output->GetPosition();
-                // write some space for the length data
-                output->WriteInt32(0);
-
-                CompressSprite(image, output);
-
-                size_t fileSizeSoFar = output->GetPosition();
-                // write the length of the compressed data
-                output->Seek(lenloc, kSeekBegin);
-                output->WriteInt32((fileSizeSoFar - lenloc) - 4);
-                output->Seek(0, kSeekEnd);
-            }
-            else
-            {
-                output->WriteArray(image->GetDataForWriting(), spritewidths[i] * bpss, spriteheights[i]);
-            }
+            WriteSprite(output, image->GetData(), image->GetLineLength(), image->GetWidth(), image->GetHeight(),
+                image->GetBPP(), compression);
             continue;
         }
 
-        if (_spriteData[i].Offset == 0)
-        {
-            // sprite doesn't exist
-            output->WriteInt16(0); // colour depth
-            spritewidths[i] = 0;
-            spriteheights[i] = 0;
-            spriteoffs[i] = 0;
-            continue;
-        }
-
-        // not in memory -- seek to it in the source file
-        sprkey_t load_index = GetDataIndex(i);
-        SeekToSprite(load_index);
-        _lastLoad = load_index;
-
-        short colDepth = _stream->ReadInt16();
-        output->WriteInt16(colDepth);
-
-        if (colDepth == 0)
-            continue;
-
-        if (this->_compressed != compressOutput)
-        {
-            // shouldn't be able to get here
-            delete [] memBuffer;
-            delete output;
-            return -2;
-        }
-
-        // and copy the data across
-        int width = _stream->ReadInt16();
-        int height = _stream->ReadInt16();
-
-        spritewidths[i] = width;
-        spriteheights[i] = height;
-
-        output->WriteInt16(width);
-        output->WriteInt16(height);
-
-        int sizeToCopy;
-        if (this->_compressed)
-        {
-            sizeToCopy = _stream->ReadInt32();
-            output->WriteInt32(sizeToCopy);
-        }
-        else
-        {
-            sizeToCopy = width * height * (int)colDepth;
-        }
-
-        while (sizeToCopy > memBufferSize)
-        {
-            _stream->ReadArray(memBuffer, memBufferSize, 1);
-            output->WriteArray(memBuffer, memBufferSize, 1);
-            sizeToCopy -= memBufferSize;
-        }
-
-        _stream->ReadArray(memBuffer, sizeToCopy, 1);
-        output->WriteArray(memBuffer, sizeToCopy, 1);
+        // sprite doesn't exist
+        output->WriteInt16(0); // colour depth
+        spritewidths[i] = 0;
+        spriteheights[i] = 0;
+        spriteoffs[i] = 0;
     }
 
-    delete [] memBuffer;
     delete output;
 
     index.SpriteFileIDCheck = spriteFileIDCheck;
@@ -759,9 +1202,12 @@ HError SpriteCache::InitFile(const char *filename, const char *sprindex_filename
     soff_t spr_initial_offs = 0;
     int spriteFileID = 0;
 
+    StopPrefetch();
     _stream.reset(Common::AssetManager::OpenAsset(filename));
     if (_stream == nullptr)
         return new Error(String::FromFormat("Failed to open spriteset file '%s'.", filename));
+    _filename = filename;
+    OpenMapping(filename);
 
     spr_initial_offs = _stream->GetPosition();
 
@@ -783,17 +1229,19 @@ HError SpriteCache::InitFile(const char *filename, const char *sprindex_filename
         return new Error("Uknown spriteset format.");
     }
 
+    _version = vers;
     if (vers == kSprfVersion_Uncompressed)
     {
-        this->_compressed = false;
+        _compression = kSprCompress_None;
     }
     else if (vers == kSprfVersion_Compressed)
     {
-        this->_compressed = true;
+        _compression = kSprCompress_RLE;
     }
     else if (vers >= kSprfVersion_Last32bit)
     {
-        this->_compressed = (_stream->ReadInt8() == 1);
+        // older versions only had 0 or 1 here, which match None and RLE
+        _compression = (SpriteCompression)_stream->ReadInt8();
         spriteFileID = _stream->ReadInt32();
     }
 
@@ -828,7 +1276,7 @@ HError SpriteCache::RebuildSpriteIndex(AGS::Common::Stream *in, sprkey_t topmost
 {
     for (sprkey_t i = 0; i <= topmost; ++i)
     {
-        _spriteData[i].Offset = in->GetPosition();
+        _spriteOffsets[i] = in->GetPosition();
         _spriteData[i].Flags = 0;
 
         int coldep = in->ReadInt16();
@@ -859,18 +1307,7 @@ HError SpriteCache::RebuildSpriteIndex(AGS::Common::Stream *in, sprkey_t topmost
         _sprInfos[i].Height = htt;
 
         size_t spriteDataSize;
-        if (vers == kSprfVersion_Compressed)
-        {
-            spriteDataSize = in->ReadInt32();
-        }
-        else if (vers >= kSprfVersion_Last32bit)
-        {
-            spriteDataSize = this->_compressed ? in->ReadInt32() : wdd * coldep * htt;
-        }
-        else
-        {
-            spriteDataSize = wdd * coldep * htt;
-        }
+        ReadSpriteFormat(in, vers, _compression, wdd, htt, coldep, spriteDataSize);
         in->Seek(spriteDataSize);
     }
     return HError::None();
@@ -946,7 +1383,7 @@ bool SpriteCache::LoadSpriteIndexFile(const char *filename, int expectedFileID,
         {
             // Store the sprite info
             _spriteData[i].Flags = SPRCACHEFLAG_ISASSET;
-            _spriteData[i].Offset = spriteoffs[i] + spr_initial_offs;
+            _spriteOffsets[i] = spriteoffs[i] + spr_initial_offs;
             _sprInfos[i].Width = rspritewidths[i];
             _sprInfos[i].Height = rspriteheights[i];
         }
@@ -963,21 +1400,49 @@ bool SpriteCache::LoadSpriteIndexFile(const char *filename, int expectedFileID,
     return true;
 }
 
+void SpriteCache::SetFileMapping(bool on)
+{
+    _useMapping = on;
+}
+
+void SpriteCache::OpenMapping(const char *filename)
+{
+    _mapping.reset();
+    if (!_useMapping || !FileMapping::IsSupported())
+        return;
+    AssetLocation loc;
+    if (!Common::AssetManager::GetAssetLocation(filename, loc))
+        return;
+    std::unique_ptr<FileMapping> mapping(new FileMapping());
+    if (!mapping->Open(loc.FileName, loc.Offset, loc.Size))
+    {
+        Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn, "Failed to map sprite file '%s' into memory, will read using file stream.", filename);
+        return;
+    }
+    _mapping = std::move(mapping);
+}
+
 void SpriteCache::DetachFile()
 {
+    StopPrefetch();
+    _mapping.reset();
     _stream.reset();
+    _filename = ""; // don't prefetch from the detached file
     _lastLoad = -2;
 }
 
 int SpriteCache::AttachFile(const char *filename)
 {
+    StopPrefetch();
     _stream.reset(Common::AssetManager::OpenAsset((char *)filename));
     if (_stream == nullptr)
         return -1;
+    _filename = filename;
+    OpenMapping(filename);
     return 0;
 }
 
 bool SpriteCache::IsFileCompressed() const
 {
-    return _compressed;
+    return _compression != kSprCompress_None;
 }
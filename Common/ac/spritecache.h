@@ -40,7 +40,7 @@
 #include "core/platform.h"
 #include "util/error.h"
 
-namespace AGS { namespace Common { class Stream; class Bitmap; } }
+namespace AGS { namespace Common { class Stream; class Bitmap; class FileMapping; } }
 using namespace AGS; // FIXME later
 typedef AGS::Common::HError HAGSError;
 
@@ -68,7 +68,17 @@ enum SpriteFileVersion
     kSprfVersion_Last32bit = 6,
     kSprfVersion_64bit = 10,
     kSprfVersion_HighSpriteLimit = 11,
-    kSprfVersion_Current = kSprfVersion_HighSpriteLimit
+    kSprfVersion_StorageFormats = 12,
+    kSprfVersion_Current = kSprfVersion_StorageFormats
+};
+
+// Sprite data compression method; since kSprfVersion_StorageFormats
+// it is stored for each sprite individually
+enum SpriteCompression
+{
+    kSprCompress_None = 0,
+    kSprCompress_RLE  = 1,
+    kSprCompress_LZ4  = 2
 };
 
 enum SpriteIndexFileVersion
@@ -83,6 +93,16 @@ enum SpriteIndexFileVersion
 
 typedef int32_t sprkey_t;
 
+// SpriteDataHeader describes sprite stored in the sprite file
+struct SpriteDataHeader
+{
+    int ColorDepth = 0; // bytes per pixel, 0 means there's no sprite
+    int Width = 0;
+    int Height = 0;
+    SpriteCompression Compression = kSprCompress_None;
+    size_t DataSize = 0; // size of the stored pixel data
+};
+
 // SpriteFileIndex contains sprite file's table of contents
 struct SpriteFileIndex
 {
@@ -129,6 +149,10 @@ public:
     sprkey_t    FindTopmostSprite() const;
     // Loads sprite and and locks in memory (so it cannot get removed implicitly)
     void        Precache(sprkey_t index);
+    // Schedules sprite for loading on a background thread; the loaded sprite
+    // is put into cache when it's requested, or during any other cache load.
+    // Does nothing if the sprite is already in memory or is not a game asset.
+    void        Prefetch(sprkey_t index);
     // Remap the given index to the sprite 0
     void        RemapSpriteToSprite0(sprkey_t index);
     // Unregisters sprite from the bank and optionally deletes bitmap
@@ -148,6 +172,9 @@ public:
     // Sets max cache size in bytes
     void        SetMaxCacheSize(size_t size);
 
+    // Sets whether to read sprites from the sprite file mapped into memory,
+    // when supported by the system; applies to the next opened sprite file
+    void        SetFileMapping(bool on);
     // Loads sprite reference information and inits sprite stream
     HAGSError   InitFile(const char *filename, const char *sprindex_filename);
     // Tells if bitmaps in the file are compressed
@@ -165,6 +192,31 @@ public:
     // Loads (if it's not in cache yet) and returns bitmap by the sprite index
     Common::Bitmap *operator[] (sprkey_t index);
 
+    // Reads the sprite header from the stream positioned at the sprite;
+    // returns false if the header is corrupt
+    static bool ReadSpriteHeader(Common::Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp,
+        SpriteDataHeader &hdr);
+    // Reads the sprite header from the memory buffer, advancing the data pointer;
+    // returns false if the header is corrupt or the buffer ends before it does
+    static bool ReadSpriteHeader(const uint8_t *&data, const uint8_t *data_end,
+        SpriteFileVersion vers, SpriteCompression file_cmp, SpriteDataHeader &hdr);
+    // Reads the sprite pixels which follow the header into the buffer of
+    // Height lines of the given pitch; returns false if the data is corrupt,
+    // incomplete, or stored in unknown format
+    static bool ReadSpritePixels(Common::Stream *in, const SpriteDataHeader &hdr, uint8_t *pixels, size_t pitch);
+    static bool ReadSpritePixels(const uint8_t *data, const uint8_t *data_end, const SpriteDataHeader &hdr,
+        uint8_t *pixels, size_t pitch);
+    // Writes the sprite in the current file format; the pixels are stored in
+    // little-endian order, LZ4 compressed if requested and if that makes them smaller
+    static void WriteSprite(Common::Stream *out, const uint8_t *pixels, size_t pitch,
+        int width, int height, int coldep, SpriteCompression cmp);
+    // Copies the sprite from the stream positioned at it into the output in the
+    // current file format, if it's stored compressed (with any method) when
+    // compressed output is requested, or raw when it is not. Otherwise returns
+    // false without writing anything, and the input is left past the header.
+    static bool CopySprite(Common::Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp,
+        Common::Stream *out, bool compressed, SpriteDataHeader &hdr);
+
 private:
     void        Init();
     // Gets the index of a sprite which data is used for the given slot;
@@ -174,19 +226,43 @@ private:
     size_t      LoadSprite(sprkey_t index);
     // Seek stream to sprite
     void        SeekToSprite(sprkey_t index);
+    // Tries to map the sprite file into memory, if this is enabled
+    void        OpenMapping(const char *filename);
+    // Assigns freshly loaded image to the sprite slot and lets engine initialize it;
+    // returns the size of the sprite in the cache
+    size_t      InitLoadedSprite(sprkey_t index, Common::Bitmap *image, int coldep);
+    // Dispose the oldest images until the cache size is within the limit
+    void        FreeMem();
+    // Gets the size of the prefetched sprites which were not put into cache yet
+    size_t      GetPrefetchedSize();
     // Delete the oldest image in cache
     void        DisposeOldest();
+    // Puts sprite into MRU list as the most recently used one
+    void        TouchSprite(sprkey_t index);
+    // Removes sprite from the MRU list, if it's there
+    void        UnlinkSprite(sprkey_t index);
+
+    // Sprite prefetching: background loading of the sprite images
+    struct PrefetchQueue;
+    // Waits for the sprite if it's being prefetched and puts it into the cache;
+    // also adopts all the other prefetched sprites. Returns if sprite was found.
+    bool        TakePrefetched(sprkey_t index);
+    // Stops background loading and deletes any sprites that were not taken yet
+    void        StopPrefetch();
+    // Background thread's loop
+    static void PrefetchThread(PrefetchQueue *queue);
 
     // Information required for the sprite streaming
     // TODO: split into sprite cache and sprite stream data
     struct SpriteData
     {
-        soff_t          Offset; // data offset
-        soff_t          Size;   // cache size of element, in bytes
-        uint32_t        Flags;
         // TODO: investigate if we may safely use unique_ptr here
         // (some of these bitmaps may be assigned from outside of the cache)
         Common::Bitmap *Image; // actual bitmap
+        size_t          Size;   // cache size of element, in bytes
+        uint32_t        Flags;
+        sprkey_t        MruPrev; // previous (older) sprite in the MRU list, or -1
+        sprkey_t        MruNext; // next (newer) sprite in the MRU list, or -1
 
         // Tells if there actually is a registered sprite in this slot
         bool DoesSpriteExist() const;
@@ -205,9 +281,17 @@ private:
     std::vector<SpriteInfo> &_sprInfos;
     // Array of sprite references
     std::vector<SpriteData> _spriteData;
-    bool _compressed;        // are sprites compressed
+    // Sprite data offsets in the file; these are only needed when loading,
+    // so kept apart from the data which is accessed whenever sprite is used
+    std::vector<soff_t> _spriteOffsets;
+    SpriteFileVersion _version;     // version of the opened sprite file
+    SpriteCompression _compression; // compression the sprite file was saved with
 
     std::unique_ptr<Common::Stream> _stream; // the sprite stream
+    Common::String _filename; // the sprite file name, for opening extra streams
+    bool _useMapping; // whether to try mapping sprite file into memory
+    std::unique_ptr<Common::FileMapping> _mapping; // the mapped sprite file
+    std::unique_ptr<PrefetchQueue> _prefetch; // background loading state
     sprkey_t _lastLoad; // last loaded sprite index
 
     size_t _maxCacheSize;  // cache size limit
@@ -216,20 +300,27 @@ private:
 
     // MRU list: the way to track which sprites were used recently.
     // When clearing up space for new sprites, cache first deletes the sprites
-    // that were last time used long ago.
-    std::vector<sprkey_t> _mrulist;
-    std::vector<sprkey_t> _mrubacklink;
-    int _liststart;
-    int _listend;
+    // that were last time used long ago. The list is linked through the
+    // sprite slots themselves (see SpriteData::MruPrev and MruNext).
+    sprkey_t _mruOldest;
+    sprkey_t _mruNewest;
 
     // Loads sprite index file
     bool        LoadSpriteIndexFile(const char *filename, int expectedFileID, soff_t spr_initial_offs, sprkey_t topmost);
     // Rebuilds sprite index from the main sprite file
     HAGSError   RebuildSpriteIndex(AGS::Common::Stream *in, sprkey_t topmost, SpriteFileVersion vers);
-    // Writes compressed sprite to the stream
-    void        CompressSprite(Common::Bitmap *sprite, Common::Stream *out);
-    // Uncompresses sprite from stream into the given bitmap
-    void        UnCompressSprite(Common::Bitmap *sprite, Common::Stream *in);
+    // Reads the sprite's compression type and data size, which follow
+    // sprite dimensions in the file of the given version
+    static SpriteCompression ReadSpriteFormat(Common::Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp,
+        int width, int height, int coldep, size_t &data_size);
+    // Reads sprite image from the stream positioned at the sprite's data;
+    // returns color depth, which is 0 if there's no sprite at this position;
+    // the image is null if it could not be read
+    static int  ReadSpriteImage(Common::Stream *in, SpriteFileVersion vers, SpriteCompression file_cmp, Common::Bitmap *&image);
+    // Reads sprite image from the mapped sprite file, at the given file offset;
+    // returns -1 if the mapped data ends before the sprite header does
+    static int  ReadSpriteImage(const Common::FileMapping &mapping, soff_t offset,
+        SpriteFileVersion vers, SpriteCompression file_cmp, Common::Bitmap *&image);
 
     // Initialize the empty sprite slot
     void        InitNullSpriteParams(sprkey_t index);
@@ -300,8 +300,10 @@ AssetError AssetManager::RegisterAssetLib(const String &data_file, const String
     if (mfl_err != MFLUtil::kMFLNoError)
     {
         _assetLib.Unload();
+        _assetIndex.clear();
         return kAssetErrLibParse;
     }
+    BuildAssetIndex();
 
     // fixup base library filename
     String nammwas = data_file;
@@ -327,16 +329,21 @@ AssetError AssetManager::RegisterAssetLib(const String &data_file, const String
     return kAssetNoError;
 }
 
-AssetInfo *AssetManager::FindAssetByFileName(const String &asset_name)
+void AssetManager::BuildAssetIndex()
 {
+    _assetIndex.clear();
+    _assetIndex.reserve(_assetLib.AssetInfos.size());
+    // if there are duplicate names, the first asset wins, same as with the linear search
     for (size_t i = 0; i < _assetLib.AssetInfos.size(); ++i)
-    {
-        if (_assetLib.AssetInfos[i].FileName.CompareNoCase(asset_name) == 0)
-        {
-            return &_assetLib.AssetInfos[i];
-        }
-    }
-    return nullptr;
+        _assetIndex.insert(std::make_pair(_assetLib.AssetInfos[i].FileName, i));
+}
+
+AssetInfo *AssetManager::FindAssetByFileName(const String &asset_name)
+{
+    AssetIndexMap::const_iterator it = _assetIndex.find(asset_name);
+    if (it == _assetIndex.end())
+        return nullptr;
+    return &_assetLib.AssetInfos[it->second];
 }
 
 String AssetManager::MakeLibraryFileNameForAsset(const AssetInfo *asset)
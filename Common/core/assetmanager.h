@@ -34,7 +34,9 @@
 #ifndef __AGS_CN_CORE__ASSETMANAGER_H
 #define __AGS_CN_CORE__ASSETMANAGER_H
 
+#include <unordered_map>
 #include "util/file.h" // TODO: extract filestream mode constants or introduce generic ones
+#include "util/string_types.h"
 
 namespace AGS
 {
@@ -127,6 +129,8 @@ private:
     soff_t      _GetLastAssetSize();
 
     AssetError  RegisterAssetLib(const String &data_file, const String &password);
+    // Builds a lookup table for finding assets by their file names
+    void        BuildAssetIndex();
 
     bool        _DoesAssetExist(const String &asset_name);
 
@@ -142,6 +146,9 @@ private:
     AssetSearchPriority     _searchPriority;
 
     AssetLibInfo            &_assetLib;
+    // case-insensitive asset name to the index in the library's asset list
+    typedef std::unordered_map<String, size_t, HashStrNoCase, StrEqNoCase> AssetIndexMap;
+    AssetIndexMap           _assetIndex;
     String                  _basePath;          // library's parent path (directory)
     soff_t                  _lastAssetSize;     // size of asset that was opened last time
 };
@@ -51,6 +51,14 @@ public:
   virtual bool IsBitmapFont() = 0;
   // Load font, applying extended font rendering parameters
   virtual bool LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params) = 0;
+  // Fills the table of advances of the single-byte characters, letting the
+  // caller measure text by adding them up; characters that cannot be measured
+  // this way get -1. Returns false if the font does not support this at all.
+  virtual bool GetCharAdvances(int fontNumber, int advances[256]) = 0;
+  // Tells if the text rendered with this font only replaces the destination
+  // pixels, without blending with them; such text may be rendered once and
+  // then copied to the screen as a masked image
+  virtual bool IsTextRenderOpaque(int fontNumber, int colorDepth) = 0;
 protected:
   IAGSFontRenderer2() = default;
   ~IAGSFontRenderer2() = default;
@@ -13,11 +13,13 @@
 //=============================================================================
 
 #include <cstdio>
+#include <memory>
 #include <vector>
 #include <alfont.h>
 #include "ac/common.h" // set_our_eip
 #include "ac/gamestructdefines.h"
 #include "font/fonts.h"
+#include "font/textruncache.h"
 #include "font/ttffontrenderer.h"
 #include "font/wfnfontrenderer.h"
 #include "gfx/bitmap.h"
@@ -38,6 +40,9 @@ struct Font
     IAGSFontRenderer   *Renderer;
     IAGSFontRenderer2  *Renderer2;
     FontInfo            Info;
+    // Advances of the single-byte characters, -1 for the ones which have to
+    // be measured by the renderer; empty if not supported by the renderer
+    std::vector<int>    CharAdvances;
 
     Font();
 };
@@ -54,6 +59,21 @@ static std::vector<Font> fonts;
 static TTFFontRenderer ttfRenderer;
 static WFNFontRenderer wfnRenderer;
 
+// Only the bitmap fonts are cached, as their glyphs never go out of the
+// measured text bounds, unlike the TrueType glyphs which may overhang
+// (italic or outlined ones); TrueType text is always rendered anew.
+static TextRunCache text_runs(DEFAULTTEXTCACHESIZE_KB * 1024);
+
+static void clear_text_runs()
+{
+    text_runs.Clear();
+}
+
+void set_text_cache_size(size_t size)
+{
+    text_runs.SetMaxSize(size);
+}
+
 
 FontInfo::FontInfo()
     : Flags(0)
@@ -103,9 +123,32 @@ IAGSFontRenderer* font_replace_renderer(size_t fontNumber, IAGSFontRenderer* ren
   IAGSFontRenderer* oldRender = fonts[fontNumber].Renderer;
   fonts[fontNumber].Renderer = renderer;
   fonts[fontNumber].Renderer2 = nullptr;
+  fonts[fontNumber].CharAdvances.clear();
+  clear_text_runs();
   return oldRender;
 }
 
+// Gets the table of character advances from the font's renderer
+static void init_char_advances(Font &font, size_t fontNumber)
+{
+  font.CharAdvances.clear();
+  if (!font.Renderer2)
+    return;
+  font.CharAdvances.resize(256);
+  if (!font.Renderer2->GetCharAdvances(fontNumber, &font.CharAdvances.front()))
+    font.CharAdvances.clear();
+}
+
+void font_set_renderer(size_t fontNumber, IAGSFontRenderer *renderer, IAGSFontRenderer2 *renderer2)
+{
+  if (fonts.size() <= fontNumber)
+    fonts.resize(fontNumber + 1);
+  fonts[fontNumber].Renderer = renderer;
+  fonts[fontNumber].Renderer2 = renderer2;
+  init_char_advances(fonts[fontNumber], fontNumber);
+  clear_text_runs();
+}
+
 bool is_bitmap_font(size_t fontNumber)
 {
     if (fontNumber >= fonts.size() || !fonts[fontNumber].Renderer2)
@@ -134,10 +177,30 @@ int get_font_scaling_mul(size_t fontNumber)
     return fonts[fontNumber].Info.SizeMultiplier;
 }
 
+// Measures the text by adding up the font's character advances;
+// returns -1 if the text contains characters which cannot be measured so
+static int get_text_width_by_advances(const Font &font, const char *text)
+{
+  if (font.CharAdvances.empty())
+    return -1;
+  int width = 0;
+  for (; *text; ++text)
+  {
+    const int advance = font.CharAdvances[(uint8_t)*text];
+    if (advance < 0)
+      return -1;
+    width += advance;
+  }
+  return width;
+}
+
 int wgettextwidth(const char *texx, size_t fontNumber)
 {
   if (fontNumber >= fonts.size() || !fonts[fontNumber].Renderer)
     return 0;
+  const int width = get_text_width_by_advances(fonts[fontNumber], texx);
+  if (width >= 0)
+    return width;
   return fonts[fontNumber].Renderer->GetTextWidth(texx, fontNumber);
 }
 
@@ -250,6 +313,19 @@ size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, siz
     unescape_script_string(todis, lines.LineBuf);
     char *theline = &lines.LineBuf.front();
 
+    // If the font has a table of character advances, then the line's width
+    // is accumulated as we go, instead of measuring it all again for every
+    // new character; the characters missing in the table are still measured
+    // along with the whole line.
+    const int *advances = nullptr;
+    int padding = 0;
+    if (fonnt >= 0 && (size_t)fonnt < fonts.size() && !fonts[fonnt].CharAdvances.empty())
+    {
+        advances = &fonts[fonnt].CharAdvances.front();
+        padding = wgettextwidth_compensate("", fonnt);
+    }
+    int line_width = 0; // width of the current line, up to the character i
+
     size_t i = 0;
     size_t splitAt;
     char nextCharWas;
@@ -264,28 +340,39 @@ size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, siz
             break;
         }
 
-        // temporarily terminate the line here and test its width
-        nextCharWas = theline[i + 1];
-        theline[i + 1] = 0;
-
         // force end of line with the \n character
         if (theline[i] == '\n')
             splitAt = i;
         // otherwise, see if we are too wide
-        else if (wgettextwidth_compensate(theline, fonnt) > wii) {
-            int endline = i;
-            while ((theline[endline] != ' ') && (endline > 0))
-                endline--;
+        else {
+            int width;
+            const int advance = advances ? advances[(uint8_t)theline[i]] : -1;
+            if (advance >= 0) {
+                line_width += advance;
+                width = line_width + padding;
+            }
+            else {
+                // temporarily terminate the line here and test its width
+                nextCharWas = theline[i + 1];
+                theline[i + 1] = 0;
+                width = wgettextwidth_compensate(theline, fonnt);
+                line_width = width - padding;
+                // restore the character that was there before
+                theline[i + 1] = nextCharWas;
+            }
 
-            // single very wide word, display as much as possible
-            if (endline == 0)
-                endline = i - 1;
+            if (width > wii) {
+                int endline = i;
+                while ((theline[endline] != ' ') && (endline > 0))
+                    endline--;
 
-            splitAt = endline;
-        }
+                // single very wide word, display as much as possible
+                if (endline == 0)
+                    endline = i - 1;
 
-        // restore the character that was there before
-        theline[i + 1] = nextCharWas;
+                splitAt = endline;
+            }
+        }
 
         if (splitAt != -1) {
             if (splitAt == 0 && !((theline[0] == ' ') || (theline[0] == '\n'))) {
@@ -308,6 +395,7 @@ size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, siz
             if ((theline[0] == ' ') || (theline[0] == '\n'))
                 theline++;
             i = -1;
+            line_width = 0;
         }
 
         i++;
@@ -323,10 +411,42 @@ void wouttextxy(Common::Bitmap *ds, int xxx, int yyy, size_t fontNumber, color_t
   if (yyy > ds->GetClip().Bottom)
     return;                   // each char is clipped but this speeds it up
 
-  if (fonts[fontNumber].Renderer != nullptr)
+  if (fonts[fontNumber].Renderer == nullptr)
+    return;
+
+  const int color_depth = ds->GetColorDepth();
+  if (text_runs.GetMaxSize() == 0 || !fonts[fontNumber].Renderer2 || texx[0] == 0 ||
+      text_color == ds->GetMaskColor() ||
+      !fonts[fontNumber].Renderer2->IsBitmapFont() ||
+      !fonts[fontNumber].Renderer2->IsTextRenderOpaque(fontNumber, color_depth))
   {
     fonts[fontNumber].Renderer->RenderText(texx, fontNumber, (BITMAP*)ds->GetAllegroBitmap(), xxx, yyy, text_color);
+    return;
+  }
+
+  const TextRunKey key(texx, fontNumber, text_color, color_depth);
+  Bitmap *image = text_runs.Get(key);
+  if (!image)
+  {
+    // Render the text on the transparent image of the text's size
+    const int width = wgettextwidth(texx, fontNumber);
+    const int height = wgettextheight(texx, fontNumber);
+    if (width <= 0 || height <= 0)
+      return; // nothing to draw
+    std::unique_ptr<Bitmap> new_image(BitmapHelper::CreateTransparentBitmap(width, height, color_depth));
+    const size_t size = new_image->GetDataSize();
+    if (size > text_runs.GetMaxSize())
+    {
+      fonts[fontNumber].Renderer->RenderText(texx, fontNumber, (BITMAP*)ds->GetAllegroBitmap(), xxx, yyy, text_color);
+      return;
+    }
+    fonts[fontNumber].Renderer->RenderText(texx, fontNumber, (BITMAP*)new_image->GetAllegroBitmap(),
+        0, 0, text_color);
+    image = new_image.get();
+    text_runs.Put(key, std::move(new_image), size);
   }
+
+  ds->Blit(image, 0, 0, xxx, yyy, image->GetWidth(), image->GetHeight(), kBitmap_Transparency);
 }
 
 void set_fontinfo(size_t fontNumber, const FontInfo &finfo)
@@ -359,6 +479,7 @@ bool wloadfont_size(size_t fontNumber, const FontInfo &font_info)
   if (fonts[fontNumber].Renderer)
   {
       fonts[fontNumber].Info = font_info;
+      init_char_advances(fonts[fontNumber], fontNumber);
       return true;
   }
   return false;
@@ -387,6 +508,8 @@ void wfreefont(size_t fontNumber)
     fonts[fontNumber].Renderer->FreeMemory(fontNumber);
 
   fonts[fontNumber].Renderer = nullptr;
+  fonts[fontNumber].CharAdvances.clear();
+  clear_text_runs();
 }
 
 void free_all_fonts()
@@ -397,4 +520,5 @@ void free_all_fonts()
             fonts[i].Renderer->FreeMemory(i);
     }
     fonts.clear();
+    clear_text_runs();
 }
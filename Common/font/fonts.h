@@ -33,6 +33,9 @@ void init_font_renderer();
 void shutdown_font_renderer();
 void adjust_y_coordinate_for_text(int* ypos, size_t fontnum);
 IAGSFontRenderer* font_replace_renderer(size_t fontNumber, IAGSFontRenderer* renderer);
+// Assigns the renderer to the font slot, creating the slot if necessary;
+// unlike font_replace_renderer, also uses the extended renderer interface
+void font_set_renderer(size_t fontNumber, IAGSFontRenderer *renderer, IAGSFontRenderer2 *renderer2);
 bool font_first_renderer_loaded();
 bool is_font_loaded(size_t fontNumber);
 bool is_bitmap_font(size_t fontNumber);
@@ -76,6 +79,10 @@ void wfreefont(size_t fontNumber);
 // Free all fonts data
 void free_all_fonts();
 
+#define DEFAULTTEXTCACHESIZE_KB 2048
+// Sets max size of the cache of rendered text lines, in bytes; 0 disables the cache
+void set_text_cache_size(size_t size);
+
 // SplitLines class represents a list of lines and is meant to reduce
 // subsequent memory (de)allocations if used often during game loops
 // and drawing. For that reason it is not equivalent to std::vector,
@@ -0,0 +1,96 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "font/textruncache.h"
+#include "gfx/bitmap.h"
+#include "util/string_types.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+size_t TextRunCache::KeyHash::operator()(const TextRunKey &key) const
+{
+    size_t hash = FNV::Hash(key.Text.GetCStr(), key.Text.GetLength());
+    hash = hash * 31 + key.Font;
+    hash = hash * 31 + key.Color;
+    return hash * 31 + key.ColorDepth;
+}
+
+TextRunCache::TextRunCache(size_t max_size)
+    : _size(0)
+    , _maxSize(max_size)
+{
+}
+
+TextRunCache::~TextRunCache() = default;
+
+void TextRunCache::SetMaxSize(size_t max_size)
+{
+    _maxSize = max_size;
+    FreeSpace(0);
+}
+
+Bitmap *TextRunCache::Get(const TextRunKey &key)
+{
+    auto found = _index.find(key);
+    if (found == _index.end())
+        return nullptr;
+    _runs.splice(_runs.begin(), _runs, found->second);
+    return _runs.front().Image.get();
+}
+
+bool TextRunCache::Put(const TextRunKey &key, std::unique_ptr<Bitmap> image, size_t size)
+{
+    if (size > _maxSize)
+        return false;
+    auto found = _index.find(key);
+    if (found != _index.end())
+    {
+        _size -= found->second->Size;
+        _runs.erase(found->second);
+        _index.erase(found);
+    }
+    FreeSpace(size);
+    TextRun run;
+    run.Key = key;
+    run.Image = std::move(image);
+    run.Size = size;
+    _runs.push_front(std::move(run));
+    _index[key] = _runs.begin();
+    _size += size;
+    return true;
+}
+
+void TextRunCache::Clear()
+{
+    _runs.clear();
+    _index.clear();
+    _size = 0;
+}
+
+void TextRunCache::FreeSpace(size_t size)
+{
+    while (!_runs.empty() && _size + size > _maxSize)
+    {
+        auto it = std::prev(_runs.end());
+        _index.erase(it->Key);
+        _size -= it->Size;
+        _runs.erase(it);
+    }
+}
+
+} // namespace Common
+} // namespace AGS
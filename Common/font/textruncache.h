@@ -0,0 +1,107 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Cache of the rendered lines of text.
+//
+// Lets draw the text that is redrawn often (labels, overlays) as a masked
+// image, not character by character. The image is found by the text, font,
+// color and color depth; the least recently used images are removed first
+// when the cache grows over its size limit.
+//
+//=============================================================================
+#ifndef __AGS_CN_FONT__TEXTRUNCACHE_H
+#define __AGS_CN_FONT__TEXTRUNCACHE_H
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "core/types.h"
+#include "util/string.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class Bitmap;
+
+struct TextRunKey
+{
+    String  Text;
+    size_t  Font;
+    color_t Color;
+    int     ColorDepth;
+
+    TextRunKey() : Font(0), Color(0), ColorDepth(0) {}
+    TextRunKey(const String &text, size_t font, color_t color, int color_depth)
+        : Text(text), Font(font), Color(color), ColorDepth(color_depth) {}
+
+    bool operator ==(const TextRunKey &other) const
+    {
+        return Font == other.Font && Color == other.Color &&
+            ColorDepth == other.ColorDepth && Text == other.Text;
+    }
+};
+
+class TextRunCache
+{
+public:
+    TextRunCache(size_t max_size);
+    ~TextRunCache();
+
+    // Sets the max size of the cached images, in bytes, removing the images
+    // which do not fit anymore
+    void    SetMaxSize(size_t max_size);
+    size_t  GetMaxSize() const { return _maxSize; }
+    // Gets the total size of the cached images, in bytes
+    size_t  GetSize() const { return _size; }
+    size_t  GetCount() const { return _runs.size(); }
+
+    // Finds the image of the text, making it the most recently used one;
+    // returns null if there's no such image
+    Bitmap *Get(const TextRunKey &key);
+    // Puts the image of the text, which takes the given amount of memory,
+    // removing the least recently used images to make room for it; fails if
+    // the image is larger than the whole cache, the image is deleted then
+    bool    Put(const TextRunKey &key, std::unique_ptr<Bitmap> image, size_t size);
+    // Removes all the images
+    void    Clear();
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const TextRunKey &key) const;
+    };
+
+    struct TextRun
+    {
+        TextRunKey              Key;
+        std::unique_ptr<Bitmap> Image;
+        size_t                  Size;
+    };
+
+    typedef std::list<TextRun> TextRunList;
+
+    void FreeSpace(size_t size);
+
+    TextRunList _runs; // from the most to the least recently used
+    std::unordered_map<TextRunKey, TextRunList::iterator, KeyHash> _index;
+    size_t      _size;
+    size_t      _maxSize;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_FONT__TEXTRUNCACHE_H
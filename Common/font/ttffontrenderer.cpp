@@ -87,6 +87,26 @@ bool TTFFontRenderer::IsBitmapFont()
     return false;
 }
 
+bool TTFFontRenderer::GetCharAdvances(int fontNumber, int advances[256])
+{
+  // alfont adds up advances of the characters, but may decode the bytes
+  // above 127 as parts of multi-byte characters, so only ASCII is measured
+  char text[2] = { 0, 0 };
+  advances[0] = 0;
+  for (int c = 1; c < 256; ++c)
+  {
+    text[0] = (char)c;
+    advances[c] = c < 128 ? alfont_text_length(_fontData[fontNumber].AlFont, text) : -1;
+  }
+  return true;
+}
+
+bool TTFFontRenderer::IsTextRenderOpaque(int fontNumber, int colorDepth)
+{
+  // anti-aliased text is blended with the destination
+  return !(ShouldAntiAliasText() && colorDepth > 8);
+}
+
 bool TTFFontRenderer::LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params)
 {
   String file_name = String::FromFormat("agsfnt%d.ttf", fontNumber);
@@ -35,6 +35,8 @@ public:
   // IAGSFontRenderer2 implementation
   bool IsBitmapFont() override;
   bool LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params) override;
+  bool GetCharAdvances(int fontNumber, int advances[256]) override;
+  bool IsTextRenderOpaque(int fontNumber, int colorDepth) override;
 
 private:
     struct FontData
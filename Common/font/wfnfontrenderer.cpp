@@ -136,6 +136,21 @@ bool WFNFontRenderer::IsBitmapFont()
     return true;
 }
 
+bool WFNFontRenderer::GetCharAdvances(int fontNumber, int advances[256])
+{
+  const WFNFont* font = _fontData[fontNumber].Font;
+  const FontRenderParams &params = _fontData[fontNumber].Params;
+  advances[0] = 0;
+  for (int c = 1; c < 256; ++c)
+    advances[c] = font->GetChar(GetCharCode(c, font)).Width * params.SizeMultiplier;
+  return true;
+}
+
+bool WFNFontRenderer::IsTextRenderOpaque(int fontNumber, int colorDepth)
+{
+  return true;
+}
+
 bool WFNFontRenderer::LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params)
 {
   String file_name;
@@ -33,6 +33,8 @@ public:
 
   bool IsBitmapFont() override;
   bool LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params) override;
+  bool GetCharAdvances(int fontNumber, int advances[256]) override;
+  bool IsTextRenderOpaque(int fontNumber, int colorDepth) override;
 
 private:
   struct FontData
@@ -180,6 +180,8 @@ enum GuiSvgVersion
 } // namespace Common
 } // namespace AGS
 
+// Tells that all the GUIs have to be redrawn; when only particular GUI or
+// control changes, mark that GUI instead (see GUIMain::MarkChanged)
 extern int guis_need_update;
 
 #endif // __AC_GUIDEFINES_H
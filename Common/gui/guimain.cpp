@@ -76,6 +76,7 @@ void GUIMain::InitDefaults()
     _controls.clear();
     _ctrlRefs.clear();
     _ctrlDrawOrder.clear();
+    _hasChanged = true;
 }
 
 int GUIMain::FindControlUnderMouse(int leeway, bool must_be_clickable) const
@@ -168,6 +169,21 @@ bool GUIMain::IsVisible() const
     return (_flags & kGUIMain_Visible) != 0;
 }
 
+bool GUIMain::HasChanged() const
+{
+    return _hasChanged;
+}
+
+void GUIMain::MarkChanged()
+{
+    _hasChanged = true;
+}
+
+void GUIMain::ClearChanged()
+{
+    _hasChanged = false;
+}
+
 void GUIMain::AddControl(GUIControlType type, int id, GUIObject *control)
 {
     _ctrlRefs.push_back(std::make_pair(type, id));
@@ -311,7 +327,7 @@ void GUIMain::Poll()
                     _controls[MouseOverCtrl]->OnMouseMove(mousex, mousey);
                 }
             }
-            guis_need_update = 1;
+            MarkChanged();
         } 
         else if (MouseOverCtrl >= 0)
             _controls[MouseOverCtrl]->OnMouseMove(mousex, mousey);
@@ -439,7 +455,7 @@ void GUIMain::SetTextWindow(bool on)
 void GUIMain::SetTransparencyAsPercentage(int percent)
 {
     Transparency = GfxDef::Trans100ToLegacyTrans255(percent);
-    guis_need_update = 1;
+    MarkChanged();
 }
 
 void GUIMain::SetVisible(bool on)
@@ -471,7 +487,7 @@ void GUIMain::OnMouseButtonDown()
     if (_controls[MouseOverCtrl]->OnMouseDown())
         MouseOverCtrl = MOVER_MOUSEDOWNLOCKED;
     _controls[MouseDownCtrl]->OnMouseMove(mousex - X, mousey - Y);
-    guis_need_update = 1;
+    MarkChanged();
 }
 
 void GUIMain::OnMouseButtonUp()
@@ -489,7 +505,7 @@ void GUIMain::OnMouseButtonUp()
 
     _controls[MouseDownCtrl]->OnMouseUp();
     MouseDownCtrl = -1;
-    guis_need_update = 1;
+    MarkChanged();
 }
 
 void GUIMain::ReadFromFile(Stream *in, GuiVersion gui_version)
@@ -63,6 +63,8 @@ public:
 
     // Tells if the gui background supports alpha channel
     bool        HasAlphaChannel() const;
+    // Tells if GUI's image has to be redrawn
+    bool        HasChanged() const;
     // Tells if GUI will react on clicking on it
     bool        IsClickable() const;
     // Tells if GUI's visibility is overridden and it won't be displayed on
@@ -98,6 +100,10 @@ public:
     // Gets child control's global ID, looks up with child's index
     int32_t GetControlID(int index) const;
 
+    // Marks GUI's image as requiring redraw, or as being up to date
+    void    MarkChanged();
+    void    ClearChanged();
+
     // Child control management
     // Note that currently GUIMain does not own controls (should not delete them)
     void    AddControl(GUIControlType type, int id, GUIObject *control);
@@ -170,6 +176,7 @@ public:
 
 private:
     int32_t _flags;          // style and behavior flags
+    bool    _hasChanged;     // the image has to be redrawn
 
     // Array of types and control indexes in global GUI object arrays;
     // maps GUI child slots to actual controls and used for rebuilding Controls array
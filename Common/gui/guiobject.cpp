@@ -112,6 +112,12 @@ void GUIObject::SetVisible(bool on)
         Flags &= ~kGUICtrl_Visible;
 }
 
+void GUIObject::NotifyParentChanged()
+{
+    if (ParentId >= 0 && (size_t)ParentId < guis.size())
+        guis[ParentId].MarkChanged();
+}
+
 // TODO: replace string serialization with StrUtil::ReadString and WriteString
 // methods in the future, to keep this organized.
 void GUIObject::WriteToFile(Stream *out) const
@@ -65,6 +65,8 @@ public:
     void            SetEnabled(bool on);
     void            SetTranslated(bool on);
     void            SetVisible(bool on);
+    // Notifies the parent GUI that this control has changed and must be redrawn
+    void            NotifyParentChanged();
 
     // Events
     // Key pressed for control
@@ -62,7 +62,7 @@ void GUITextBox::Draw(Bitmap *ds)
 
 void GUITextBox::OnKeyPress(int keycode)
 {
-    guis_need_update = 1;
+    NotifyParentChanged();
     // TODO: use keycode constants
     // backspace, remove character
     if (keycode == 8)
@@ -88,6 +88,7 @@ ccScript::ccScript()
     sectionOffsets      = nullptr;
     numSections         = 0;
     capacitySections    = 0;
+    hasFusedCmds        = false;
 }
 
 ccScript::ccScript(const ccScript &src)
@@ -190,6 +191,7 @@ ccScript::ccScript(const ccScript &src)
     }
 
     instances = 0;
+    hasFusedCmds = src.hasFusedCmds;
 }
 
 ccScript::~ccScript()
@@ -200,7 +202,9 @@ ccScript::~ccScript()
 void ccScript::Write(Stream *out) {
     int n;
     out->Write(scfilesig,4);
-    out->WriteInt32(SCOM_VERSION);
+    // only mark the script with the new version if it requires one,
+    // so that it may be still run by the older engines otherwise
+    out->WriteInt32(hasFusedCmds ? SCOM_VERSION_FUSEDCMDS : SCOM_VERSION_BASIC);
     out->WriteInt32(globaldatasize);
     out->WriteInt32(codesize);
     out->WriteInt32(stringssize);
@@ -248,6 +252,7 @@ bool ccScript::Read(Stream *in)
     return false;
   }
 
+  hasFusedCmds = fileVer >= SCOM_VERSION_FUSEDCMDS;
   globaldatasize = in->ReadInt32();
   codesize = in->ReadInt32();
   stringssize = in->ReadInt32();
@@ -51,6 +51,8 @@ public:
     int32_t *sectionOffsets;
     int numSections;
     int capacitySections;
+    // the code contains fused commands, and requires newer format version
+    bool hasFusedCmds;
 
     static ccScript *CreateFromStream(Common::Stream *in);
 
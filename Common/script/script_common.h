@@ -19,8 +19,11 @@
 #ifndef __CS_COMMON_H
 #define __CS_COMMON_H
 
-#define SCOM_VERSION 90
-#define SCOM_VERSIONSTR "0.90"
+#define SCOM_VERSION 91
+#define SCOM_VERSIONSTR "0.91"
+// Script format versions
+#define SCOM_VERSION_BASIC      90  // last version without fused commands
+#define SCOM_VERSION_FUSEDCMDS  91  // code may contain fused commands
 
 // virtual CPU registers
 #define SREG_SP           1     // stack pointer
@@ -106,8 +109,12 @@
 #define SCMD_DYNAMICBOUNDS 71   // check reg1 is between 0 and m[MAR-4]
 #define SCMD_NEWARRAY     72    // reg1 = new array of reg1 elements, each of size arg2 (arg3=managed type?)
 #define SCMD_NEWUSEROBJECT 73   // reg1 = new user object of arg1 size
+// fused commands, produced by the optional compiler optimization
+#define SCMD_LITADDREG    74    // reg1 = arg2; reg3 += reg1
+#define SCMD_MEMREADSPOFFS 75   // MAR = SP - arg1; reg2 = m[MAR]
+#define SCMD_MEMWRITESPOFFS 76  // MAR = SP - arg1; m[MAR] = reg2
 
-#define CC_NUM_SCCMDS     74
+#define CC_NUM_SCCMDS     77
 #define MAX_SCMD_ARGS     3     // maximal possible number of arguments
 
 #define EXPORT_FUNCTION   1
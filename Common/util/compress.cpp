@@ -18,6 +18,7 @@
 #endif
 
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include "ac/common.h"	// quit, update_polled_stuff
 #include "gfx/bitmap.h"
@@ -25,9 +26,7 @@
 #include "util/lzw.h"
 #include "util/misc.h"
 #include "util/stream.h"
-#if AGS_PLATFORM_ENDIAN_BIG
 #include "util/bbop.h"
-#endif
 
 using namespace AGS::Common;
 
@@ -284,6 +283,196 @@ int cunpackbitl32(uint32_t *line, int size, Stream *in)
   return in->HasErrors() ? -1 : 0;
 }
 
+// Helper template for unpacking RLE data from the memory buffer
+template <typename T, typename TRead>
+static const uint8_t *cunpackbitl_mem(T *line, int size, const uint8_t *data, const uint8_t *data_end, TRead read_elem)
+{
+  int n = 0;                    // number of elements decoded
+
+  while (n < size) {
+    if (data >= data_end)
+      return nullptr;
+    int8_t cx = (int8_t)*(data++); // get index byte
+    if (cx == -128)
+      cx = 0;
+
+    if (cx < 0) {                //.............run
+      int i = 1 - cx;
+      if (data + sizeof(T) > data_end || n + i > size)
+        return nullptr;
+      T ch = read_elem(data);
+      data += sizeof(T);
+      while (i--)
+        line[n++] = ch;
+    } else {                     //.....................seq
+      int i = cx + 1;
+      if (data + sizeof(T) * i > data_end || n + i > size)
+        return nullptr;
+      while (i--) {
+        line[n++] = read_elem(data);
+        data += sizeof(T);
+      }
+    }
+  }
+  return data;
+}
+
+const uint8_t *cunpackbitl(uint8_t *line, int size, const uint8_t *data, const uint8_t *data_end)
+{
+  return cunpackbitl_mem(line, size, data, data_end,
+    [](const uint8_t *p) { return *p; });
+}
+
+const uint8_t *cunpackbitl16(uint16_t *line, int size, const uint8_t *data, const uint8_t *data_end)
+{
+  return cunpackbitl_mem(line, size, data, data_end,
+    [](const uint8_t *p) { int16_t v; memcpy(&v, p, sizeof(v)); return (uint16_t)BBOp::Int16FromLE(v); });
+}
+
+const uint8_t *cunpackbitl32(uint32_t *line, int size, const uint8_t *data, const uint8_t *data_end)
+{
+  return cunpackbitl_mem(line, size, data, data_end,
+    [](const uint8_t *p) { int32_t v; memcpy(&v, p, sizeof(v)); return (uint32_t)BBOp::Int32FromLE(v); });
+}
+
+//=============================================================================
+// LZ4 block format compression
+//=============================================================================
+
+#define LZ4_MINMATCH     4
+#define LZ4_LASTLITERALS 5  // last bytes of the block are always literals
+#define LZ4_MFLIMIT      12 // last match must start before this distance from the end
+#define LZ4_MAXOFFSET    65535
+#define LZ4_HASHBITS     14
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t lz4_hash(uint32_t seq)
+{
+  return (seq * 2654435761U) >> (32 - LZ4_HASHBITS);
+}
+
+// Writes the length remainder as a sequence of 255-terminated bytes
+static void lz4_write_length(size_t len, std::vector<uint8_t> &out)
+{
+  for (; len >= 255; len -= 255)
+    out.push_back(255);
+  out.push_back((uint8_t)len);
+}
+
+static void lz4_write_sequence(const uint8_t *lit, size_t lit_len, size_t offset, size_t match_len, std::vector<uint8_t> &out)
+{
+  const size_t ml = match_len - LZ4_MINMATCH;
+  out.push_back((uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15)));
+  if (lit_len >= 15)
+    lz4_write_length(lit_len - 15, out);
+  out.insert(out.end(), lit, lit + lit_len);
+  out.push_back((uint8_t)(offset & 0xFF));
+  out.push_back((uint8_t)(offset >> 8));
+  if (ml >= 15)
+    lz4_write_length(ml - 15, out);
+}
+
+void lz4_compress(const uint8_t *data, size_t size, std::vector<uint8_t> &out)
+{
+  out.clear();
+  out.reserve(size + size / 255 + 16);
+  size_t anchor = 0;
+  if (size > LZ4_MFLIMIT) {
+    std::vector<int32_t> table(1 << LZ4_HASHBITS, -1);
+    const size_t match_limit = size - LZ4_MFLIMIT;
+    const size_t match_end = size - LZ4_LASTLITERALS;
+    size_t ip = 0;
+    while (ip < match_limit) {
+      const uint32_t seq = lz4_read32(data + ip);
+      const uint32_t h = lz4_hash(seq);
+      const int32_t ref = table[h];
+      table[h] = (int32_t)ip;
+      if (ref < 0 || ip - ref > LZ4_MAXOFFSET || lz4_read32(data + ref) != seq) {
+        ip++;
+        continue;
+      }
+      size_t len = LZ4_MINMATCH;
+      while (ip + len < match_end && data[ref + len] == data[ip + len])
+        len++;
+      lz4_write_sequence(data + anchor, ip - anchor, ip - ref, len, out);
+      ip += len;
+      anchor = ip;
+    }
+  }
+  // last literals
+  const size_t lit_len = size - anchor;
+  out.push_back((uint8_t)((lit_len < 15 ? lit_len : 15) << 4));
+  if (lit_len >= 15)
+    lz4_write_length(lit_len - 15, out);
+  out.insert(out.end(), data + anchor, data + size);
+}
+
+// Reads the length remainder; returns false if ran out of data
+static inline bool lz4_read_length(const uint8_t *&ip, const uint8_t *ip_end, size_t &len)
+{
+  uint8_t b;
+  do {
+    if (ip >= ip_end)
+      return false;
+    b = *(ip++);
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+bool lz4_decompress(const uint8_t *data, size_t size, uint8_t *out, size_t out_size)
+{
+  const uint8_t *ip = data;
+  const uint8_t *ip_end = data + size;
+  uint8_t *op = out;
+  uint8_t *op_end = out + out_size;
+  for (;;) {
+    if (ip >= ip_end)
+      return false;
+    const uint8_t token = *(ip++);
+    // literals
+    size_t lit_len = token >> 4;
+    if (lit_len == 15 && !lz4_read_length(ip, ip_end, lit_len))
+      return false;
+    if ((size_t)(ip_end - ip) < lit_len || (size_t)(op_end - op) < lit_len)
+      return false;
+    memcpy(op, ip, lit_len);
+    ip += lit_len;
+    op += lit_len;
+    if (ip == ip_end)
+      break; // last sequence has no match part
+    // match
+    if (ip_end - ip < 2)
+      return false;
+    const size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - out))
+      return false;
+    size_t match_len = token & 0xF;
+    if (match_len == 15 && !lz4_read_length(ip, ip_end, match_len))
+      return false;
+    match_len += LZ4_MINMATCH;
+    if ((size_t)(op_end - op) < match_len)
+      return false;
+    const uint8_t *match = op - offset;
+    if (offset >= match_len) {
+      memcpy(op, match, match_len);
+      op += match_len;
+    } else {
+      // overlapping copy, repeats the pattern
+      while (match_len--)
+        *(op++) = *(match++);
+    }
+  }
+  return op == op_end;
+}
+
 //=============================================================================
 
 const char *lztempfnm = "~aclzw.tmp";
@@ -15,6 +15,7 @@
 #ifndef __AC_COMPRESS_H
 #define __AC_COMPRESS_H
 
+#include <vector>
 #include "util/wgt2allg.h" // color (allegro RGB)
 
 namespace AGS { namespace Common { class Stream; class Bitmap; } }
@@ -29,6 +30,16 @@ void cpackbitl32(const uint32_t *line, int size, Common::Stream *out);
 int  cunpackbitl(uint8_t *line, int size, Common::Stream *in);
 int  cunpackbitl16(uint16_t *line, int size, Common::Stream *in);
 int  cunpackbitl32(uint32_t *line, int size, Common::Stream *in);
+// RLE decompression from the memory buffer; returns pointer to the end of
+// the unpacked data, or null if the data is corrupt
+const uint8_t *cunpackbitl(uint8_t *line, int size, const uint8_t *data, const uint8_t *data_end);
+const uint8_t *cunpackbitl16(uint16_t *line, int size, const uint8_t *data, const uint8_t *data_end);
+const uint8_t *cunpackbitl32(uint32_t *line, int size, const uint8_t *data, const uint8_t *data_end);
+// LZ4 block format compression: writes compressed data into the vector
+void lz4_compress(const uint8_t *data, size_t size, std::vector<uint8_t> &out);
+// LZ4 block format decompression; returns false if the data is corrupt
+// or does not unpack into exactly out_size bytes
+bool lz4_decompress(const uint8_t *data, size_t size, uint8_t *out, size_t out_size);
 
 //=============================================================================
 
@@ -0,0 +1,171 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+#include "util/filemapping.h"
+#include "core/platform.h"
+
+#if AGS_PLATFORM_OS_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif AGS_PLATFORM_OS_LINUX || AGS_PLATFORM_OS_MACOS || AGS_PLATFORM_OS_ANDROID || AGS_PLATFORM_OS_IOS
+#define AGS_HAS_MMAP (1)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+FileMapping::FileMapping()
+    : _data(nullptr)
+    , _offset(0)
+    , _size(0)
+    , _mapBase(nullptr)
+    , _mapSize(0)
+#if AGS_PLATFORM_OS_WINDOWS
+    , _hFile(INVALID_HANDLE_VALUE)
+    , _hMapping(nullptr)
+#endif
+{
+}
+
+FileMapping::~FileMapping()
+{
+    Close();
+}
+
+/* static */ bool FileMapping::IsSupported()
+{
+#if AGS_PLATFORM_OS_WINDOWS || defined(AGS_HAS_MMAP)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if AGS_PLATFORM_OS_WINDOWS
+
+bool FileMapping::Open(const String &file_name, soff_t offset, soff_t size)
+{
+    Close();
+    if (offset < 0 || size <= 0 || (uint64_t)size > SIZE_MAX)
+        return false;
+
+    HANDLE hfile = CreateFileA(file_name.GetCStr(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hfile == INVALID_HANDLE_VALUE)
+        return false;
+    HANDLE hmap = CreateFileMappingA(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hmap)
+    {
+        CloseHandle(hfile);
+        return false;
+    }
+
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    const soff_t map_offset = offset - (offset % si.dwAllocationGranularity);
+    const size_t map_size = (size_t)(size + (offset - map_offset));
+    void *base = MapViewOfFile(hmap, FILE_MAP_READ,
+        (DWORD)((uint64_t)map_offset >> 32), (DWORD)((uint64_t)map_offset & 0xFFFFFFFF), map_size);
+    if (!base)
+    {
+        CloseHandle(hmap);
+        CloseHandle(hfile);
+        return false;
+    }
+
+    _hFile = hfile;
+    _hMapping = hmap;
+    _mapBase = base;
+    _mapSize = map_size;
+    _data = static_cast<const uint8_t*>(base) + (offset - map_offset);
+    _offset = offset;
+    _size = (size_t)size;
+    return true;
+}
+
+void FileMapping::Close()
+{
+    if (_mapBase)
+        UnmapViewOfFile(_mapBase);
+    if (_hMapping)
+        CloseHandle(_hMapping);
+    if (_hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(_hFile);
+    _hFile = INVALID_HANDLE_VALUE;
+    _hMapping = nullptr;
+    _mapBase = nullptr;
+    _mapSize = 0;
+    _data = nullptr;
+    _offset = 0;
+    _size = 0;
+}
+
+#elif defined(AGS_HAS_MMAP)
+
+bool FileMapping::Open(const String &file_name, soff_t offset, soff_t size)
+{
+    Close();
+    if (offset < 0 || size <= 0 || (uint64_t)size > SIZE_MAX)
+        return false;
+
+    int fd = open(file_name.GetCStr(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const soff_t map_offset = offset - (offset % page_size);
+    const size_t map_size = (size_t)(size + (offset - map_offset));
+    void *base = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, (off_t)map_offset);
+    close(fd); // mapping keeps its own reference to the file
+    if (base == MAP_FAILED)
+        return false;
+
+    _mapBase = base;
+    _mapSize = map_size;
+    _data = static_cast<const uint8_t*>(base) + (offset - map_offset);
+    _offset = offset;
+    _size = (size_t)size;
+    return true;
+}
+
+void FileMapping::Close()
+{
+    if (_mapBase)
+        munmap(_mapBase, _mapSize);
+    _mapBase = nullptr;
+    _mapSize = 0;
+    _data = nullptr;
+    _offset = 0;
+    _size = 0;
+}
+
+#else
+
+bool FileMapping::Open(const String &/*file_name*/, soff_t /*offset*/, soff_t /*size*/)
+{
+    return false;
+}
+
+void FileMapping::Close()
+{
+}
+
+#endif
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,75 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// FileMapping maps a region of file into memory for reading.
+//
+// This lets read large data files in random order without seek and read
+// calls and intermediate buffers. Mapped memory is read-only, and may be
+// read from several threads at once.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__FILEMAPPING_H
+#define __AGS_CN_UTIL__FILEMAPPING_H
+
+#include "core/platform.h"
+#include "core/types.h"
+#include "util/string.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class FileMapping
+{
+public:
+    FileMapping();
+    ~FileMapping();
+
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    // Tells if file mapping is supported on this platform
+    static bool IsSupported();
+
+    // Maps the part of file into memory, beginning at the given offset;
+    // returns false if the file could not be opened or mapped
+    bool    Open(const String &file_name, soff_t offset, soff_t size);
+    // Unmaps the file
+    void    Close();
+
+    bool    IsOpen() const { return _data != nullptr; }
+    // Returns the beginning of the mapped region (the requested offset in file)
+    const uint8_t *GetData() const { return _data; }
+    // Returns offset in file at which the mapped region begins
+    soff_t  GetOffset() const { return _offset; }
+    // Returns size of the mapped region, in bytes
+    size_t  GetSize() const { return _size; }
+
+private:
+    const uint8_t *_data;   // requested data start
+    soff_t  _offset;        // requested offset in file
+    size_t  _size;          // requested size
+    void   *_mapBase;       // actual mapping start, aligned by system granularity
+    size_t  _mapSize;       // actual mapping size
+#if AGS_PLATFORM_OS_WINDOWS
+    void   *_hFile;
+    void   *_hMapping;
+#endif
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__FILEMAPPING_H
@@ -0,0 +1,158 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "util/memorystream.h"
+#include <algorithm>
+#include <string.h>
+
+namespace AGS
+{
+namespace Common
+{
+
+MemoryStream::MemoryStream(DataEndianess stream_endianess)
+    : DataStream(stream_endianess)
+    , _pos(0)
+    , _workMode(kFile_ReadWrite)
+    , _closed(false)
+{
+}
+
+MemoryStream::MemoryStream(std::vector<uint8_t> &&buf, FileWorkMode work_mode, DataEndianess stream_endianess)
+    : DataStream(stream_endianess)
+    , _buf(std::move(buf))
+    , _pos(0)
+    , _workMode(work_mode)
+    , _closed(false)
+{
+}
+
+MemoryStream::~MemoryStream()
+{
+}
+
+void MemoryStream::ReleaseBuffer(std::vector<uint8_t> &buf)
+{
+    buf = std::move(_buf);
+    _buf.clear();
+    _pos = 0;
+}
+
+void MemoryStream::Close()
+{
+    _closed = true;
+}
+
+bool MemoryStream::Flush()
+{
+    return true;
+}
+
+bool MemoryStream::IsValid() const
+{
+    return !_closed;
+}
+
+bool MemoryStream::EOS() const
+{
+    return _pos >= _buf.size();
+}
+
+soff_t MemoryStream::GetLength() const
+{
+    return _buf.size();
+}
+
+soff_t MemoryStream::GetPosition() const
+{
+    return _pos;
+}
+
+bool MemoryStream::CanRead() const
+{
+    return !_closed && _workMode != kFile_Write;
+}
+
+bool MemoryStream::CanWrite() const
+{
+    return !_closed && _workMode != kFile_Read;
+}
+
+bool MemoryStream::CanSeek() const
+{
+    return !_closed;
+}
+
+size_t MemoryStream::Read(void *buffer, size_t size)
+{
+    if (!CanRead() || !buffer || _pos >= _buf.size())
+        return 0;
+    size = std::min(size, _buf.size() - _pos);
+    memcpy(buffer, &_buf[_pos], size);
+    _pos += size;
+    return size;
+}
+
+int32_t MemoryStream::ReadByte()
+{
+    if (!CanRead() || _pos >= _buf.size())
+        return -1;
+    return _buf[_pos++];
+}
+
+size_t MemoryStream::Write(const void *buffer, size_t size)
+{
+    if (!CanWrite() || !buffer || size == 0)
+        return 0;
+    if (_buf.size() < _pos + size)
+        _buf.resize(_pos + size);
+    memcpy(&_buf[_pos], buffer, size);
+    _pos += size;
+    return size;
+}
+
+int32_t MemoryStream::WriteByte(uint8_t b)
+{
+    if (!CanWrite())
+        return -1;
+    if (_pos == _buf.size())
+        _buf.push_back(b);
+    else
+        _buf[_pos] = b;
+    _pos++;
+    return b;
+}
+
+bool MemoryStream::Seek(soff_t offset, StreamSeek origin)
+{
+    if (!CanSeek())
+        return false;
+    soff_t pos;
+    switch (origin)
+    {
+    case kSeekBegin:    pos = offset; break;
+    case kSeekCurrent:  pos = _pos + offset; break;
+    case kSeekEnd:      pos = _buf.size() + offset; break;
+    default:
+        return false;
+    }
+    // Allow to seek only within the existing data
+    if (pos < 0 || pos > (soff_t)_buf.size())
+        return false;
+    _pos = (size_t)pos;
+    return true;
+}
+
+} // namespace Common
+} // namespace AGS
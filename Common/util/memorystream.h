@@ -0,0 +1,79 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Stream working with the data buffer in memory.
+//
+// MemoryStream owns a growing byte vector: when writing, the buffer is
+// extended as needed, and may be taken out by the user afterwards; when
+// reading, the stream may be constructed over a ready buffer. The stream
+// supports seeking within the buffer in any mode.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__MEMORYSTREAM_H
+#define __AGS_CN_UTIL__MEMORYSTREAM_H
+
+#include <vector>
+#include "util/datastream.h"
+#include "util/file.h" // TODO: extract filestream mode constants
+
+namespace AGS
+{
+namespace Common
+{
+
+class MemoryStream : public DataStream
+{
+public:
+    // Creates an empty stream for writing and reading
+    MemoryStream(DataEndianess stream_endianess = kLittleEndian);
+    // Creates a stream over the given data; the buffer is moved into
+    // the stream
+    MemoryStream(std::vector<uint8_t> &&buf, FileWorkMode work_mode,
+        DataEndianess stream_endianess = kLittleEndian);
+    ~MemoryStream() override;
+
+    // Gives access to the stream's data
+    inline const std::vector<uint8_t> &GetBuffer() const { return _buf; }
+    // Moves the data out of the stream, leaving it empty
+    void    ReleaseBuffer(std::vector<uint8_t> &buf);
+
+    void    Close() override;
+    bool    Flush() override;
+
+    bool    IsValid() const override;
+    bool    EOS() const override;
+    soff_t  GetLength() const override;
+    soff_t  GetPosition() const override;
+    bool    CanRead() const override;
+    bool    CanWrite() const override;
+    bool    CanSeek() const override;
+
+    size_t  Read(void *buffer, size_t size) override;
+    int32_t ReadByte() override;
+    size_t  Write(const void *buffer, size_t size) override;
+    int32_t WriteByte(uint8_t b) override;
+
+    bool    Seek(soff_t offset, StreamSeek origin) override;
+
+private:
+    std::vector<uint8_t> _buf;
+    size_t               _pos;
+    FileWorkMode         _workMode;
+    bool                 _closed;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__MEMORYSTREAM_H
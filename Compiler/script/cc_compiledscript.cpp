@@ -286,6 +286,7 @@ void ccCompiledScript::init() {
     capacitySections = 0;
     sectionNames = NULL;
     sectionOffsets = NULL;
+    hasFusedCmds = false;
     next_line = 0;
     ax_val_type = 0;
     ax_val_scope = 0;
@@ -304,3 +305,170 @@ void ccCompiledScript::free_extra() {
 void ccCompiledScript::shutdown() {
     free_extra();
 }
+
+const int sccmd_numargs[CC_NUM_SCCMDS] =
+{
+    0, 2, 2, 2, 2, 0, 2, 1, 1, 2, // NULL .. MULREG
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // DIVREG .. GTE
+    2, 2, 2, 1, 1, 1, 1, 1, 1, 1, // LTE .. PUSHREG
+    1, 1, 2, 1, 1, 1, 1, 1, 1, 1, // POPREG .. NUMFUNCARGS
+    2, 2, 1, 2, 2, 1, 2, 1, 1, 0, // MODREG .. MEMZEROPTR
+    1, 1, 0, 2, 2, 2, 2, 2, 2, 2, // MEMINITPTR .. FGREATER
+    2, 2, 2, 1, 1, 2, 2, 1, 0, 0, // FLESSTHAN .. MEMZEROPTRND
+    1, 1, 3, 2, 3, 2, 2           // JNZ .. MEMWRITESPOFFS
+};
+
+// Performs a single optimization pass; returns if anything was changed
+static bool optimize_code_pass(ccCompiledScript *scrip)
+{
+    const int32_t codesize = scrip->codesize;
+    const int32_t *code = scrip->code;
+    // Find out where the commands begin, and which of them may be
+    // jumped to or called; these must not become part of fused command
+    std::vector<char> is_cmd(codesize + 1, 0);
+    std::vector<char> is_label(codesize + 1, 0);
+    is_cmd[codesize] = 1;
+    is_label[codesize] = 1;
+    for (int32_t pc = 0; pc < codesize; pc += sccmd_numargs[code[pc]] + 1) {
+        if (code[pc] <= 0 || code[pc] >= CC_NUM_SCCMDS ||
+            pc + sccmd_numargs[code[pc]] >= codesize)
+            return false; // unexpected code layout, leave as it is
+        is_cmd[pc] = 1;
+        int32_t target = -1;
+        if (code[pc] == SCMD_JMP || code[pc] == SCMD_JZ || code[pc] == SCMD_JNZ)
+            target = pc + 2 + code[pc + 1];
+        else if (code[pc] == SCMD_THISBASE)
+            target = code[pc + 1];
+        else
+            continue;
+        if (target < 0 || target > codesize)
+            return false;
+        is_label[target] = 1;
+    }
+    std::vector<int32_t> labels;
+    for (int i = 0; i < scrip->numfixups; ++i) {
+        if (scrip->fixuptypes[i] == FIXUP_FUNCTION)
+            labels.push_back(code[scrip->fixups[i]]);
+    }
+    for (int i = 0; i < scrip->numfunctions; ++i)
+        labels.push_back(scrip->funccodeoffs[i]);
+    for (int i = 0; i < scrip->numexports; ++i) {
+        if (((scrip->export_addr[i] >> 24) & 0xff) == EXPORT_FUNCTION)
+            labels.push_back(scrip->export_addr[i] & 0x00ffffff);
+    }
+    for (int i = 0; i < scrip->numSections; ++i)
+        labels.push_back(scrip->sectionOffsets[i]);
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] < 0 || labels[i] > codesize || !is_cmd[labels[i]])
+            return false;
+        is_label[labels[i]] = 1;
+    }
+
+    // Write the new code, remembering new positions of the commands and
+    // their arguments
+    std::vector<int32_t> new_code;
+    std::vector<int32_t> cmd_map(codesize + 1, -1);
+    std::vector<int32_t> word_map(codesize, -1);
+    new_code.reserve(codesize);
+    bool changed = false;
+    for (int32_t pc = 0; pc < codesize;) {
+        cmd_map[pc] = new_code.size();
+        const int32_t cmd = code[pc];
+        const int32_t next = pc + sccmd_numargs[cmd] + 1;
+        const int32_t next_cmd = (next < codesize && !is_label[next]) ? code[next] : 0;
+        const int32_t third = next_cmd ? next + sccmd_numargs[next_cmd] + 1 : codesize;
+        const int32_t third_cmd = (third < codesize && !is_label[third]) ? code[third] : 0;
+
+        if (cmd == SCMD_PUSHREG && next_cmd == SCMD_POPREG) {
+            // push reg1; pop reg2 => reg2 = reg1
+            if (code[pc + 1] != code[next + 1]) {
+                new_code.push_back(SCMD_REGTOREG);
+                word_map[pc + 1] = new_code.size();
+                new_code.push_back(code[pc + 1]);
+                word_map[next + 1] = new_code.size();
+                new_code.push_back(code[next + 1]);
+            }
+            pc = next + 2;
+        } else if (cmd == SCMD_PUSHREG && next_cmd == SCMD_LITTOREG && third_cmd == SCMD_POPREG &&
+                   code[next + 1] != code[third + 1]) {
+            // push reg1; reg2 = lit; pop reg3 => reg3 = reg1; reg2 = lit
+            if (code[pc + 1] != code[third + 1]) {
+                new_code.push_back(SCMD_REGTOREG);
+                word_map[pc + 1] = new_code.size();
+                new_code.push_back(code[pc + 1]);
+                word_map[third + 1] = new_code.size();
+                new_code.push_back(code[third + 1]);
+            }
+            new_code.push_back(SCMD_LITTOREG);
+            word_map[next + 1] = new_code.size();
+            new_code.push_back(code[next + 1]);
+            word_map[next + 2] = new_code.size();
+            new_code.push_back(code[next + 2]);
+            pc = third + 2;
+        } else if (cmd == SCMD_LITTOREG && next_cmd == SCMD_ADDREG && code[pc + 1] == code[next + 2]) {
+            // reg1 = lit; reg2 += reg1 => fused LITADDREG
+            new_code.push_back(SCMD_LITADDREG);
+            word_map[pc + 1] = new_code.size();
+            new_code.push_back(code[pc + 1]);
+            word_map[pc + 2] = new_code.size();
+            new_code.push_back(code[pc + 2]);
+            word_map[next + 1] = new_code.size();
+            new_code.push_back(code[next + 1]);
+            scrip->hasFusedCmds = true;
+            pc = next + 3;
+        } else if (cmd == SCMD_LOADSPOFFS && (next_cmd == SCMD_MEMREAD || next_cmd == SCMD_MEMWRITE)) {
+            // MAR = SP - offs; read/write reg1 => fused MEMREADSPOFFS/MEMWRITESPOFFS
+            new_code.push_back(next_cmd == SCMD_MEMREAD ? SCMD_MEMREADSPOFFS : SCMD_MEMWRITESPOFFS);
+            word_map[pc + 1] = new_code.size();
+            new_code.push_back(code[pc + 1]);
+            word_map[next + 1] = new_code.size();
+            new_code.push_back(code[next + 1]);
+            scrip->hasFusedCmds = true;
+            pc = next + 2;
+        } else {
+            new_code.push_back(cmd);
+            for (++pc; pc < next; ++pc) {
+                word_map[pc] = new_code.size();
+                new_code.push_back(code[pc]);
+            }
+            continue;
+        }
+        changed = true;
+    }
+    cmd_map[codesize] = new_code.size();
+    if (!changed)
+        return false;
+
+    // Fix relative jumps and function addresses
+    for (int32_t pc = 0; pc < codesize; pc += sccmd_numargs[code[pc]] + 1) {
+        // NOTE: jumps are never fused, so they are always found in the new code
+        if (code[pc] == SCMD_JMP || code[pc] == SCMD_JZ || code[pc] == SCMD_JNZ)
+            new_code[word_map[pc + 1]] = cmd_map[pc + 2 + code[pc + 1]] - (cmd_map[pc] + 2);
+        else if (code[pc] == SCMD_THISBASE)
+            new_code[word_map[pc + 1]] = cmd_map[code[pc + 1]];
+    }
+    for (int i = 0; i < scrip->numfixups; ++i) {
+        if (scrip->fixuptypes[i] == FIXUP_DATADATA)
+            continue;
+        const int32_t old_pos = scrip->fixups[i];
+        scrip->fixups[i] = word_map[old_pos];
+        if (scrip->fixuptypes[i] == FIXUP_FUNCTION)
+            new_code[word_map[old_pos]] = cmd_map[code[old_pos]];
+    }
+    for (int i = 0; i < scrip->numfunctions; ++i)
+        scrip->funccodeoffs[i] = cmd_map[scrip->funccodeoffs[i]];
+    for (int i = 0; i < scrip->numexports; ++i) {
+        if (((scrip->export_addr[i] >> 24) & 0xff) == EXPORT_FUNCTION)
+            scrip->export_addr[i] = cmd_map[scrip->export_addr[i] & 0x00ffffff] | (EXPORT_FUNCTION << 24);
+    }
+    for (int i = 0; i < scrip->numSections; ++i)
+        scrip->sectionOffsets[i] = cmd_map[scrip->sectionOffsets[i]];
+
+    memcpy(scrip->code, &new_code.front(), new_code.size() * sizeof(int32_t));
+    scrip->codesize = new_code.size();
+    return true;
+}
+
+void ccCompiledScript::optimize_code() {
+    while (optimize_code_pass(this));
+}
@@ -2,6 +2,7 @@
 #define __CC_COMPILEDSCRIPT_H
 
 #include <string>
+#include <vector>
 #include "script/cc_script.h"       // ccScript
 #include "cs_parser_common.h"   // macro definitions
 #include "cc_symboldef.h"       // SymbolDef
@@ -42,8 +43,15 @@ struct ccCompiledScript: public ccScript {
     void push_reg(int regg);
     void pop_reg(int regg);
 
+    // Replaces common command sequences in the finished code with
+    // the shorter equivalents, fixing all the code offsets afterwards
+    void optimize_code();
+
     ccCompiledScript();
     virtual ~ccCompiledScript();
 };
 
+// Number of arguments of each script command
+extern const int sccmd_numargs[];
+
 #endif // __CC_COMPILEDSCRIPT_H
\ No newline at end of file
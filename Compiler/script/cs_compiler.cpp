@@ -135,6 +135,9 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
         }
     }
 
+    if (ccGetOption(SCOPT_OPTIMIZE))
+        cctemp->optimize_code();
+
     cctemp->free_extra();
     return cctemp;
 }
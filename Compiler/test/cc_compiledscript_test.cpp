@@ -0,0 +1,108 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "script/cc_compiledscript.h"
+#include "script/cc_symboltable.h"
+#include "script/cs_parser.h"
+#include "script/script_common.h"
+
+extern ccCompiledScript *newScriptFixture(); // in cs_parser_test
+
+TEST(CompiledScript, OptimizeFusesCommands) {
+    ccCompiledScript *scrip = newScriptFixture();
+    scrip->start_new_section("test");
+    scrip->add_new_function("f", NULL);
+    scrip->write_cmd1(SCMD_THISBASE, 0);            // 0
+    scrip->write_cmd2(SCMD_LITTOREG, SREG_AX, 5);   // 2
+    scrip->write_cmd1(SCMD_PUSHREG, SREG_AX);       // 5
+    scrip->write_cmd1(SCMD_POPREG, SREG_BX);        // 7
+    scrip->write_cmd1(SCMD_LOADSPOFFS, 4);          // 9
+    scrip->write_cmd1(SCMD_MEMREAD, SREG_CX);       // 11
+    scrip->write_cmd2(SCMD_LITTOREG, SREG_DX, 2);   // 13
+    scrip->fixup_previous(FIXUP_STRING);
+    scrip->write_cmd2(SCMD_ADDREG, SREG_BX, SREG_DX); // 16
+    scrip->write_cmd1(SCMD_JZ, 2);                  // 19
+    scrip->write_cmd1(SCMD_JMP, 13 - 23);           // 21
+    scrip->write_cmd(SCMD_RET);                     // 23
+    scrip->add_new_export("f", EXPORT_FUNCTION, 0, 0);
+
+    scrip->optimize_code();
+
+    const int32_t expect_code[] = {
+        SCMD_THISBASE, 0,
+        SCMD_LITTOREG, SREG_AX, 5,
+        SCMD_REGTOREG, SREG_AX, SREG_BX,
+        SCMD_MEMREADSPOFFS, 4, SREG_CX,
+        SCMD_LITADDREG, SREG_DX, 2, SREG_BX,
+        SCMD_JZ, 2,
+        SCMD_JMP, 11 - 19,
+        SCMD_RET
+    };
+    const int32_t expect_size = sizeof(expect_code) / sizeof(expect_code[0]);
+    ASSERT_EQ(expect_size, scrip->codesize);
+    for (int i = 0; i < expect_size; ++i)
+        EXPECT_EQ(expect_code[i], scrip->code[i]);
+    ASSERT_EQ(1, scrip->numfixups);
+    EXPECT_EQ(13, scrip->fixups[0]);
+    EXPECT_EQ(0, scrip->funccodeoffs[0]);
+    EXPECT_EQ(EXPORT_FUNCTION << 24, scrip->export_addr[0]);
+    EXPECT_TRUE(scrip->hasFusedCmds);
+}
+
+TEST(CompiledScript, OptimizeKeepsJumpTargets) {
+    ccCompiledScript *scrip = newScriptFixture();
+    scrip->add_new_function("f", NULL);
+    scrip->write_cmd2(SCMD_LITTOREG, SREG_AX, 1);   // 0
+    scrip->write_cmd1(SCMD_PUSHREG, SREG_AX);       // 3
+    scrip->write_cmd1(SCMD_POPREG, SREG_BX);        // 5, jumped to
+    scrip->write_cmd1(SCMD_JMP, 5 - 9);             // 7
+    scrip->write_cmd(SCMD_RET);                     // 9
+
+    scrip->optimize_code();
+
+    ASSERT_EQ(10, scrip->codesize);
+    EXPECT_EQ(SCMD_PUSHREG, scrip->code[3]);
+    EXPECT_EQ(SCMD_POPREG, scrip->code[5]);
+    EXPECT_EQ(-4, scrip->code[8]);
+    EXPECT_FALSE(scrip->hasFusedCmds);
+}
+
+TEST(CompiledScript, OptimizeCompiledCode) {
+    ccCompiledScript *scrip = newScriptFixture();
+
+    char *inpl = "\
+        int arr[10];\
+        int Sum(int a, int b) { return a + b; }\
+        int Calc(int n)\
+        {\
+          int total = 0;\
+          int i = 0;\
+          while (i < n)\
+          {\
+            total = total + arr[i % 10] * 2;\
+            if (total > 1000) total = total - 7;\
+            i++;\
+          }\
+          for (int k = 0; k < 5; k++) { total += Sum(k, total + 1); }\
+          return total;\
+        }";
+
+    ASSERT_EQ(0, cc_compile(inpl, scrip));
+    const int32_t old_codesize = scrip->codesize;
+    scrip->optimize_code();
+    EXPECT_LT(scrip->codesize, old_codesize);
+
+    // Every jump and every function address must still point to a command
+    std::vector<char> is_cmd(scrip->codesize + 1, 0);
+    for (int32_t pc = 0; pc < scrip->codesize; pc += sccmd_numargs[scrip->code[pc]] + 1)
+        is_cmd[pc] = 1;
+    for (int32_t pc = 0; pc < scrip->codesize; pc += sccmd_numargs[scrip->code[pc]] + 1) {
+        if (scrip->code[pc] == SCMD_JMP || scrip->code[pc] == SCMD_JZ || scrip->code[pc] == SCMD_JNZ)
+            EXPECT_TRUE(is_cmd[pc + 2 + scrip->code[pc + 1]]);
+    }
+    for (int i = 0; i < scrip->numfixups; ++i) {
+        if (scrip->fixuptypes[i] == FIXUP_FUNCTION)
+            EXPECT_TRUE(is_cmd[scrip->code[scrip->fixups[i]]]);
+    }
+    for (int i = 0; i < scrip->numfunctions; ++i)
+        EXPECT_TRUE(is_cmd[scrip->funccodeoffs[i]]);
+}
@@ -2120,6 +2120,14 @@ builtin struct Game {
   /// Gets the number of cameras.
   import static readonly attribute int CameraCount;
 #endif
+#ifdef SCRIPT_API_v351
+  /// Saves the game state into memory, after the current script function finishes.
+  import static void SaveState();
+  /// Restores the game state saved in memory, where 0 is the latest one, after the current script function finishes.
+  import static void RestoreState(int index = 0);
+  /// Gets the number of the game states currently saved in memory.
+  import static readonly attribute int SaveStateCount;
+#endif
 #ifdef SCRIPT_API_v399
   /// [exp] Sets a different ratio for the way direction is calculated (default 1.0)
   import static void SetDirectionRatio(float ratio);
@@ -76,6 +76,7 @@ namespace AGS
 			  ccSetOption(SCOPT_NOIMPORTOVERRIDE, isRoomScript);
 
 			  ccSetOption(SCOPT_OLDSTRINGS, !game->Settings->EnforceNewStrings);
+			  ccSetOption(SCOPT_OPTIMIZE, game->Settings->OptimizeScriptCode);
 
         if (exceptionToThrow == nullptr)
         {
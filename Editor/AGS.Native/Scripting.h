@@ -48,7 +48,7 @@ namespace AGS
                     writer->Write((System::Byte)scfilesig[i]);
                 }
                 const ccScript *cs = _compiledScript->get();
-                writer->Write(SCOM_VERSION);
+                writer->Write(cs->hasFusedCmds ? SCOM_VERSION_FUSEDCMDS : SCOM_VERSION_BASIC);
                 writer->Write(cs->globaldatasize);
                 writer->Write(cs->codesize);
                 writer->Write(cs->stringssize);
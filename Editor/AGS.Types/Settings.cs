@@ -62,6 +62,7 @@ namespace AGS.Types
         private RoomTransitionStyle _roomTransition = RoomTransitionStyle.FadeOutAndIn;
         private bool _saveScreenshots = false;
         private bool _compressSprites = false;
+        private bool _optimizeScriptCode = false;
         private bool _inventoryCursors = true;
         private bool _handleInvInScript = false;
         private bool _displayMultipleInv = false;
@@ -306,6 +307,16 @@ namespace AGS.Types
             set { _compressSprites = value; }
         }
 
+        [DisplayName("Optimize compiled scripts")]
+        [Description("Replace common command sequences in the compiled scripts with shorter fused commands, which run faster. Scripts compiled this way require AGS 3.99.99 engine or higher")]
+        [DefaultValue(false)]
+        [Category("Compiler")]
+        public bool OptimizeScriptCode
+        {
+            get { return _optimizeScriptCode; }
+            set { _optimizeScriptCode = value; }
+        }
+
         [DisplayName("Save screenshots in save games")]
         [Description("A screenshot of the player's current position will be saved into the save games")]
         [DefaultValue(false)]
@@ -22,4 +22,5 @@ void SpriteCache::InitNullSpriteParams(sprkey_t index)
     // no sprite ... blank it out
     _sprInfos[index] = SpriteInfo();
     _spriteData[index] = SpriteData();
+    _spriteOffsets[index] = 0;
 }
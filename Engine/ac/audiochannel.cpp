@@ -91,6 +91,7 @@ int AudioChannel_GetPosition(ScriptAudioChannel *channel)
         if (play.fast_forward)
             return 999999999;
 
+        wait_clip_seek(ch);
         return ch->get_pos();
     }
     return 0;
@@ -106,6 +107,7 @@ int AudioChannel_GetPositionMs(ScriptAudioChannel *channel)
         if (play.fast_forward)
             return 999999999;
 
+        wait_clip_seek(ch);
         return ch->get_pos_ms();
     }
     return 0;
@@ -191,7 +193,7 @@ void AudioChannel_Seek(ScriptAudioChannel *channel, int newPosition)
 
     if (ch)
     {
-        ch->seek(newPosition);
+        seek_clip(ch, newPosition);
     }
 }
 
@@ -2111,6 +2111,7 @@ void animate_character(CharacterInfo *chap, int loopn,int sppd,int rept, int noi
     if ((sframe < 0) || (sframe >= views[chap->view].loops[loopn].numFrames))
         quit("!AnimateCharacter: invalid starting frame number specified");
     Character_StopMoving(chap);
+    prefetch_view_loop(chap->view, loopn);
     chap->animating=1;
     if (rept) chap->animating |= CHANIM_REPEAT;
     if (direction) chap->animating |= CHANIM_BACKWARDS;
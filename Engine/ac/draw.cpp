@@ -42,6 +42,7 @@
 #include "ac/screenoverlay.h"
 #include "ac/sprite.h"
 #include "ac/spritelistentry.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
 #include "ac/system.h"
 #include "ac/viewframe.h"
@@ -86,8 +87,6 @@ extern AGSPlatformDriver *platform;
 extern RoomStruct thisroom;
 extern char noWalkBehindsAtAll;
 extern unsigned int loopcounter;
-extern char *walkBehindExists;  // whether a WB area is in this column
-extern int *walkBehindStartY, *walkBehindEndY;
 extern int walkBehindLeft[MAX_WALK_BEHINDS], walkBehindTop[MAX_WALK_BEHINDS];
 extern int walkBehindRight[MAX_WALK_BEHINDS], walkBehindBottom[MAX_WALK_BEHINDS];
 extern IDriverDependantBitmap *walkBehindBitmap[MAX_WALK_BEHINDS];
@@ -758,6 +757,101 @@ void invalidate_cached_walkbehinds()
     memset(&actspswbcache[0], 0, sizeof(CachedActSpsData) * actSpsCount);
 }
 
+// 24-bit pixel, for use in the walk-behind span templates
+struct Pixel24
+{
+    uint8_t C[3];
+
+    Pixel24(color_t color) { memcpy(C, &color, 3); }
+    bool operator !=(const Pixel24 &other) const { return memcmp(C, other.C, 3) != 0; }
+};
+
+// Applies walk-behind to the span of sprite pixels: copies background pixels
+// where the checked sprite is not transparent, or fills with the mask color
+// if there's no background to copy from. check_x tells which pixel of the
+// checked row corresponds to each pixel of the span.
+// Returns whether any pixels were updated.
+template <typename T>
+static bool sort_out_walk_behind_span(T *dst, const T *bg, const T *check_row, const int *check_x,
+    int count, T maskcol)
+{
+    if (!bg)
+    {
+        for (int x = 0; x < count; ++x)
+            dst[x] = maskcol;
+        return count > 0;
+    }
+
+    bool changed = false;
+    for (int x = 0; x < count; ++x)
+    {
+        if (check_row[check_x[x]] != maskcol)
+        {
+            dst[x] = bg[x];
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+template <typename T>
+static int sort_out_walk_behinds_impl(Bitmap *sprit, int xx, int yy, int basel, Bitmap *copyPixelsFrom, Bitmap *checkPixelsFrom, int zoom)
+{
+    const T maskcol = (T)sprit->GetMaskColor();
+    // only check within the mask's bounds
+    const int x1 = std::max(0, -xx);
+    const int x2 = std::min(sprit->GetWidth(), thisroom.WalkBehindMask->GetWidth() - xx);
+    const int y1 = std::max(0, -yy);
+    const int y2 = std::min(sprit->GetHeight(), thisroom.WalkBehindMask->GetHeight() - yy);
+    if (x1 >= x2 || y1 >= y2)
+        return 0;
+
+    // columns of the checked sprite, which may be zoomed
+    static std::vector<int> check_x;
+    if (copyPixelsFrom)
+    {
+        check_x.resize(x2);
+        for (int x = x1; x < x2; ++x)
+            check_x[x] = (x * 100) / zoom;
+    }
+
+    int pixelsChanged = 0;
+    for (int rr = y1; rr < y2; ++rr)
+    {
+        const int mask_y = rr + yy;
+        const size_t run_end = walkBehindRowRuns[mask_y + 1];
+        size_t run = walkBehindRowRuns[mask_y];
+        // skip runs to the left of the sprite
+        for (; run < run_end && walkBehindRuns[run].X2 - xx <= x1; ++run);
+        if (run == run_end)
+            continue;
+
+        T *dst_row = (T*)sprit->GetScanLineForWriting(rr);
+        const T *bg_row = nullptr;
+        const T *check_row = nullptr;
+        if (copyPixelsFrom)
+        {
+            bg_row = (const T*)copyPixelsFrom->GetScanLine(mask_y);
+            check_row = (const T*)checkPixelsFrom->GetScanLine((rr * 100) / zoom);
+        }
+
+        for (; run < run_end; ++run)
+        {
+            const WalkBehindRun &wb_run = walkBehindRuns[run];
+            if (wb_run.X1 - xx >= x2)
+                break;
+            if (croom->walkbehind_base[wb_run.Area] <= basel)
+                continue;
+            const int span_x1 = std::max(x1, wb_run.X1 - xx);
+            const int span_x2 = std::min(x2, wb_run.X2 - xx);
+            if (sort_out_walk_behind_span<T>(dst_row + span_x1, bg_row ? bg_row + span_x1 + xx : nullptr,
+                    check_row, copyPixelsFrom ? &check_x[span_x1] : nullptr, span_x2 - span_x1, maskcol))
+                pixelsChanged = 1;
+        }
+    }
+    return pixelsChanged;
+}
+
 // sort_out_walk_behinds: modifies the supplied sprite by overwriting parts
 // of it with transparent pixels where there are walk-behind areas
 // Returns whether any pixels were updated
@@ -769,114 +863,20 @@ int sort_out_walk_behinds(Bitmap *sprit,int xx,int yy,int basel, Bitmap *copyPix
         (!sprit->IsMemoryBitmap()))
         quit("!sort_out_walk_behinds: wb bitmap not linear");
 
-    int rr,tmm, toheight;//,tcol;
-    // precalculate this to try and shave some time off
-    int maskcol = sprit->GetMaskColor();
-    int spcoldep = sprit->GetColorDepth();
-    int screenhit = thisroom.WalkBehindMask->GetHeight();
-    short *shptr, *shptr2;
-    int *loptr, *loptr2;
-    int pixelsChanged = 0;
-    int ee = 0;
-    if (xx < 0)
-        ee = 0 - xx;
-
+    const int spcoldep = sprit->GetColorDepth();
     if ((checkPixelsFrom != nullptr) && (checkPixelsFrom->GetColorDepth() != spcoldep))
         quit("sprite colour depth does not match background colour depth");
 
-    for ( ; ee < sprit->GetWidth(); ee++) {
-        if (ee + xx >= thisroom.WalkBehindMask->GetWidth())
-            break;
-
-        if ((!walkBehindExists[ee+xx]) ||
-            (walkBehindEndY[ee+xx] <= yy) ||
-            (walkBehindStartY[ee+xx] > yy+sprit->GetHeight()))
-            continue;
-
-        toheight = sprit->GetHeight();
-
-        if (walkBehindStartY[ee+xx] < yy)
-            rr = 0;
-        else
-            rr = (walkBehindStartY[ee+xx] - yy);
-
-        // Since we will use _getpixel, ensure we only check within the screen
-        if (rr + yy < 0)
-            rr = 0 - yy;
-        if (toheight + yy > screenhit)
-            toheight = screenhit - yy;
-        if (toheight + yy > walkBehindEndY[ee+xx])
-            toheight = walkBehindEndY[ee+xx] - yy;
-        if (rr < 0)
-            rr = 0;
-
-        for ( ; rr < toheight;rr++) {
-
-            // we're ok with _getpixel because we've checked the screen edges
-            //tmm = _getpixel(thisroom.WalkBehindMask,ee+xx,rr+yy);
-            // actually, _getpixel is well inefficient, do it ourselves
-            // since we know it's 8-bit bitmap
-            tmm = thisroom.WalkBehindMask->GetScanLine(rr+yy)[ee+xx];
-            if (tmm<1) continue;
-            if (croom->walkbehind_base[tmm] <= basel) continue;
-
-            if (copyPixelsFrom != nullptr)
-            {
-                if (spcoldep <= 8)
-                {
-                    if (checkPixelsFrom->GetScanLine((rr * 100) / zoom)[(ee * 100) / zoom] != maskcol) {
-                        sprit->GetScanLineForWriting(rr)[ee] = copyPixelsFrom->GetScanLine(rr + yy)[ee + xx];
-                        pixelsChanged = 1;
-                    }
-                }
-                else if (spcoldep <= 16) {
-                    shptr = (short*)&sprit->GetScanLine(rr)[0];
-                    shptr2 = (short*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (shptr2[(ee * 100) / zoom] != maskcol) {
-                        shptr[ee] = ((short*)(&copyPixelsFrom->GetScanLine(rr + yy)[0]))[ee + xx];
-                        pixelsChanged = 1;
-                    }
-                }
-                else if (spcoldep == 24) {
-                    char *chptr = (char*)&sprit->GetScanLine(rr)[0];
-                    char *chptr2 = (char*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (memcmp(&chptr2[((ee * 100) / zoom) * 3], &maskcol, 3) != 0) {
-                        memcpy(&chptr[ee * 3], &copyPixelsFrom->GetScanLine(rr + yy)[(ee + xx) * 3], 3);
-                        pixelsChanged = 1;
-                    }
-                }
-                else if (spcoldep <= 32) {
-                    loptr = (int*)&sprit->GetScanLine(rr)[0];
-                    loptr2 = (int*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (loptr2[(ee * 100) / zoom] != maskcol) {
-                        loptr[ee] = ((int*)(&copyPixelsFrom->GetScanLine(rr + yy)[0]))[ee + xx];
-                        pixelsChanged = 1;
-                    }
-                }
-            }
-            else
-            {
-                pixelsChanged = 1;
-                if (spcoldep <= 8)
-                    sprit->GetScanLineForWriting(rr)[ee] = maskcol;
-                else if (spcoldep <= 16) {
-                    shptr = (short*)&sprit->GetScanLine(rr)[0];
-                    shptr[ee] = maskcol;
-                }
-                else if (spcoldep == 24) {
-                    char *chptr = (char*)&sprit->GetScanLine(rr)[0];
-                    memcpy(&chptr[ee * 3], &maskcol, 3);
-                }
-                else if (spcoldep <= 32) {
-                    loptr = (int*)&sprit->GetScanLine(rr)[0];
-                    loptr[ee] = maskcol;
-                }
-                else
-                    quit("!Sprite colour depth >32 ??");
-            }
-        }
-    }
-    return pixelsChanged;
+    if (spcoldep <= 8)
+        return sort_out_walk_behinds_impl<uint8_t>(sprit, xx, yy, basel, copyPixelsFrom, checkPixelsFrom, zoom);
+    else if (spcoldep <= 16)
+        return sort_out_walk_behinds_impl<uint16_t>(sprit, xx, yy, basel, copyPixelsFrom, checkPixelsFrom, zoom);
+    else if (spcoldep == 24)
+        return sort_out_walk_behinds_impl<Pixel24>(sprit, xx, yy, basel, copyPixelsFrom, checkPixelsFrom, zoom);
+    else if (spcoldep <= 32)
+        return sort_out_walk_behinds_impl<uint32_t>(sprit, xx, yy, basel, copyPixelsFrom, checkPixelsFrom, zoom);
+    quit("!Sprite colour depth >32 ??");
+    return 0;
 }
 
 void sort_out_char_sprite_walk_behind(int actspsIndex, int xx, int yy, int basel, int zoom, int width, int height)
@@ -1188,17 +1188,18 @@ void apply_tint_or_light(int actspsindex, int light_level,
          if (game.color_depth == 1) {
              // 256-col
              lit_amnt = (250 - ((-light_level) * 5)/2);
+             active_spr->LitBlendBlt(oldwas, 0, 0, lit_amnt);
          }
          else {
              // hi-color
-             if (light_level < 0)
-                 set_my_trans_blender(8,8,8,0);
-             else
-                 set_my_trans_blender(248,248,248,0);
+             const int lit_col = light_level < 0 ? 8 : 248;
              lit_amnt = abs(light_level) * 2;
+             if (!GfxUtil::BlendSpriteLit32(active_spr, oldwas, 0, 0, makecol32(lit_col, lit_col, lit_col), lit_amnt, true))
+             {
+                 set_my_trans_blender(lit_col, lit_col, lit_col, 0);
+                 active_spr->LitBlendBlt(oldwas, 0, 0, lit_amnt);
+             }
          }
-
-         active_spr->LitBlendBlt(oldwas, 0, 0, lit_amnt);
      }
 
      if (oldwas != blitFrom)
@@ -1295,6 +1296,65 @@ int scale_and_flip_sprite(int useindx, int coldept, int zoom_level,
 }
 
 
+// Draws the 'sppic' sprite onto actsps[useindx], scaled, flipped, tinted
+// or lit as necessary. The transformed images are kept in the shared sprite
+// transform cache, so that characters and objects which show the same
+// sprite in the same way do not redo the work.
+static void transform_sprite_software(int useindx, int coldept, int sppic, int zoom_level,
+                               int newwidth, int newheight, int isMirrored, int light_level,
+                               int tint_amount, int tint_red, int tint_green, int tint_blue, int tint_light) {
+
+  // 8-bit images depend on the palette and color maps, which may change
+  // at any time, so they are not cached
+  const bool use_cache = (coldept > 8) &&
+      ((zoom_level != 100) || isMirrored || (light_level != 0) || (tint_amount != 0));
+  SpriteTransformKey key;
+  if (use_cache) {
+      key.Sprite = sppic;
+      key.Width = newwidth;
+      key.Height = newheight;
+      key.Mirrored = isMirrored != 0;
+      key.Antialiased = IS_ANTIALIAS_SPRITES;
+      key.TintRed = tint_red;
+      key.TintGreen = tint_green;
+      key.TintBlue = tint_blue;
+      key.TintAmount = tint_amount;
+      key.TintLight = tint_light;
+      key.LightLevel = light_level;
+      Bitmap *cached = get_transformed_sprite(key);
+      if (cached && cached->GetColorDepth() == coldept) {
+          actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, cached->GetWidth(), cached->GetHeight());
+          actsps[useindx]->Blit(cached, 0, 0, 0, 0, cached->GetWidth(), cached->GetHeight());
+          return;
+      }
+  }
+
+  // draw the base sprite, scaled and flipped as appropriate
+  int actspsUsed = scale_and_flip_sprite(useindx, coldept, zoom_level,
+      sppic, newwidth, newheight, isMirrored);
+
+  // apply tints or lightenings where appropriate, else just copy
+  // the source bitmap
+  if ((light_level != 0) || (tint_amount != 0)) {
+      // if possible, direct read from the source image
+      Bitmap *comeFrom = nullptr;
+      if (!actspsUsed)
+          comeFrom = spriteset[sppic];
+
+      apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
+          tint_green, tint_blue, tint_light, coldept,
+          comeFrom);
+  }
+  else if (!actspsUsed) {
+      // no scaling, flipping or tinting was done, so just blit it normally
+      actsps[useindx]->Blit(spriteset[sppic], 0, 0, 0, 0, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
+  }
+
+  if (use_cache)
+      put_transformed_sprite(key, actsps[useindx]);
+}
+
+
 
 // create the actsps[aa] image with the object drawn correctly
 // returns 1 if nothing at all has changed and actsps is still
@@ -1432,33 +1492,16 @@ int construct_object_gfx(int aa, int *drawnWidth, int *drawnHeight, bool alwaysU
 
     // Not cached, so draw the image
 
-    int actspsUsed = 0;
     if (!hardwareAccelerated)
     {
-        // draw the base sprite, scaled and flipped as appropriate
-        actspsUsed = scale_and_flip_sprite(useindx, coldept, zoom_level,
-            objs[aa].num, sprwidth, sprheight, isMirrored);
+        transform_sprite_software(useindx, coldept, objs[aa].num, zoom_level,
+            sprwidth, sprheight, isMirrored, light_level,
+            tint_level, tint_red, tint_green, tint_blue, tint_light);
     }
     else
     {
-        // ensure actsps exists
+        // ensure actsps exists, and copy the source bitmap
         actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, game.SpriteInfos[objs[aa].num].Width, game.SpriteInfos[objs[aa].num].Height);
-    }
-
-    // direct read from source bitmap, where possible
-    Bitmap *comeFrom = nullptr;
-    if (!actspsUsed)
-        comeFrom = spriteset[objs[aa].num];
-
-    // apply tints or lightenings where appropriate, else just copy
-    // the source bitmap
-    if (!hardwareAccelerated && ((tint_level > 0) || (light_level != 0)))
-    {
-        apply_tint_or_light(useindx, light_level, tint_level, tint_red,
-            tint_green, tint_blue, tint_light, coldept,
-            comeFrom);
-    }
-    else if (!actspsUsed) {
         actsps[useindx]->Blit(spriteset[objs[aa].num],0,0,0,0,game.SpriteInfos[objs[aa].num].Width, game.SpriteInfos[objs[aa].num].Height);
     }
 
@@ -1594,8 +1637,11 @@ void tint_image (Bitmap *ds, Bitmap *srcimg, int red, int grn, int blu, int ligh
         finaltarget->LitBlendBlt(srcimg, 0, 0, luminance);
 
         // customized trans blender to preserve alpha channel
-        set_my_trans_blender (0, 0, 0, light_level);
-        ds->TransBlendBlt (finaltarget, 0, 0);
+        if (!GfxUtil::BlendSpriteTrans32(ds, finaltarget, 0, 0, light_level, true))
+        {
+            set_my_trans_blender (0, 0, 0, light_level);
+            ds->TransBlendBlt (finaltarget, 0, 0);
+        }
         delete finaltarget;
     }
 }
@@ -1764,39 +1810,22 @@ void prepare_characters_for_drawing() {
         if (!charcache[aa].inUse) {
 
             // create the base sprite in actsps[useindx], which will
-            // be scaled and/or flipped, as appropriate
-            int actspsUsed = 0;
+            // be scaled, flipped and tinted, as appropriate
             if (!gfxDriver->HasAcceleratedTransform())
             {
-                actspsUsed = scale_and_flip_sprite(
-                    useindx, coldept, zoom_level, sppic,
-                    newwidth, newheight, isMirrored);
+                transform_sprite_software(useindx, coldept, sppic, zoom_level,
+                    newwidth, newheight, isMirrored, light_level,
+                    tint_amount, tint_red, tint_green, tint_blue, tint_light);
             }
             else 
             {
-                // ensure actsps exists
+                // ensure actsps exists, and just blit the sprite normally
                 actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, game.SpriteInfos[sppic].Width, game.SpriteInfos[sppic].Height);
+                actsps[useindx]->Blit (spriteset[sppic], 0, 0, 0, 0, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
             }
 
             our_eip = 335;
 
-            if (((light_level != 0) || (tint_amount != 0)) &&
-                (!gfxDriver->HasAcceleratedTransform())) {
-                    // apply the lightening or tinting
-                    Bitmap *comeFrom = nullptr;
-                    // if possible, direct read from the source image
-                    if (!actspsUsed)
-                        comeFrom = spriteset[sppic];
-
-                    apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
-                        tint_green, tint_blue, tint_light, coldept,
-                        comeFrom);
-            }
-            else if (!actspsUsed) {
-                // no scaling, flipping or tinting was done, so just blit it normally
-                actsps[useindx]->Blit (spriteset[sppic], 0, 0, 0, 0, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
-            }
-
             // update the character cache with the new image
             charcache[aa].inUse = 1;
             //charcache[aa].image = BitmapHelper::CreateBitmap_ (coldept, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
@@ -2037,37 +2066,43 @@ void draw_gui_and_overlays()
         if (playerchar->activeinv < 1) gui_inv_pic=-1;
         else gui_inv_pic=game.invinfo[playerchar->activeinv].pic;
         our_eip = 37;
+        // redraw only the GUIs that have changed, unless all were requested
         if (guis_need_update) {
             guis_need_update = 0;
-            for (aa=0;aa<game.numgui;aa++) {
-                if (!guis[aa].IsDisplayed()) continue;
-
-                if (guibg[aa] == nullptr)
-                    recreate_guibg_image(&guis[aa]);
-
-                eip_guinum = aa;
-                our_eip = 370;
-                guibg[aa]->ClearTransparent();
-                our_eip = 372;
-                guis[aa].DrawAt(guibg[aa], 0,0);
-                our_eip = 373;
-
-                bool isAlpha = false;
-                if (guis[aa].HasAlphaChannel()) 
-                {
-                    isAlpha = true;
-                }
-
-                if (guibgbmp[aa] != nullptr) 
-                {
-                    gfxDriver->UpdateDDBFromBitmap(guibgbmp[aa], guibg[aa], isAlpha);
-                }
-                else
-                {
-                    guibgbmp[aa] = gfxDriver->CreateDDBFromBitmap(guibg[aa], isAlpha);
-                }
-                our_eip = 374;
+            for (aa=0;aa<game.numgui;aa++)
+                guis[aa].MarkChanged();
+        }
+        for (aa=0;aa<game.numgui;aa++) {
+            if (!guis[aa].IsDisplayed()) continue;
+            if (!guis[aa].HasChanged() && guibg[aa] && guibgbmp[aa]) continue;
+
+            if (guibg[aa] == nullptr)
+                recreate_guibg_image(&guis[aa]);
+
+            eip_guinum = aa;
+            our_eip = 370;
+            guibg[aa]->ClearTransparent();
+            our_eip = 372;
+            guis[aa].DrawAt(guibg[aa], 0,0);
+            our_eip = 373;
+
+            bool isAlpha = false;
+            if (guis[aa].HasAlphaChannel()) 
+            {
+                isAlpha = true;
+            }
+
+            if (guibgbmp[aa] != nullptr) 
+            {
+                gfxDriver->UpdateDDBFromBitmap(guibgbmp[aa], guibg[aa], isAlpha);
+            }
+            else
+            {
+                guibgbmp[aa] = gfxDriver->CreateDDBFromBitmap(guibg[aa], isAlpha);
             }
+            // clear the flag only now, as recreating the image marks it again
+            guis[aa].ClearChanged();
+            our_eip = 374;
         }
         our_eip = 38;
         // Draw the GUIs
@@ -21,9 +21,11 @@
 #include "ac/gamesetupstruct.h"
 #include "ac/gamestate.h"
 #include "ac/global_translation.h"
+#include "ac/gui.h"
 #include "ac/objectcache.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
 #include "ac/walkbehind.h"
 #include "debug/debug_log.h"
@@ -77,6 +79,7 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
         if (sds->modified)
         {
             int tt;
+            invalidate_transformed_sprite(sds->dynamicSpriteNumber);
             // force a refresh of any cached object or character images
             if (croom != nullptr) 
             {
@@ -91,15 +94,7 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
                 if (charcache[tt].sppic == sds->dynamicSpriteNumber)
                     charcache[tt].sppic = -31999;
             }
-            for (tt = 0; tt < game.numgui; tt++) 
-            {
-                if ((guis[tt].BgImage == sds->dynamicSpriteNumber) &&
-                    (guis[tt].IsDisplayed()))
-                {
-                    guis_need_update = 1;
-                    break;
-                }
-            }
+            mark_gui_sprite_changed(sds->dynamicSpriteNumber);
         }
 
         sds->dynamicSpriteNumber = -1;
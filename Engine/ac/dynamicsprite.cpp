@@ -20,11 +20,13 @@
 #include "ac/gamesetupstruct.h"
 #include "ac/global_dynamicsprite.h"
 #include "ac/global_game.h"
+#include "ac/gui.h"
 #include "ac/math.h"    // M_PI
 #include "ac/objectcache.h"
 #include "ac/path_helper.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
+#include "ac/spritetransformcache.h"
 #include "ac/system.h"
 #include "debug/debug_log.h"
 #include "game/roomstruct.h"
@@ -165,6 +167,9 @@ void DynamicSprite_CopyTransparencyMask(ScriptDynamicSprite *sds, int sourceSpri
     }
 
     BitmapHelper::CopyTransparency(target, source, dst_has_alpha, src_has_alpha);
+    // the sprite was changed in place
+    invalidate_transformed_sprite(sds->slot);
+    mark_gui_sprite_changed(sds->slot);
 }
 
 void DynamicSprite_ChangeCanvasSize(ScriptDynamicSprite *sds, int width, int height, int x, int y) 
@@ -423,6 +428,8 @@ ScriptDynamicSprite* DynamicSprite_CreateFromBackground(int frame, int x1, int y
 void add_dynamic_sprite(int gotSlot, Bitmap *redin, bool hasAlpha) {
 
   spriteset.SetSprite(gotSlot, redin);
+  invalidate_transformed_sprite(gotSlot);
+  mark_gui_sprite_changed(gotSlot);
 
   game.SpriteInfos[gotSlot].Flags = SPF_DYNAMICALLOC;
 
@@ -447,12 +454,14 @@ void free_dynamic_sprite (int gotSlot) {
     quitprintf("!DeleteSprite: Attempted to free static sprite %d that was not loaded by the script", gotSlot);
 
   spriteset.RemoveSprite(gotSlot, true);
+  invalidate_transformed_sprite(gotSlot);
 
   game.SpriteInfos[gotSlot].Flags = 0;
   game.SpriteInfos[gotSlot].Width = 0;
   game.SpriteInfos[gotSlot].Height = 0;
 
   // ensure it isn't still on any GUI buttons
+  mark_gui_sprite_changed(gotSlot);
   for (tt = 0; tt < numguibuts; tt++) {
     if (guibuts[tt].IsDeleted())
       continue;
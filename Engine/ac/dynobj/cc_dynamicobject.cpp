@@ -85,6 +85,14 @@ void ccAttemptDisposeObject(int32_t handle) {
     pool.CheckDispose(handle);
 }
 
+char *ccAllocObjectData(size_t size) {
+    return pool.AllocData(size);
+}
+
+void ccFreeObjectData(const char *data) {
+    pool.FreeData(data);
+}
+
 // translate between object handles and memory addresses
 int32_t ccGetObjectHandleFromAddress(const char *address) {
     // set to null
@@ -102,6 +102,11 @@ extern void  ccSerializeAllObjects(Common::Stream *out);
 extern int   ccUnserializeAllObjects(Common::Stream *in, ICCObjectReader *callback);
 // dispose the object if RefCount==0
 extern void  ccAttemptDisposeObject(int32_t handle);
+// allocate memory for the managed object's data; objects registered
+// with such memory have faster address to handle conversion
+extern char *ccAllocObjectData(size_t size);
+// free memory allocated by ccAllocObjectData, or by malloc
+extern void  ccFreeObjectData(const char *data);
 // translate between object handles and memory addresses
 extern int32_t ccGetObjectHandleFromAddress(const char *address);
 // TODO: not sure if it makes any sense whatsoever to use "const char*"
@@ -11,10 +11,13 @@
 // http://www.opensource.org/licenses/artistic-license-2.0.php
 //
 //=============================================================================
+#include <algorithm>
 #include <vector>
 #include <string.h>
+#include <stdlib.h>
 #include "ac/dynobj/managedobjectpool.h"
 #include "ac/dynobj/cc_dynamicarray.h" // globalDynamicArray, constants
+#include "ac/timer.h"
 #include "debug/out.h"
 #include "util/string_utils.h"               // fputstring, etc
 #include "script/cc_error.h"
@@ -27,6 +30,8 @@ const auto OBJECT_CACHE_MAGIC_NUMBER = 0xa30b;
 const auto SERIALIZE_BUFFER_SIZE = 10240;
 const auto GARBAGE_COLLECTION_INTERVAL = 1024;
 const auto RESERVED_SIZE = 2048;
+const size_t DATA_SLAB_SIZE = 64 * 1024;
+const size_t MIN_DATA_BLOCK_SIZE = 16; // smallest size class, the next ones are x2 each
 
 int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
     if (!o.isUsed()) { return 1; } // already removed
@@ -37,7 +42,13 @@ int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
     auto handle = o.handle;
     available_ids.push(o.handle);
 
-    handleByAddress.erase(o.addr);
+    // NOTE: the data could be freed by now, but the slab memory is still valid
+    auto *block = FindDataBlock(o.addr);
+    if (block && block->Handle == o.handle) {
+        block->Handle = 0;
+    } else {
+        handleByAddress.erase(o.addr);
+    }
     o = ManagedObject();
 
     ManagedObjectLog("Line %d Disposed managed object handle=%d", currentline, handle);
@@ -45,6 +56,21 @@ int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
     return 1;
 }
 
+void ManagedObjectPool::AddGCCandidate(ManagedObject &o) {
+    if (o.gcCandidate) { return; }
+    o.gcCandidate = true;
+    gcCandidates.push_back(o.handle);
+}
+
+void ManagedObjectPool::RegisterAddress(ManagedObject &o) {
+    auto *block = FindDataBlock(o.addr);
+    if (block && block->Handle == 0) {
+        block->Handle = o.handle;
+    } else {
+        handleByAddress.insert({o.addr, o.handle});
+    }
+}
+
 int32_t ManagedObjectPool::AddRef(int32_t handle) {
     if (handle < 0 || (size_t)handle >= objects.size()) { return 0; }
     auto & o = objects[handle];
@@ -74,6 +100,11 @@ int32_t ManagedObjectPool::SubRef(int32_t handle) {
     if (canBeDisposed) {
         CheckDispose(handle);
     }
+    // if the object was not disposed now, let garbage collector check it later
+    auto & o_after = objects[handle];
+    if (o_after.isUsed() && o_after.refCount < 1) {
+        AddGCCandidate(o_after);
+    }
     // object could be removed at this point, don't use any values.
     ManagedObjectLog("Line %d SubRef: handle=%d new refcount=%d canBeDisposed=%d", currentline, handle, newRefCount, canBeDisposed);
     return newRefCount;
@@ -81,6 +112,11 @@ int32_t ManagedObjectPool::SubRef(int32_t handle) {
 
 int32_t ManagedObjectPool::AddressToHandle(const char *addr) {
     if (addr == nullptr) { return 0; }
+    // if the object's data was allocated by the pool, then the handle is stored in the block
+    auto *block = FindDataBlock(addr);
+    if (block && block->Handle > 0 && objects[block->Handle].addr == addr) {
+        return block->Handle;
+    }
     auto it = handleByAddress.find(addr);
     if (it == handleByAddress.end()) { return 0; }
     return it->second;
@@ -107,10 +143,10 @@ ScriptValueType ManagedObjectPool::HandleToAddressAndManager(int32_t handle, voi
 
 int ManagedObjectPool::RemoveObject(const char *address) {
     if (address == nullptr) { return 0; }
-    auto it = handleByAddress.find(address);
-    if (it == handleByAddress.end()) { return 0; }
+    auto handle = AddressToHandle(address);
+    if (handle == 0) { return 0; }
 
-    auto & o = objects[it->second];
+    auto & o = objects[handle];
     return Remove(o, true);
 }
 
@@ -123,14 +159,35 @@ void ManagedObjectPool::RunGarbageCollectionIfAppropriate()
 
 void ManagedObjectPool::RunGarbageCollection()
 {
-    for (int i = 1; i < nextHandle; i++) {
-        auto & o = objects[i];
-        if (!o.isUsed()) { continue; }
-        if (o.refCount < 1) {
-            Remove(o);
+    const auto start = AGS_Clock::now();
+    // Take the current list out, as disposing objects may register new candidates
+    std::vector<int32_t> candidates;
+    candidates.swap(gcCandidates);
+    uint32_t disposed = 0;
+    for (auto handle : candidates) {
+        auto & o = objects[handle];
+        // skip removed objects, duplicates and handles reused by new objects
+        if (!o.isUsed() || !o.gcCandidate) { continue; }
+        o.gcCandidate = false;
+        if (o.refCount >= 1) { continue; } // referenced again
+        if (Remove(o)) {
+            disposed++;
+        } else {
+            // the manager refused to dispose the object; the object may not
+            // get any more SubRef calls, so keep it for the next collection
+            AddGCCandidate(o);
         }
     }
-    ManagedObjectLog("Ran garbage collection");
+
+    const int64_t pause_us = std::chrono::duration_cast<std::chrono::microseconds>(AGS_Clock::now() - start).count();
+    gcStats.NumRuns++;
+    gcStats.NumDisposed += disposed;
+    gcStats.LastDisposed = disposed;
+    gcStats.LastPauseUs = pause_us;
+    gcStats.MaxPauseUs = std::max(gcStats.MaxPauseUs, pause_us);
+    gcStats.TotalPauseUs += pause_us;
+    ManagedObjectLog("Ran garbage collection: checked %d, disposed %u, took %lld us",
+        (int)candidates.size(), disposed, (long long)pause_us);
 }
 
 int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback, bool plugin_object) 
@@ -152,7 +209,8 @@ int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback
 
     o = ManagedObject(plugin_object ? kScValPluginObject : kScValDynamicObject, handle, address, callback);
 
-    handleByAddress.insert({address, o.handle});
+    RegisterAddress(o);
+    AddGCCandidate(o); // new objects have no references yet
     objectCreationCounter++;
     ManagedObjectLog("Allocated managed object handle=%d, type=%s", handle, callback->GetType());
     return o.handle;
@@ -171,7 +229,8 @@ int ManagedObjectPool::AddUnserializedObject(const char *address, ICCDynamicObje
 
     o = ManagedObject(plugin_object ? kScValPluginObject : kScValDynamicObject, handle, address, callback);
 
-    handleByAddress.insert({address, o.handle});
+    RegisterAddress(o);
+    AddGCCandidate(o); // reference count is restored after, gc will test it
     ManagedObjectLog("Allocated unserialized managed object handle=%d, type=%s", o.handle, callback->GetType());
     return o.handle;
 }
@@ -306,13 +365,120 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
 
 // de-allocate all objects
 void ManagedObjectPool::reset() {
+    if (gcStats.NumRuns > 0) {
+        Debug::Printf(kDbgMsg_Info, "Managed objects GC: %u runs, %u objects disposed, total pause %lld us, longest %lld us",
+            gcStats.NumRuns, gcStats.NumDisposed, (long long)gcStats.TotalPauseUs, (long long)gcStats.MaxPauseUs);
+        gcStats = GCStats();
+    }
     for (int i = 1; i < nextHandle; i++) {
         auto & o = objects[i];
         if (!o.isUsed()) { continue; }
         Remove(o, true);
     }
     while (!available_ids.empty()) { available_ids.pop(); }
+    gcCandidates.clear();
     nextHandle = 1;
+    ReleaseFreeDataSlabs();
+}
+
+const ManagedObjectPool::DataSlab *ManagedObjectPool::FindDataSlab(const char *addr) const {
+    if (dataSlabs.empty()) { return nullptr; }
+    auto it = std::upper_bound(dataSlabs.begin(), dataSlabs.end(), addr,
+        [](const char *a, const DataSlab &slab) { return a < slab.Begin; });
+    if (it == dataSlabs.begin()) { return nullptr; }
+    --it;
+    return (addr < it->End) ? &*it : nullptr;
+}
+
+ManagedObjectPool::DataBlockHeader *ManagedObjectPool::FindDataBlock(const char *addr) const {
+    auto *slab = FindDataSlab(addr);
+    if (!slab) { return nullptr; }
+    const size_t block_index = (addr - slab->Begin) / slab->BlockSize;
+    return (DataBlockHeader*)(slab->Begin + block_index * slab->BlockSize);
+}
+
+void ManagedObjectPool::AddDataSlab(size_t size_class) {
+    const size_t block_size = sizeof(DataBlockHeader) + (MIN_DATA_BLOCK_SIZE << size_class);
+    const size_t block_count = std::max<size_t>(DATA_SLAB_SIZE / block_size, 1);
+    DataSlab slab;
+    slab.Mem.reset(new char[block_count * block_size]);
+    slab.Begin = slab.Mem.get();
+    slab.End = slab.Begin + block_count * block_size;
+    slab.BlockSize = block_size;
+    slab.SizeClass = size_class;
+    // push blocks in reverse, so that they are allocated in the memory order
+    auto &free_list = freeDataBlocks[size_class];
+    for (size_t i = block_count; i > 0; --i) {
+        free_list.push_back(slab.Mem.get() + (i - 1) * block_size);
+    }
+    auto it = std::upper_bound(dataSlabs.begin(), dataSlabs.end(), slab.Begin,
+        [](const char *a, const DataSlab &sl) { return a < sl.Begin; });
+    dataSlabs.insert(it, std::move(slab));
+}
+
+void ManagedObjectPool::ReleaseFreeDataSlabs() {
+    // count the free blocks in each slab
+    std::vector<size_t> free_count(dataSlabs.size());
+    for (const auto &free_list : freeDataBlocks) {
+        for (const char *block : free_list) {
+            free_count[FindDataSlab(block) - &dataSlabs.front()]++;
+        }
+    }
+    std::vector<bool> release(dataSlabs.size());
+    bool release_any = false;
+    for (size_t i = 0; i < dataSlabs.size(); ++i) {
+        const auto &slab = dataSlabs[i];
+        release[i] = free_count[i] == (size_t)(slab.End - slab.Begin) / slab.BlockSize;
+        release_any |= release[i];
+    }
+    if (!release_any) { return; }
+
+    // the slabs which have data in use (if any got leaked) are kept
+    for (auto &free_list : freeDataBlocks) {
+        free_list.erase(std::remove_if(free_list.begin(), free_list.end(),
+            [this, &release](const char *block) { return release[FindDataSlab(block) - &dataSlabs.front()]; }),
+            free_list.end());
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < dataSlabs.size(); ++i) {
+        if (!release[i]) {
+            dataSlabs[kept++] = std::move(dataSlabs[i]);
+        }
+    }
+    dataSlabs.resize(kept);
+}
+
+char *ManagedObjectPool::AllocData(size_t size) {
+    size_t size_class = 0;
+    for (size_t class_size = MIN_DATA_BLOCK_SIZE; class_size < size; class_size <<= 1) {
+        size_class++;
+    }
+    if (size_class >= NumDataSizeClasses) {
+        return (char*)malloc(size);
+    }
+
+    auto &free_list = freeDataBlocks[size_class];
+    if (free_list.empty()) {
+        AddDataSlab(size_class);
+    }
+    char *block = free_list.back();
+    free_list.pop_back();
+    DataBlockHeader *hdr = (DataBlockHeader*)block;
+    hdr->Handle = 0;
+    hdr->Reserved = 0;
+    return block + sizeof(DataBlockHeader);
+}
+
+void ManagedObjectPool::FreeData(const char *data) {
+    if (!data) { return; }
+    auto *slab = FindDataSlab(data);
+    if (!slab) {
+        free(const_cast<char*>(data));
+        return;
+    }
+    DataBlockHeader *hdr = FindDataBlock(data);
+    hdr->Handle = 0;
+    freeDataBlocks[slab->SizeClass].push_back((char*)hdr);
 }
 
 ManagedObjectPool::ManagedObjectPool() : objectCreationCounter(0), nextHandle(1), available_ids(), objects(RESERVED_SIZE, ManagedObject()), handleByAddress() {
@@ -15,6 +15,7 @@
 #ifndef __CC_MANAGEDOBJECTPOOL_H
 #define __CC_MANAGEDOBJECTPOOL_H
 
+#include <memory>
 #include <vector>
 #include <queue>
 #include <unordered_map>
@@ -36,28 +37,72 @@ private:
         const char *addr;
         ICCDynamicObject *callback;
         int refCount;
+        bool gcCandidate; // is registered in the gc candidates list
 
         bool isUsed() const { return obj_type != kScValUndefined; }
 
         ManagedObject() 
-            : obj_type(kScValUndefined), handle(0), addr(nullptr), callback(nullptr), refCount(0) {}
+            : obj_type(kScValUndefined), handle(0), addr(nullptr), callback(nullptr), refCount(0), gcCandidate(false) {}
         ManagedObject(ScriptValueType obj_type, int32_t handle, const char *addr, ICCDynamicObject * callback) 
-            : obj_type(obj_type), handle(handle), addr(addr), callback(callback), refCount(0) {}
+            : obj_type(obj_type), handle(handle), addr(addr), callback(callback), refCount(0), gcCandidate(false) {}
     };
 
+    // Slab of equally sized memory blocks, used to allocate managed objects data.
+    // Each block begins with a header that stores the handle of the object
+    // registered with that data, which lets find a handle without hashing.
+    struct DataSlab {
+        std::unique_ptr<char[]> Mem;
+        const char *Begin;
+        const char *End;
+        size_t  BlockSize;  // full block size, including header
+        size_t  SizeClass;
+    };
+    struct DataBlockHeader {
+        int32_t Handle;     // handle of the registered object, or 0
+        int32_t Reserved;   // keeps the data aligned by 8 bytes
+    };
+    static const size_t NumDataSizeClasses = 7;
+
     int objectCreationCounter;  // used to do garbage collection every so often
 
     int32_t nextHandle {}; // TODO: manage nextHandle's going over INT32_MAX !
     std::queue<int32_t> available_ids;
     std::vector<ManagedObject> objects;
     std::unordered_map<const char *, int32_t> handleByAddress;
+    // Handles of objects which had zero references at some point and were
+    // not disposed right away; only these are checked by garbage collection,
+    // so that its cost depends on the amount of garbage and not pool size.
+    std::vector<int32_t> gcCandidates;
+    // Data slabs, sorted by the memory address
+    std::vector<DataSlab> dataSlabs;
+    std::vector<char*> freeDataBlocks[NumDataSizeClasses];
 
     void Init(int32_t theHandle, const char *theAddress, ICCDynamicObject *theCallback, ScriptValueType objType);
     int Remove(ManagedObject &o, bool force = false); 
+    void AddGCCandidate(ManagedObject &o);
+    // Associates object's address with its handle
+    void RegisterAddress(ManagedObject &o);
+    // Finds the slab which contains given address, returns null if there's none
+    const DataSlab *FindDataSlab(const char *addr) const;
+    // Finds the header of the slab block which contains given address;
+    // returns null if the address is not in the memory allocated by the pool
+    DataBlockHeader *FindDataBlock(const char *addr) const;
+    void AddDataSlab(size_t size_class);
+    // Deallocates the slabs which have no data in use
+    void ReleaseFreeDataSlabs();
 
     void RunGarbageCollection();
 
 public:
+    // Garbage collection statistics
+    struct GCStats {
+        uint32_t NumRuns {};        // number of collections run
+        uint32_t NumDisposed {};    // total number of objects disposed by gc
+        uint32_t LastDisposed {};   // objects disposed by the last collection
+        int64_t  LastPauseUs {};    // duration of the last collection, in microseconds
+        int64_t  MaxPauseUs {};     // longest collection
+        int64_t  TotalPauseUs {};   // total time spent collecting
+    };
 
     int32_t AddRef(int32_t handle);
     int CheckDispose(int32_t handle);
@@ -72,9 +117,21 @@ public:
     void WriteToDisk(Common::Stream *out);
     int ReadFromDisk(Common::Stream *in, ICCObjectReader *reader);
     void reset();
+    // Allocates memory for the managed object data. If the object is then
+    // registered with this address, or an address inside this buffer,
+    // its handle will be stored along with the data, making lookups faster.
+    // Buffers which are too large are allocated using malloc.
+    char *AllocData(size_t size);
+    // Frees the memory allocated by AllocData; accepts buffers allocated
+    // using malloc too, in which case the memory is deallocated using free.
+    void FreeData(const char *data);
+    const GCStats &GetGCStats() const { return gcStats; }
     ManagedObjectPool();
 
     const char* disableDisposeForObject {nullptr};
+
+private:
+    GCStats gcStats;
 };
 
 extern ManagedObjectPool pool;
@@ -24,7 +24,7 @@ DynObjectRef ScriptString::CreateString(const char *fromText) {
 int ScriptString::Dispose(const char *address, bool force) {
     // always dispose
     if (text) {
-        free(text);
+        ccFreeObjectData(text);
         text = nullptr;
     }
     delete this;
@@ -51,7 +51,7 @@ int ScriptString::Serialize(const char *address, char *buffer, int bufsize) {
 void ScriptString::Unserialize(int index, const char *serializedData, int dataSize) {
     StartUnserialize(serializedData, dataSize);
     int textsize = UnserializeInt();
-    text = (char*)malloc(textsize + 1);
+    text = ccAllocObjectData(textsize + 1);
     strcpy(text, &serializedData[bytesSoFar]);
     ccRegisterUnserializedObject(index, text, this);
 }
@@ -61,6 +61,6 @@ ScriptString::ScriptString() {
 }
 
 ScriptString::ScriptString(const char *fromText) {
-    text = (char*)malloc(strlen(fromText) + 1);
+    text = ccAllocObjectData(strlen(fromText) + 1);
     strcpy(text, fromText);
 }
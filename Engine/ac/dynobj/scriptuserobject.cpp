@@ -29,7 +29,17 @@ ScriptUserObject::ScriptUserObject()
 
 ScriptUserObject::~ScriptUserObject()
 {
-    delete [] _data;
+    ccFreeObjectData(_data);
+}
+
+void *ScriptUserObject::operator new(size_t size)
+{
+    return ccAllocObjectData(size);
+}
+
+void ScriptUserObject::operator delete(void *ptr)
+{
+    ccFreeObjectData((const char*)ptr);
 }
 
 /* static */ ScriptUserObject *ScriptUserObject::CreateManaged(size_t size)
@@ -42,13 +52,13 @@ ScriptUserObject::~ScriptUserObject()
 
 void ScriptUserObject::Create(const char *data, size_t size)
 {
-    delete [] _data;
+    ccFreeObjectData(_data);
     _data = nullptr;
 
     _size = size;
     if (_size > 0)
     {
-        _data = new char[size];
+        _data = ccAllocObjectData(size);
         if (data)
             memcpy(_data, data, _size);
         else
@@ -29,6 +29,11 @@ protected:
     virtual ~ScriptUserObject();
 
 public:
+    // Objects are allocated in the managed pool's memory, which makes
+    // finding their handles faster
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
     static ScriptUserObject *CreateManaged(size_t size);
     void            Create(const char *data, size_t size);
 
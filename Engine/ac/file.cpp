@@ -153,7 +153,7 @@ const char* File_ReadStringBack(sc_File *fil) {
   if ((lle >= 20000) || (lle < 1))
     quit("!File.ReadStringBack: file was not written by WriteString");
 
-  char *retVal = (char*)malloc(lle);
+  char *retVal = ccAllocObjectData(lle);
   in->Read(retVal, lle);
 
   return CreateNewScriptString(retVal, false);
@@ -69,6 +69,7 @@
 #include "game/savegame.h"
 #include "game/savegame_components.h"
 #include "game/savegame_internal.h"
+#include "game/savestate.h"
 #include "gui/animatingguibutton.h"
 #include "gfx/bitmap.h"
 #include "gfx/graphicsdriver.h"
@@ -87,6 +88,7 @@
 #include "util/alignedstream.h"
 #include "util/directory.h"
 #include "util/filestream.h" // TODO: needed only because plugins expect file handle
+#include "util/memorystream.h"
 #include "util/path.h"
 #include "util/string_utils.h"
 #include "ac/keycode.h"
@@ -156,6 +158,8 @@ float direction_ratio = 1.0;
 
 // initially size 1, this will be increased by the initFile function
 SpriteCache spriteset(game.SpriteInfos);
+// Game states saved in memory
+SaveStateRing savestates;
 int proper_exit=0,our_eip=0;
 
 std::vector<GUIMain> guis;
@@ -307,7 +311,10 @@ int Game_GetMODPattern() {
         return -1;
     AudioChannelsLock lock;
     auto* music_ch = lock.GetChannelIfPlaying(SCHAN_MUSIC);
-    return music_ch ? music_ch->get_pos() : -1;
+    if (!music_ch)
+        return -1;
+    wait_clip_seek(music_ch);
+    return music_ch->get_pos();
 }
 
 //=============================================================================
@@ -550,6 +557,8 @@ void unload_game_file()
 {
     close_translation();
 
+    savestates.Clear();
+
     play.FreeViewportsAndCameras();
 
     characterScriptObjNames.clear();
@@ -954,6 +963,39 @@ void Game_SetDirectionRatio(float ratio)
     if (ratio > 0) direction_ratio = ratio;
 }
 
+void Game_SaveState()
+{
+    if (savestates.GetMaxCount() == 0)
+    {
+        debug_script_warn("Game.SaveState: game states are disabled in the engine config");
+        return;
+    }
+    save_game_state();
+}
+
+void Game_RestoreState(int index)
+{
+    if (displayed_room < 0)
+        quit("!Game.RestoreState: a game cannot be restored from within game_start");
+    if (index < 0 || (size_t)index >= savestates.GetCount())
+    {
+        debug_script_warn("Game.RestoreState: there's no game state %d", index);
+        return;
+    }
+
+    can_run_delayed_command();
+    if (inside_script) {
+        curscript->queue_action(ePSARestoreState, index, "Game.RestoreState");
+        return;
+    }
+    try_restore_game_state(index);
+}
+
+int Game_GetSaveStateCount()
+{
+    return savestates.GetCount();
+}
+
 //=============================================================================
 
 // save game functions
@@ -1129,31 +1171,24 @@ void save_game(int slotn, const char*descript) {
     // Screenshot
     create_savegame_screenshot(screenShot);
 
-    Common::PStream out = StartSavegame(nametouse, descript, screenShot);
-    if (out == nullptr)
-        quit("save_game: unable to open savegame file for writing");
-
     update_polled_stuff_if_runtime();
 
-    // Actual dynamic game data is saved here
-    SaveGameState(out);
+    // Actual dynamic game data is serialized here
+    SavegameBuffer svg;
+    SaveGameState(svg, descript, screenShot, usetup.CompressSaves ? kSvgCompress_LZ4 : kSvgCompress_None);
 
     if (screenShot != nullptr)
     {
-        int screenShotOffset = out->GetPosition() - sizeof(RICH_GAME_MEDIA_HEADER);
-        int screenShotSize = write_screen_shot_for_vista(out.get(), screenShot);
-
-        update_polled_stuff_if_runtime();
-
-        out.reset(Common::File::OpenFile(nametouse, Common::kFile_Open, Common::kFile_ReadWrite));
-        out->Seek(12, kSeekBegin);
-        out->WriteInt32(screenShotOffset);
-        out->Seek(4);
-        out->WriteInt32(screenShotSize);
+        MemoryStream image;
+        write_screen_shot_for_vista(&image, screenShot);
+        image.ReleaseBuffer(svg.RichMediaImage);
+        delete screenShot;
     }
 
-    if (screenShot != nullptr)
-        delete screenShot;
+    update_polled_stuff_if_runtime();
+
+    if (!WriteSavegame(nametouse, std::move(svg), usetup.AsyncSaves))
+        quit("save_game: unable to open savegame file for writing");
 }
 
 HSaveError restore_game_head_dynamic_values(Stream *in, RestoredData &r_data)
@@ -1769,6 +1804,69 @@ bool try_restore_save(const Common::String &path, int slot)
     return true;
 }
 
+void set_savestate_options(size_t max_count, bool use_delta)
+{
+    savestates.SetOptions(max_count, use_delta);
+}
+
+void save_game_state()
+{
+    can_run_delayed_command();
+
+    if (inside_script) {
+        curscript->queue_action(ePSASaveState, 0, "Game.SaveState");
+        return;
+    }
+
+    if (savestates.GetMaxCount() == 0)
+        return;
+    std::vector<uint8_t> data;
+    SaveGameData(data);
+    savestates.Push(std::move(data));
+}
+
+HSaveError load_game_state(int index, bool &data_overwritten)
+{
+    data_overwritten = false;
+    gameHasBeenRestored++;
+
+    oldeip = our_eip;
+    our_eip = 2050;
+
+    std::vector<uint8_t> data;
+    if (!savestates.Get(index, data))
+        return new SavegameError(kSvgErr_InconsistentData, String::FromFormat("Failed to get savestate %d.", index));
+
+    HSaveError err = RestoreGameState(PStream(new MemoryStream(std::move(data), Common::kFile_Read)), kSvgVersion_Current);
+    data_overwritten = true;
+    if (!err)
+        return err;
+    our_eip = oldeip;
+
+    // ensure keyboard buffer is clean
+    ags_clear_input_buffer();
+    // call "After Restore" event callback; there's no save slot
+    run_on_event(GE_RESTORE_GAME, RuntimeScriptValue().SetInt32(-1));
+    return HSaveError::None();
+}
+
+bool try_restore_game_state(int index)
+{
+    bool data_overwritten;
+    HSaveError err = load_game_state(index, data_overwritten);
+    if (!err)
+    {
+        String error = String::FromFormat("Unable to restore the game state.\n%s",
+            err->FullMessage().GetCStr());
+        if (data_overwritten)
+            quitprintf(error);
+        else
+            Display(error);
+        return false;
+    }
+    return true;
+}
+
 bool is_in_cutscene()
 {
     return play.in_cutscene > 0;
@@ -2428,6 +2526,21 @@ RuntimeScriptValue Sc_Game_SetDirectionRatio(const RuntimeScriptValue *params, i
     API_SCALL_VOID_PFLOAT(Game_SetDirectionRatio);
 }
 
+RuntimeScriptValue Sc_Game_SaveState(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_VOID(Game_SaveState);
+}
+
+RuntimeScriptValue Sc_Game_RestoreState(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_VOID_PINT(Game_RestoreState);
+}
+
+RuntimeScriptValue Sc_Game_GetSaveStateCount(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_INT(Game_GetSaveStateCount);
+}
+
 void RegisterGameAPI()
 {
     ccAddExternalStaticFunction("Game::IsAudioPlaying^1",                       Sc_Game_IsAudioPlaying);
@@ -2487,6 +2600,10 @@ void RegisterGameAPI()
 
     ccAddExternalStaticFunction("Game::SetDirectionRatio",                      Sc_Game_SetDirectionRatio);
 
+    ccAddExternalStaticFunction("Game::SaveState^0",                            Sc_Game_SaveState);
+    ccAddExternalStaticFunction("Game::RestoreState^1",                         Sc_Game_RestoreState);
+    ccAddExternalStaticFunction("Game::get_SaveStateCount",                     Sc_Game_GetSaveStateCount);
+
     /* ----------------------- Registering unsafe exports for plugins -----------------------*/
 
     ccAddExternalFunctionForPlugin("Game::IsAudioPlaying^1",                       (void*)Game_IsAudioPlaying);
@@ -2535,6 +2652,9 @@ void RegisterGameAPI()
     ccAddExternalFunctionForPlugin("Game::get_TranslationFilename",                (void*)Game_GetTranslationFilename);
     ccAddExternalFunctionForPlugin("Game::get_ViewCount",                          (void*)Game_GetViewCount);
     ccAddExternalFunctionForPlugin("Game::PlayVoiceClip",                          (void*)PlayVoiceClip);
+    ccAddExternalFunctionForPlugin("Game::SaveState^0",                            (void*)Game_SaveState);
+    ccAddExternalFunctionForPlugin("Game::RestoreState^1",                         (void*)Game_RestoreState);
+    ccAddExternalFunctionForPlugin("Game::get_SaveStateCount",                     (void*)Game_GetSaveStateCount);
 }
 
 void RegisterStaticObjects()
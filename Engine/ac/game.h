@@ -30,6 +30,9 @@ using namespace AGS; // FIXME later
 #define RAGMODE_PRESERVEGLOBALINT 1
 #define RAGMODE_LOADNOW 0x8000000  // just to make sure it's non-zero
 
+// Default number of game states kept in memory
+#define DEFAULTSAVESTATES 8
+
 // Game parameter constants for backward-compatibility functions
 #define GP_SPRITEWIDTH   1
 #define GP_SPRITEHEIGHT  2
@@ -126,6 +129,9 @@ const char* Game_GetTranslationFilename();
 int Game_ChangeTranslation(const char *newFilename);
 
 void Game_SetDirectionRatio(float ratio);
+void Game_SaveState();
+void Game_RestoreState(int index);
+int  Game_GetSaveStateCount();
 
 //=============================================================================
 
@@ -149,6 +155,15 @@ bool read_savedgame_screenshot(const Common::String &savedgame, int &want_shot);
 // too late, when the game data was already overwritten, shuts engine down.
 bool try_restore_save(int slot);
 bool try_restore_save(const Common::String &path, int slot);
+// Sets the number of game states kept in memory, and whether the older
+// states are stored as the differences from the newer ones
+void set_savestate_options(size_t max_count, bool use_delta);
+// Saves the game state into memory, dropping the oldest state if there are
+// too many of them
+void save_game_state();
+// Tries to restore game state from memory, where 0 is the latest state;
+// behaves same as try_restore_save on error
+bool try_restore_game_state(int index);
 void serialize_bitmap(const Common::Bitmap *thispic, Common::Stream *out);
 // On Windows we could just use IIDFromString but this is platform-independant
 void convert_guid_from_text_to_binary(const char *guidText, unsigned char *buffer);
@@ -72,6 +72,10 @@ struct GameSetup {
     MouseSpeedDef mouse_speed_def;
     bool  RenderAtScreenRes; // render sprites at screen resolution, as opposed to native one
     int   Supersampling;
+    bool  PresentThread; // display rendered frames on a separate thread (software renderer)
+    bool  HierarchicalPathfinder; // search long routes on the graph of walkable area clusters
+    bool  CompressSaves; // compress game data in savegames
+    bool  AsyncSaves; // write savegames to disk on a separate thread
 
     ScreenSetup Screen;
 
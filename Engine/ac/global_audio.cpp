@@ -265,7 +265,7 @@ void SeekMODPattern(int patnum) {
     AudioChannelsLock lock;
     auto* ch = lock.GetChannelIfPlaying(SCHAN_MUSIC);
     if (ch) {
-        ch->seek (patnum);
+        seek_clip(ch, patnum);
         debug_script_log("Seek MOD/XM to pattern %d", patnum);
     }
 }
@@ -277,9 +277,9 @@ void SeekMP3PosMillis (int posn) {
     auto *mus_ch = lock.GetChannel(SCHAN_MUSIC);
     auto *cf_ch = (crossFading > 0) ? lock.GetChannel(crossFading) : nullptr;
     if (cf_ch)
-        cf_ch->seek(posn);
+        seek_clip(cf_ch, posn);
     else if (mus_ch)
-        mus_ch->seek(posn);
+        seek_clip(mus_ch, posn);
 }
 
 int GetMP3PosMillis () {
@@ -293,6 +293,7 @@ int GetMP3PosMillis () {
     AudioChannelsLock lock;
     auto* ch = lock.GetChannelIfPlaying(SCHAN_MUSIC);
     if (ch) {
+        wait_clip_seek(ch);
         int result = ch->get_pos_ms();
         if (result >= 0)
             return result;
@@ -439,14 +440,14 @@ void PlaySilentMIDI (int mnum) {
     {
         quitprintf("!PlaySilentMIDI: failed to load aMusic%d", mnum);
     }
-    AudioChannelsLock lock;
-    lock.SetChannel(play.silent_midi_channel, clip);
     if (!clip->play()) {
         clip->destroy();
         delete clip;
         clip = nullptr;
         quitprintf("!PlaySilentMIDI: failed to play aMusic%d", mnum);
     }
+    AudioChannelsLock lock;
+    lock.SetChannel(play.silent_midi_channel, clip);
     clip->set_volume_percent(0);
 }
 
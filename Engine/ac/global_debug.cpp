@@ -28,6 +28,7 @@
 #include "ac/sys_events.h"
 #include "ac/tree_map.h"
 #include "ac/walkablearea.h"
+#include "ac/dynobj/managedobjectpool.h"
 #include "gfx/gfxfilter.h"
 #include "gui/guidialog.h"
 #include "script/cc_options.h"
@@ -72,6 +73,9 @@ String GetRuntimeInfo()
         gfxDriver->GetDriverName(), filter->GetInfo().Name.GetCStr(),
         render_frame.GetWidth(), render_frame.GetHeight(),
         spriteset.GetCacheSize() / 1024, spriteset.GetMaxCacheSize() / 1024, spriteset.GetLockedSize() / 1024);
+    const ManagedObjectPool::GCStats &gc_stats = pool.GetGCStats();
+    runtimeInfo.Append(String::FromFormat("[Managed objects GC: %u runs, last pause %lld us (longest %lld us)",
+        gc_stats.NumRuns, (long long)gc_stats.LastPauseUs, (long long)gc_stats.MaxPauseUs));
     if (play.separate_music_lib)
         runtimeInfo.Append("[AUDIO.VOX enabled");
     if (play.want_speech >= 1)
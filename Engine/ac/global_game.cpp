@@ -45,6 +45,7 @@
 #include "ac/system.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "game/savegame.h"
 #include "gui/guidialog.h"
 #include "main/engine.h"
 #include "main/game_start.h"
@@ -89,7 +90,7 @@ extern int psp_gfx_renderer;
 
 void GiveScore(int amnt) 
 {
-    guis_need_update = 1;
+    mark_macro_labels_changed();
     play.score += amnt;
 
     if ((amnt > 0) && (play.score_sound >= 0))
@@ -120,6 +121,7 @@ void RestoreGameSlot(int slnum) {
 }
 
 void DeleteSaveSlot (int slnum) {
+    AGS::Engine::WaitForSavegameWrite();
     String nametouse;
     nametouse = get_save_game_path(slnum);
     ::remove (nametouse);
@@ -544,13 +546,13 @@ void GetLocationName(int xxx,int yyy,char*tempo) {
         int mover = GetInvAt (xxx, yyy);
         if (mover > 0) {
             if (play.get_loc_name_last_time != 1000 + mover)
-                guis_need_update = 1;
+                mark_macro_labels_changed();
             play.get_loc_name_last_time = 1000 + mover;
             strcpy(tempo,get_translation(game.invinfo[mover].name));
         }
         else if ((play.get_loc_name_last_time > 1000) && (play.get_loc_name_last_time < 1000 + MAX_INV)) {
             // no longer selecting an item
-            guis_need_update = 1;
+            mark_macro_labels_changed();
             play.get_loc_name_last_time = -1;
         }
         return;
@@ -569,7 +571,7 @@ void GetLocationName(int xxx,int yyy,char*tempo) {
     if (loctype == 0) {
         if (play.get_loc_name_last_time != 0) {
             play.get_loc_name_last_time = 0;
-            guis_need_update = 1;
+            mark_macro_labels_changed();
         }
         return;
     }
@@ -579,7 +581,7 @@ void GetLocationName(int xxx,int yyy,char*tempo) {
         onhs = getloctype_index;
         strcpy(tempo,get_translation(game.chars[onhs].name));
         if (play.get_loc_name_last_time != 2000+onhs)
-            guis_need_update = 1;
+            mark_macro_labels_changed();
         play.get_loc_name_last_time = 2000+onhs;
         return;
     }
@@ -588,14 +590,14 @@ void GetLocationName(int xxx,int yyy,char*tempo) {
         aa = getloctype_index;
         strcpy(tempo,get_translation(thisroom.Objects[aa].Name));
         if (play.get_loc_name_last_time != 3000+aa)
-            guis_need_update = 1;
+            mark_macro_labels_changed();
         play.get_loc_name_last_time = 3000+aa;
         return;
     }
     onhs = getloctype_index;
     if (onhs>0) strcpy(tempo,get_translation(thisroom.Hotspots[onhs].Name));
     if (play.get_loc_name_last_time != onhs)
-        guis_need_update = 1;
+        mark_macro_labels_changed();
     play.get_loc_name_last_time = onhs;
 }
 
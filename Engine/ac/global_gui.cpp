@@ -64,7 +64,7 @@ void InterfaceOn(int ifn) {
     debug_script_log("GUIOn(%d) ignored (already on)", ifn);
     return;
   }
-  guis_need_update = 1;
+  guis[ifn].MarkChanged();
   guis[ifn].SetVisible(true);
   debug_script_log("GUI %d turned on", ifn);
   // modal interface
@@ -88,7 +88,7 @@ void InterfaceOff(int ifn) {
     guis[ifn].MouseOverCtrl = -1;
   }
   guis[ifn].OnControlPositionChanged();
-  guis_need_update = 1;
+  guis[ifn].MarkChanged();
   // modal interface
   if (guis[ifn].PopupStyle==kGUIPopupModal) UnPauseGame();
 }
@@ -224,6 +224,7 @@ void AnimateObjectImpl(int obn, int loopn, int spdd, int rept, int direction, in
 
     debug_script_log("Obj %d start anim view %d loop %d, speed %d, repeat %d, frame %d", obn, objs[obn].view+1, loopn, spdd, rept, sframe);
 
+    prefetch_view_loop(objs[obn].view, loopn);
     objs[obn].cycling = rept+1 + (direction * 10);
     objs[obn].loop=loopn;
     // reverse animation starts at the *previous frame*
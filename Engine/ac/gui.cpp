@@ -37,6 +37,7 @@
 #include "device/mousew32.h"
 #include "gfx/gfxfilter.h"
 #include "gui/guibutton.h"
+#include "gui/guilabel.h"
 #include "gui/guimain.h"
 #include "script/script.h"
 #include "script/script_runtime.h"
@@ -133,7 +134,7 @@ void GUI_SetSize(ScriptGUI *sgui, int widd, int hitt) {
   
   recreate_guibg_image(tehgui);
 
-  guis_need_update = 1;
+  tehgui->MarkChanged();
 }
 
 int GUI_GetWidth(ScriptGUI *sgui) {
@@ -219,7 +220,7 @@ void GUI_Centre(ScriptGUI *sgui) {
 void GUI_SetBackgroundGraphic(ScriptGUI *tehgui, int slotn) {
   if (guis[tehgui->id].BgImage != slotn) {
     guis[tehgui->id].BgImage = slotn;
-    guis_need_update = 1;
+    guis[tehgui->id].MarkChanged();
   }
 }
 
@@ -234,7 +235,7 @@ void GUI_SetBackgroundColor(ScriptGUI *tehgui, int newcol)
     if (guis[tehgui->id].BgColor != newcol)
     {
         guis[tehgui->id].BgColor = newcol;
-        guis_need_update = 1;
+        guis[tehgui->id].MarkChanged();
     }
 }
 
@@ -250,7 +251,7 @@ void GUI_SetBorderColor(ScriptGUI *tehgui, int newcol)
     if (guis[tehgui->id].FgColor != newcol)
     {
         guis[tehgui->id].FgColor = newcol;
-        guis_need_update = 1;
+        guis[tehgui->id].MarkChanged();
     }
 }
 
@@ -268,7 +269,7 @@ void GUI_SetTextColor(ScriptGUI *tehgui, int newcol)
     if (guis[tehgui->id].FgColor != newcol)
     {
         guis[tehgui->id].FgColor = newcol;
-        guis_need_update = 1;
+        guis[tehgui->id].MarkChanged();
     }
 }
 
@@ -334,7 +335,7 @@ void remove_popup_interface(int ifacenum) {
         set_default_cursor();
 
     if (ifacenum==mouse_on_iface) mouse_on_iface=-1;
-    guis_need_update = 1;
+    guis[ifacenum].MarkChanged();
 }
 
 void process_interface_click(int ifce, int btn, int mbut) {
@@ -384,6 +385,28 @@ void process_interface_click(int ifce, int btn, int mbut) {
 }
 
 
+void mark_macro_labels_changed() {
+    // only the labels may display the macros, so redraw the GUIs which have them
+    for (int i = 0; i < numguilabels; ++i) {
+        if (guilabels[i].GetText().FindChar('@') != -1)
+            guilabels[i].NotifyParentChanged();
+    }
+}
+
+void mark_gui_sprite_changed(int sprite) {
+    for (int i = 0; i < game.numgui; ++i) {
+        if (guis[i].BgImage == sprite)
+            guis[i].MarkChanged();
+    }
+    for (int i = 0; i < numguibuts; ++i) {
+        if (guibuts[i].IsDeleted())
+            continue;
+        if ((guibuts[i].Image == sprite) || (guibuts[i].CurrentImage == sprite) ||
+            (guibuts[i].MouseOverImage == sprite) || (guibuts[i].PushedImage == sprite))
+            guibuts[i].NotifyParentChanged();
+    }
+}
+
 void replace_macro_tokens(const char *text, String &fixed_text) {
     const char*curptr=&text[0];
     char tmpm[3];
@@ -587,6 +610,7 @@ void recreate_guibg_image(GUIMain *tehgui)
     gfxDriver->DestroyDDB(guibgbmp[ifn]);
     guibgbmp[ifn] = nullptr;
   }
+  tehgui->MarkChanged();
 }
 
 extern int is_complete_overlay;
@@ -621,7 +645,7 @@ int gui_on_mouse_move()
 
             if (mousey < guis[guin].PopupAtMouseY) {
                 set_mouse_cursor(CURS_ARROW);
-                guis[guin].SetConceal(false); guis_need_update = 1;
+                guis[guin].SetConceal(false); guis[guin].MarkChanged();
                 ifacepopped=guin; PauseGame();
                 break;
             }
@@ -65,6 +65,10 @@ ScriptGUI *GetGUIAtLocation(int xx, int yy);
 void	remove_popup_interface(int ifacenum);
 void	process_interface_click(int ifce, int btn, int mbut);
 void	replace_macro_tokens(const char *text, AGS::Common::String &fixed_text);
+// Marks the GUIs that have labels with macro tokens (like @OVERHOTSPOT@) for redraw
+void	mark_macro_labels_changed();
+// Marks the GUIs that display the given sprite, as a background or on buttons, for redraw
+void	mark_gui_sprite_changed(int sprite);
 void	update_gui_zorder();
 void	export_gui_controls(int ee);
 void	unexport_gui_controls(int ee);
@@ -35,7 +35,7 @@ int ListBox_AddItem(GUIListBox *lbb, const char *text) {
   if (lbb->AddItem(text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->NotifyParentChanged();
   return 1;
 }
 
@@ -43,13 +43,13 @@ int ListBox_InsertItemAt(GUIListBox *lbb, int index, const char *text) {
   if (lbb->InsertItem(index, text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->NotifyParentChanged();
   return 1;
 }
 
 void ListBox_Clear(GUIListBox *listbox) {
   listbox->Clear();
-  guis_need_update = 1;
+  listbox->NotifyParentChanged();
 }
 
 void FillDirList(std::set<String> &files, const String &path)
@@ -65,7 +65,7 @@ void FillDirList(std::set<String> &files, const String &path)
 
 void ListBox_FillDirList(GUIListBox *listbox, const char *filemask) {
   listbox->Clear();
-  guis_need_update = 1;
+  listbox->NotifyParentChanged();
 
   ResolvedPath rp;
   if (!ResolveScriptPath(filemask, true, rp))
@@ -144,7 +144,7 @@ int ListBox_FillSaveGameList(GUIListBox *listbox) {
     play.filenumbers[nn] = listbox->SavedGameIndex[nn];
   }
 
-  guis_need_update = 1;
+  listbox->NotifyParentChanged();
   listbox->SetSvgIndex(true);
 
   if (numsaves >= MAXSAVEGAMES)
@@ -187,7 +187,7 @@ void ListBox_SetItemText(GUIListBox *listbox, int index, const char *newtext) {
 
   if (strcmp(listbox->Items[index], newtext)) {
     listbox->SetItemText(index, newtext);
-    guis_need_update = 1;
+    listbox->NotifyParentChanged();
   }
 }
 
@@ -197,7 +197,7 @@ void ListBox_RemoveItem(GUIListBox *listbox, int itemIndex) {
     quit("!ListBoxRemove: invalid listindex specified");
 
   listbox->RemoveItem(itemIndex);
-  guis_need_update = 1;
+  listbox->NotifyParentChanged();
 }
 
 int ListBox_GetItemCount(GUIListBox *listbox) {
@@ -215,7 +215,7 @@ void ListBox_SetFont(GUIListBox *listbox, int newfont) {
 
   if (newfont != listbox->Font) {
     listbox->SetFont(newfont);
-    guis_need_update = 1;
+    listbox->NotifyParentChanged();
   }
 
 }
@@ -228,7 +228,7 @@ void ListBox_SetShowBorder(GUIListBox *listbox, bool newValue) {
     if (listbox->IsBorderShown() != newValue)
     {
         listbox->SetShowBorder(newValue);
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -240,7 +240,7 @@ void ListBox_SetShowScrollArrows(GUIListBox *listbox, bool newValue) {
     if (listbox->AreArrowsShown() != newValue)
     {
         listbox->SetShowArrows(newValue);
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -267,7 +267,7 @@ int ListBox_GetSelectedBackColor(GUIListBox *listbox) {
 void ListBox_SetSelectedBackColor(GUIListBox *listbox, int colr) {
     if (listbox->SelectedBgColor != colr) {
         listbox->SelectedBgColor = colr;
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -278,7 +278,7 @@ int ListBox_GetSelectedTextColor(GUIListBox *listbox) {
 void ListBox_SetSelectedTextColor(GUIListBox *listbox, int colr) {
     if (listbox->SelectedTextColor != colr) {
         listbox->SelectedTextColor = colr;
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -289,7 +289,7 @@ int ListBox_GetTextAlignment(GUIListBox *listbox) {
 void ListBox_SetTextAlignment(GUIListBox *listbox, int align) {
     if (listbox->TextAlignment != align) {
         listbox->TextAlignment = (HorAlignment)align;
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -300,7 +300,7 @@ int ListBox_GetTextColor(GUIListBox *listbox) {
 void ListBox_SetTextColor(GUIListBox *listbox, int colr) {
     if (listbox->TextColor != colr) {
         listbox->TextColor = colr;
-        guis_need_update = 1;
+        listbox->NotifyParentChanged();
     }
 }
 
@@ -323,7 +323,7 @@ void ListBox_SetSelectedIndex(GUIListBox *guisl, int newsel) {
       if (newsel >= guisl->TopItem + guisl->VisibleItemCount)
         guisl->TopItem = (newsel - guisl->VisibleItemCount) + 1;
     }
-    guis_need_update = 1;
+    guisl->NotifyParentChanged();
   }
 
 }
@@ -339,7 +339,7 @@ void ListBox_SetTopItem(GUIListBox *guisl, int item) {
     quit("!ListBoxSetTopItem: tried to set top to beyond top or bottom of list");
 
   guisl->TopItem = item;
-  guis_need_update = 1;
+  guisl->NotifyParentChanged();
 }
 
 int ListBox_GetRowCount(GUIListBox *listbox) {
@@ -349,14 +349,14 @@ int ListBox_GetRowCount(GUIListBox *listbox) {
 void ListBox_ScrollDown(GUIListBox *listbox) {
   if (listbox->TopItem + listbox->VisibleItemCount < listbox->ItemCount) {
     listbox->TopItem++;
-    guis_need_update = 1;
+    listbox->NotifyParentChanged();
   }
 }
 
 void ListBox_ScrollUp(GUIListBox *listbox) {
   if (listbox->TopItem > 0) {
     listbox->TopItem--;
-    guis_need_update = 1;
+    listbox->NotifyParentChanged();
   }
 }
 
@@ -366,7 +366,7 @@ GUIListBox* is_valid_listbox (int guin, int objn) {
   if ((objn<0) | (objn>=guis[guin].GetControlCount())) quit("!ListBox: invalid object number");
   if (guis[guin].GetControlType(objn)!=kGUIListBox)
     quit("!ListBox: specified control is not a list box");
-  guis_need_update = 1;
+  guis[guin].MarkChanged();
   return (GUIListBox*)guis[guin].GetControl(objn);
 }
 
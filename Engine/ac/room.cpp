@@ -41,6 +41,7 @@
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
 #include "ac/screen.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
 #include "ac/system.h"
 #include "ac/walkablearea.h"
@@ -60,6 +61,7 @@
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "ac/spritecache.h"
+#include "ac/viewframe.h"
 #include "util/stream.h"
 #include "gfx/graphicsdriver.h"
 #include "core/assetmanager.h"
@@ -292,6 +294,8 @@ void unload_old_room() {
         // ensure that any half-moves (eg. with scaled movement) are stopped
         charextra[ff].xwas = INVALID_X;
     }
+    // the transformed images of the old room's objects won't be needed anymore
+    clear_sprite_transform_cache();
 
     play.swap_portrait_lastchar = -1;
     play.swap_portrait_lastlastchar = -1;
@@ -574,6 +578,16 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
         ccAddExternalDynamicObject(thisroom.Hotspots[cc].ScriptName, &scrHotspot[cc], &ccDynamicHotspot);
     }
 
+    // start loading the sprites of room objects and characters in background
+    for (cc = 0; cc < croom->numobj; cc++) {
+        if (objs[cc].on)
+            spriteset.Prefetch(objs[cc].num);
+    }
+    for (cc = 0; cc < game.numcharacters; cc++) {
+        if (game.chars[cc].room == newnum && game.chars[cc].on)
+            prefetch_view_loop(game.chars[cc].view, game.chars[cc].loop);
+    }
+
     our_eip=206;
     /*  THIS IS DONE IN THE EDITOR NOW
     thisroom.BgFrames.IsPaletteShared[0] = 1;
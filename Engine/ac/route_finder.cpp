@@ -14,11 +14,15 @@
 
 #include "ac/route_finder.h"
 
+#include <vector>
+#include "ac/movelist.h"
 #include "ac/route_finder_impl.h"
 #include "ac/route_finder_impl_legacy.h"
 
 #include "debug/out.h"
 
+extern MoveList *mls;
+
 using AGS::Common::Bitmap;
 
 class IRouteFinder 
@@ -27,6 +31,7 @@ class IRouteFinder
     virtual void init_pathfinder() = 0;
     virtual void shutdown_pathfinder() = 0;
     virtual void set_wallscreen(Bitmap *wallscreen) = 0;
+    virtual void set_walkable_mask(Bitmap *walkmask) = 0;
     virtual int can_see_from(int x1, int y1, int x2, int y2) = 0;
     virtual void get_lastcpos(int &lastcx, int &lastcy) = 0;
     virtual void set_route_move_speed(int speed_x, int speed_y) = 0;
@@ -49,6 +54,10 @@ class AGSRouteFinder : public IRouteFinder
     { 
         AGS::Engine::RouteFinder::set_wallscreen(wallscreen);
     }
+    void set_walkable_mask(Bitmap *walkmask) override
+    {
+        AGS::Engine::RouteFinder::set_walkable_mask(walkmask);
+    }
     int can_see_from(int x1, int y1, int x2, int y2) override
     { 
         return AGS::Engine::RouteFinder::can_see_from(x1, y1, x2, y2); 
@@ -86,6 +95,10 @@ class AGSLegacyRouteFinder : public IRouteFinder
     { 
         AGS::Engine::RouteFinderLegacy::set_wallscreen(wallscreen); 
     }
+    void set_walkable_mask(Bitmap *walkmask) override
+    {
+        // legacy pathfinder does not precalculate anything
+    }
     int can_see_from(int x1, int y1, int x2, int y2) override
     { 
         return AGS::Engine::RouteFinderLegacy::can_see_from(x1, y1, x2, y2); 
@@ -108,11 +121,54 @@ class AGSLegacyRouteFinder : public IRouteFinder
     }
 };
 
+class AGSHierarchicalRouteFinder : public AGSRouteFinder
+{
+    public:
+    void init_pathfinder() override
+    {
+        AGSRouteFinder::init_pathfinder();
+        AGS::Engine::RouteFinder::set_hierarchical(true);
+    }
+};
+
 static IRouteFinder *route_finder_impl = nullptr;
 
-void init_pathfinder(GameDataVersion game_file_version)
+// Cache of the recently found routes. A route is only reused for the same
+// walkable mask contents, end points and movement speed: the resulting
+// move list depends on all of these.
+struct RouteCacheEntry
+{
+    uint64_t MaskId;
+    short    SrcX, SrcY, DstX, DstY;
+    int      NoCross;
+    int      SpeedX, SpeedY;
+    bool     Found;    // whether the route exists
+    uint32_t LastUse;  // for discarding least recently used entries
+    MoveList Route;
+};
+
+#define ROUTE_CACHE_SIZE 32
+static std::vector<RouteCacheEntry> route_cache;
+static uint32_t route_cache_clock = 0;
+static const Bitmap *route_mask = nullptr;
+static uint64_t route_mask_id = 0;
+static int route_speed_x = 0, route_speed_y = 0;
+
+static void reset_route_cache()
+{
+    route_cache.clear();
+    route_mask = nullptr;
+    route_mask_id = 0;
+}
+
+void init_pathfinder(GameDataVersion game_file_version, bool hierarchical)
 {
-    if (game_file_version >= kGameVersion_350) 
+    if (game_file_version >= kGameVersion_350 && hierarchical)
+    {
+        AGS::Common::Debug::Printf(AGS::Common::MessageType::kDbgMsg_Info, "Initialize hierarchical path finder library");
+        route_finder_impl = new AGSHierarchicalRouteFinder();
+    }
+    else if (game_file_version >= kGameVersion_350) 
     {
         AGS::Common::Debug::Printf(AGS::Common::MessageType::kDbgMsg_Info, "Initialize path finder library");
         route_finder_impl = new AGSRouteFinder();
@@ -124,11 +180,19 @@ void init_pathfinder(GameDataVersion game_file_version)
     }
 
     route_finder_impl->init_pathfinder();
+    reset_route_cache();
 }
 
 void shutdown_pathfinder()
 {
     route_finder_impl->shutdown_pathfinder();
+    reset_route_cache();
+}
+
+void set_route_mask_id(const Bitmap *mask, uint64_t id)
+{
+    route_mask = mask;
+    route_mask_id = id;
 }
 
 void set_wallscreen(Bitmap *wallscreen)
@@ -136,6 +200,11 @@ void set_wallscreen(Bitmap *wallscreen)
     route_finder_impl->set_wallscreen(wallscreen);
 }
 
+void set_walkable_mask(Bitmap *walkmask)
+{
+    route_finder_impl->set_walkable_mask(walkmask);
+}
+
 int can_see_from(int x1, int y1, int x2, int y2)
 {
     return route_finder_impl->can_see_from(x1, y1, x2, y2);
@@ -148,12 +217,55 @@ void get_lastcpos(int &lastcx, int &lastcy)
 
 void set_route_move_speed(int speed_x, int speed_y)
 {
+    route_speed_x = speed_x;
+    route_speed_y = speed_y;
     route_finder_impl->set_route_move_speed(speed_x, speed_y);
 }
 
 int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int movlst, int nocross, int ignore_walls)
 {
-    return route_finder_impl->find_route(srcx, srcy, xx, yy, onscreen, movlst, nocross, ignore_walls);
+    // Direct moves are trivial, and unknown masks cannot be matched
+    if (ignore_walls || route_mask_id == 0 || onscreen != route_mask)
+        return route_finder_impl->find_route(srcx, srcy, xx, yy, onscreen, movlst, nocross, ignore_walls);
+
+    RouteCacheEntry *oldest = nullptr;
+    for (auto &entry : route_cache)
+    {
+        if (entry.MaskId == route_mask_id && entry.SrcX == srcx && entry.SrcY == srcy &&
+            entry.DstX == xx && entry.DstY == yy && entry.NoCross == nocross &&
+            entry.SpeedX == route_speed_x && entry.SpeedY == route_speed_y)
+        {
+            entry.LastUse = ++route_cache_clock;
+            if (!entry.Found)
+                return 0;
+            mls[movlst] = entry.Route;
+            return movlst;
+        }
+        if (!oldest || entry.LastUse < oldest->LastUse)
+            oldest = &entry;
+    }
+
+    int mlist = route_finder_impl->find_route(srcx, srcy, xx, yy, onscreen, movlst, nocross, ignore_walls);
+
+    RouteCacheEntry *entry = oldest;
+    if (route_cache.size() < ROUTE_CACHE_SIZE)
+    {
+        route_cache.push_back(RouteCacheEntry());
+        entry = &route_cache.back();
+    }
+    entry->MaskId = route_mask_id;
+    entry->SrcX = srcx;
+    entry->SrcY = srcy;
+    entry->DstX = xx;
+    entry->DstY = yy;
+    entry->NoCross = nocross;
+    entry->SpeedX = route_speed_x;
+    entry->SpeedY = route_speed_y;
+    entry->Found = mlist != 0;
+    entry->LastUse = ++route_cache_clock;
+    if (mlist != 0)
+        entry->Route = mls[mlist];
+    return mlist;
 }
 
 void calculate_move_stage(MoveList * mlsp, int aaa)
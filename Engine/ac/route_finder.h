@@ -15,16 +15,25 @@
 #ifndef __AC_ROUTEFND_H
 #define __AC_ROUTEFND_H
 
+#include "core/types.h"
 #include "ac/game_version.h"
 
 // Forward declaration
 namespace AGS { namespace Common { class Bitmap; }}
 struct MoveList;
 
-void init_pathfinder(GameDataVersion game_file_version);
+// Hierarchical search splits the walkable mask into clusters and looks
+// for the long routes on the graph of the passages between them first
+void init_pathfinder(GameDataVersion game_file_version, bool hierarchical = false);
 void shutdown_pathfinder();
 
 void set_wallscreen(AGS::Common::Bitmap *wallscreen);
+// Notifies the pathfinder that the room's walkable areas mask has changed
+void set_walkable_mask(AGS::Common::Bitmap *walkmask);
+// Assigns an id to the current contents of the walkable mask bitmap; routes
+// found on the mask with the same id may be reused without searching again.
+// Id 0 means that contents are unknown, and disables route caching.
+void set_route_mask_id(const AGS::Common::Bitmap *mask, uint64_t id);
 
 int can_see_from(int x1, int y1, int x2, int y2);
 void get_lastcpos(int &lastcx, int &lastcy);
@@ -0,0 +1,413 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// hierarchical path-finding abstraction (HPA*) over the navigation grid
+//
+// The grid is split into square clusters. Passable cells on both sides of
+// the cluster borders become the graph nodes ("portals"), connected across
+// the border, and with precomputed distances to the other portals of the
+// same cluster. Long routes are first searched on this small graph, and then
+// refined by the grid navigation between the consecutive portals.
+//
+//=============================================================================
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <math.h>
+
+class NavHierarchy
+{
+public:
+	NavHierarchy();
+
+	// builds the abstraction; non-zero map cells are passable;
+	// row pointers must stay valid until Clear or next Build
+	void Build(int width, int height, const std::vector<const unsigned char *> &rows);
+	void Clear();
+	inline bool IsBuilt() const {return !rows.empty();}
+
+	// finds the sequence of portals leading from start to end (both included);
+	// fails if start and end are in the same cluster, or if there's no path
+	bool FindWaypoints(int sx, int sy, int ex, int ey, std::vector<int> &waypoints);
+
+private:
+	enum
+	{
+		CLUSTER_SIZE = 32,
+		// border openings longer than this get portals at both ends
+		LONG_OPENING = 6
+	};
+
+	struct Edge
+	{
+		int to;
+		float cost;
+
+		inline Edge(int nto, float ncost)
+			: to(nto)
+			, cost(ncost)
+		{
+		}
+	};
+
+	struct Node
+	{
+		int x, y;
+		std::vector<Edge> edges;
+	};
+
+	typedef std::pair<float, int> Entry;
+
+	int mapWidth;
+	int mapHeight;
+	int clustersX;
+	int clustersY;
+	std::vector<const unsigned char *> rows;
+
+	std::vector<Node> nodes;
+	std::vector<std::vector<int> > clusterNodes;
+	std::unordered_map<int, int> cellNodes;
+
+	// search state
+	std::vector<float> gcost;
+	std::vector<int> prev;
+	std::vector<unsigned> visited;
+	unsigned searchId;
+	std::vector<int> clusterDist;
+	std::vector<int> bfsQueue;
+	std::vector<std::pair<int, float> > startLinks, endLinks;
+
+	inline bool Passable(int x, int y) const
+	{
+		return (unsigned)x < (unsigned)mapWidth && (unsigned)y < (unsigned)mapHeight &&
+			rows[y][x] != 0;
+	}
+
+	inline int ClusterOf(int x, int y) const
+	{
+		return (y / CLUSTER_SIZE) * clustersX + x / CLUSTER_SIZE;
+	}
+
+	int GetNode(int x, int y);
+	void AddOpening(int ax, int ay, int bx, int by);
+	void ScanBorder(int ax, int ay, int dx, int dy, int bx, int by, int len);
+	// distances from the cell to every cell of its cluster, written to clusterDist
+	void ClusterDistances(int x, int y);
+	// distances from the cell to the portals of its cluster
+	void LinkToCluster(int x, int y, std::vector<std::pair<int, float> > &links);
+};
+
+NavHierarchy::NavHierarchy()
+	: mapWidth(0)
+	, mapHeight(0)
+	, clustersX(0)
+	, clustersY(0)
+	, searchId(0)
+{
+}
+
+void NavHierarchy::Clear()
+{
+	rows.clear();
+	nodes.clear();
+	clusterNodes.clear();
+	cellNodes.clear();
+	mapWidth = mapHeight = 0;
+	clustersX = clustersY = 0;
+}
+
+int NavHierarchy::GetNode(int x, int y)
+{
+	int cell = y*mapWidth + x;
+	std::unordered_map<int, int>::const_iterator it = cellNodes.find(cell);
+
+	if (it != cellNodes.end())
+		return it->second;
+
+	int index = (int)nodes.size();
+	nodes.push_back(Node());
+	nodes.back().x = x;
+	nodes.back().y = y;
+	cellNodes[cell] = index;
+	clusterNodes[ClusterOf(x, y)].push_back(index);
+	return index;
+}
+
+void NavHierarchy::AddOpening(int ax, int ay, int bx, int by)
+{
+	int a = GetNode(ax, ay);
+	int b = GetNode(bx, by);
+	nodes[a].edges.push_back(Edge(b, 1.0f));
+	nodes[b].edges.push_back(Edge(a, 1.0f));
+}
+
+// scans the pairs of neighbouring cells (a, b) along the border, starting
+// from (ax, ay) and (bx, by), and moving by (dx, dy)
+void NavHierarchy::ScanBorder(int ax, int ay, int dx, int dy, int bx, int by, int len)
+{
+	int start = -1;
+
+	for (int i=0; i<=len; i++)
+	{
+		bool open = i < len &&
+			Passable(ax + dx*i, ay + dy*i) && Passable(bx + dx*i, by + dy*i);
+
+		if (open)
+		{
+			if (start < 0)
+				start = i;
+			continue;
+		}
+
+		if (start < 0)
+			continue;
+
+		int end = i-1;
+
+		if (end - start + 1 >= LONG_OPENING)
+		{
+			AddOpening(ax + dx*start, ay + dy*start, bx + dx*start, by + dy*start);
+			AddOpening(ax + dx*end, ay + dy*end, bx + dx*end, by + dy*end);
+		}
+		else
+		{
+			int mid = (start + end) / 2;
+			AddOpening(ax + dx*mid, ay + dy*mid, bx + dx*mid, by + dy*mid);
+		}
+
+		start = -1;
+	}
+}
+
+void NavHierarchy::ClusterDistances(int x, int y)
+{
+	int cx0 = (x / CLUSTER_SIZE) * CLUSTER_SIZE;
+	int cy0 = (y / CLUSTER_SIZE) * CLUSTER_SIZE;
+	int cw = std::min<int>(CLUSTER_SIZE, mapWidth - cx0);
+	int ch = std::min<int>(CLUSTER_SIZE, mapHeight - cy0);
+
+	clusterDist.assign(CLUSTER_SIZE*CLUSTER_SIZE, -1);
+	bfsQueue.clear();
+
+	// orthogonal moves only, same as the grid navigation
+	clusterDist[(y-cy0)*CLUSTER_SIZE + (x-cx0)] = 0;
+	bfsQueue.push_back((y-cy0)*CLUSTER_SIZE + (x-cx0));
+
+	static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+	for (size_t head = 0; head < bfsQueue.size(); head++)
+	{
+		int idx = bfsQueue[head];
+		int lx = idx % CLUSTER_SIZE;
+		int ly = idx / CLUSTER_SIZE;
+
+		for (int d=0; d<4; d++)
+		{
+			int nx = lx + dirs[d][0];
+			int ny = ly + dirs[d][1];
+
+			if (nx < 0 || ny < 0 || nx >= cw || ny >= ch)
+				continue;
+
+			int nidx = ny*CLUSTER_SIZE + nx;
+
+			if (clusterDist[nidx] >= 0 || !Passable(cx0 + nx, cy0 + ny))
+				continue;
+
+			clusterDist[nidx] = clusterDist[idx] + 1;
+			bfsQueue.push_back(nidx);
+		}
+	}
+}
+
+void NavHierarchy::LinkToCluster(int x, int y, std::vector<std::pair<int, float> > &links)
+{
+	links.clear();
+	ClusterDistances(x, y);
+
+	int cx0 = (x / CLUSTER_SIZE) * CLUSTER_SIZE;
+	int cy0 = (y / CLUSTER_SIZE) * CLUSTER_SIZE;
+	const std::vector<int> &cnodes = clusterNodes[ClusterOf(x, y)];
+
+	for (int i=0; i<(int)cnodes.size(); i++)
+	{
+		const Node &node = nodes[cnodes[i]];
+		int dist = clusterDist[(node.y-cy0)*CLUSTER_SIZE + (node.x-cx0)];
+
+		if (dist >= 0)
+			links.push_back(std::make_pair(cnodes[i], (float)dist));
+	}
+}
+
+void NavHierarchy::Build(int width, int height, const std::vector<const unsigned char *> &nrows)
+{
+	Clear();
+
+	mapWidth = width;
+	mapHeight = height;
+	rows = nrows;
+	clustersX = (width + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	clustersY = (height + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	clusterNodes.resize(clustersX * clustersY);
+
+	// portals on the borders between neighbouring clusters
+	for (int cy=0; cy<clustersY; cy++)
+	{
+		for (int cx=0; cx<clustersX; cx++)
+		{
+			int x0 = cx*CLUSTER_SIZE;
+			int y0 = cy*CLUSTER_SIZE;
+			int cw = std::min<int>(CLUSTER_SIZE, width - x0);
+			int ch = std::min<int>(CLUSTER_SIZE, height - y0);
+
+			if (cx+1 < clustersX)
+				ScanBorder(x0+cw-1, y0, 0, 1, x0+cw, y0, ch);
+
+			if (cy+1 < clustersY)
+				ScanBorder(x0, y0+ch-1, 1, 0, x0, y0+ch, cw);
+		}
+	}
+
+	// paths between portals within each cluster
+	for (int c=0; c<(int)clusterNodes.size(); c++)
+	{
+		const std::vector<int> &cnodes = clusterNodes[c];
+
+		for (int i=0; i<(int)cnodes.size(); i++)
+		{
+			LinkToCluster(nodes[cnodes[i]].x, nodes[cnodes[i]].y, startLinks);
+
+			for (int j=0; j<(int)startLinks.size(); j++)
+			{
+				if (startLinks[j].first != cnodes[i])
+					nodes[cnodes[i]].edges.push_back(Edge(startLinks[j].first, startLinks[j].second));
+			}
+		}
+	}
+
+	gcost.resize(nodes.size() + 1);
+	prev.resize(nodes.size() + 1);
+	visited.assign(nodes.size() + 1, 0);
+	searchId = 0;
+}
+
+bool NavHierarchy::FindWaypoints(int sx, int sy, int ex, int ey, std::vector<int> &waypoints)
+{
+	waypoints.clear();
+
+	if (!IsBuilt() || !Passable(sx, sy) || !Passable(ex, ey))
+		return false;
+
+	if (ClusterOf(sx, sy) == ClusterOf(ex, ey))
+		return false;
+
+	LinkToCluster(sx, sy, startLinks);
+	LinkToCluster(ex, ey, endLinks);
+
+	if (startLinks.empty() || endLinks.empty())
+		return false;
+
+	if (++searchId == 0)
+	{
+		std::fill(visited.begin(), visited.end(), 0);
+		searchId = 1;
+	}
+
+	// the last index is a virtual goal node, linked from the end cluster's portals
+	const int goal = (int)nodes.size();
+	std::unordered_map<int, float> goalLinks;
+
+	for (int i=0; i<(int)endLinks.size(); i++)
+		goalLinks[endLinks[i].first] = endLinks[i].second;
+
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > pq;
+
+	for (int i=0; i<(int)startLinks.size(); i++)
+	{
+		int n = startLinks[i].first;
+		visited[n] = searchId;
+		gcost[n] = startLinks[i].second;
+		prev[n] = -1;
+		float h = hypotf((float)(nodes[n].x - ex), (float)(nodes[n].y - ey));
+		pq.push(Entry(gcost[n] + h, n));
+	}
+
+	bool found = false;
+
+	while (!pq.empty())
+	{
+		Entry e = pq.top();
+		pq.pop();
+
+		int n = e.second;
+
+		if (n == goal)
+		{
+			found = true;
+			break;
+		}
+
+		float h = hypotf((float)(nodes[n].x - ex), (float)(nodes[n].y - ey));
+
+		// skip outdated queue entries
+		if (e.first > gcost[n] + h)
+			continue;
+
+		std::unordered_map<int, float>::const_iterator git = goalLinks.find(n);
+
+		if (git != goalLinks.end())
+		{
+			float g = gcost[n] + git->second;
+
+			if (visited[goal] != searchId || g < gcost[goal])
+			{
+				visited[goal] = searchId;
+				gcost[goal] = g;
+				prev[goal] = n;
+				pq.push(Entry(g, goal));
+			}
+		}
+
+		const std::vector<Edge> &edges = nodes[n].edges;
+
+		for (int i=0; i<(int)edges.size(); i++)
+		{
+			int to = edges[i].to;
+			float g = gcost[n] + edges[i].cost;
+
+			if (visited[to] == searchId && g >= gcost[to])
+				continue;
+
+			visited[to] = searchId;
+			gcost[to] = g;
+			prev[to] = n;
+			pq.push(Entry(g + hypotf((float)(nodes[to].x - ex), (float)(nodes[to].y - ey)), to));
+		}
+	}
+
+	if (!found)
+		return false;
+
+	waypoints.push_back(Navigation::PackSquare(ex, ey));
+
+	for (int n = prev[goal]; n >= 0; n = prev[n])
+		waypoints.push_back(Navigation::PackSquare(nodes[n].x, nodes[n].y));
+
+	waypoints.push_back(Navigation::PackSquare(sx, sy));
+	std::reverse(waypoints.begin(), waypoints.end());
+	return true;
+}
@@ -28,6 +28,7 @@
 #include "debug/out.h"
 
 #include "route_finder_jps.inl"
+#include "route_finder_hpa.inl"
 
 extern MoveList *mls;
 
@@ -48,13 +49,29 @@ static fixed move_speed_x, move_speed_y;
 static Navigation nav;
 static Bitmap *wallscreen;
 static int lastcx, lastcy;
+// hierarchical search over the room's walkable mask; the blocking
+// characters and objects are only taken into account when refining
+static NavHierarchy navh;
+static bool use_hierarchy;
+static Bitmap *walkmask;
+static bool walkmask_dirty;
 
 void init_pathfinder()
 {
+  use_hierarchy = false;
 }
 
 void shutdown_pathfinder()
 {
+  navh.Clear();
+  walkmask = nullptr;
+}
+
+void set_hierarchical(bool on)
+{
+  use_hierarchy = on;
+  if (!on)
+    navh.Clear();
 }
 
 void set_wallscreen(Bitmap *wallscreen_) 
@@ -62,9 +79,39 @@ void set_wallscreen(Bitmap *wallscreen_)
   wallscreen = wallscreen_;
 }
 
+void set_walkable_mask(Bitmap *walkmask_)
+{
+  walkmask = walkmask_;
+  walkmask_dirty = true;
+}
+
+static void sync_nav_hierarchy()
+{
+  if (!walkmask_dirty)
+    return;
+  walkmask_dirty = false;
+
+  static std::vector<const unsigned char *> rows;
+  rows.resize(walkmask->GetHeight());
+  for (int y = 0; y < walkmask->GetHeight(); y++)
+    rows[y] = walkmask->GetScanLine(y);
+  navh.Build(walkmask->GetWidth(), walkmask->GetHeight(), rows);
+}
+
 static void sync_nav_wallscreen()
 {
-  // FIXME: this is dumb, but...
+  // The navigation grid references wallscreen rows directly; engine keeps
+  // the same mask bitmap and updates its contents in place, so the rows only
+  // have to be reassigned when a different bitmap is passed
+  static const unsigned char *nav_first_row = nullptr;
+  static int nav_width = 0, nav_height = 0;
+  if (wallscreen->GetScanLine(0) == nav_first_row &&
+      wallscreen->GetWidth() == nav_width && wallscreen->GetHeight() == nav_height)
+    return;
+  nav_first_row = wallscreen->GetScanLine(0);
+  nav_width = wallscreen->GetWidth();
+  nav_height = wallscreen->GetHeight();
+
   nav.Resize(wallscreen->GetWidth(), wallscreen->GetHeight());
 
   for (int y=0; y<wallscreen->GetHeight(); y++)
@@ -90,6 +137,66 @@ void get_lastcpos(int &lastcx_, int &lastcy_)
   lastcy_ = lastcy;
 }
 
+// routing over the cluster graph; the portal path is refined with JPS
+// segment by segment, and fails if any segment cannot be passed exactly
+static bool find_route_over_clusters(Navigation &grid, NavHierarchy &clusters,
+  int fromx, int fromy, int destx, int desty, std::vector<int> &cpath)
+{
+  static std::vector<int> waypoints, path, segment;
+  if (!clusters.FindWaypoints(fromx, fromy, destx, desty, waypoints))
+    return false;
+
+  static std::vector<int> rough;
+  rough.clear();
+  rough.push_back(waypoints[0]);
+  for (size_t i = 1; i < waypoints.size(); i++)
+  {
+    int sx, sy, ex, ey;
+    grid.UnpackSquare(waypoints[i - 1], sx, sy);
+    grid.UnpackSquare(waypoints[i], ex, ey);
+    if (sx == ex && sy == ey)
+      continue;
+
+    path.clear();
+    if (grid.NavigateRefined(sx, sy, ex, ey, path, segment) == Navigation::NAV_UNREACHABLE ||
+        segment.empty() || segment.back() != waypoints[i])
+      return false;
+    rough.insert(rough.end(), segment.begin() + 1, segment.end());
+  }
+
+  // portals are not the corners of the optimal path, so skip every node
+  // while the one after it may be seen directly from the last kept node;
+  // the look-ahead stops at the first blocked line, so the number of traces
+  // stays linear in the path length
+  cpath.clear();
+  cpath.push_back(rough[0]);
+  int fx, fy;
+  grid.UnpackSquare(rough[0], fx, fy);
+  for (size_t i = 1; i < rough.size(); i++)
+  {
+    if (i + 1 < rough.size())
+    {
+      int tx, ty;
+      grid.UnpackSquare(rough[i + 1], tx, ty);
+      if (!grid.TraceLine(fx, fy, tx, ty))
+        continue;
+    }
+    cpath.push_back(rough[i]);
+    grid.UnpackSquare(rough[i], fx, fy);
+  }
+  return true;
+}
+
+static bool find_route_hierarchical(int fromx, int fromy, int destx, int desty, std::vector<int> &cpath)
+{
+  if (!walkmask || walkmask->GetWidth() != wallscreen->GetWidth() ||
+      walkmask->GetHeight() != wallscreen->GetHeight())
+    return false;
+
+  sync_nav_hierarchy();
+  return find_route_over_clusters(nav, navh, fromx, fromy, destx, desty, cpath);
+}
+
 // new routing using JPS
 static int find_route_jps(int fromx, int fromy, int destx, int desty)
 {
@@ -99,8 +206,12 @@ static int find_route_jps(int fromx, int fromy, int destx, int desty)
   path.clear();
   cpath.clear();
 
-  if (nav.NavigateRefined(fromx, fromy, destx, desty, path, cpath) == Navigation::NAV_UNREACHABLE)
-    return 0;
+  if (!use_hierarchy || !find_route_hierarchical(fromx, fromy, destx, desty, cpath))
+  {
+    cpath.clear();
+    if (nav.NavigateRefined(fromx, fromy, destx, desty, path, cpath) == Navigation::NAV_UNREACHABLE)
+      return 0;
+  }
 
   num_navpoints = 0;
 
@@ -267,6 +378,58 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
   return mlist;
 }
 
+#ifdef AGS_RUN_TESTS
+// the test mask is kept separately from the room navigation
+static Navigation test_nav;
+static NavHierarchy test_navh;
+
+static void sync_test_mask(const std::vector<const unsigned char *> &rows, int width)
+{
+  static std::vector<const unsigned char *> test_rows;
+  static int test_width = 0;
+  if (rows == test_rows && width == test_width)
+    return;
+  test_rows = rows;
+  test_width = width;
+  test_nav.Resize(width, (int)rows.size());
+  for (size_t y = 0; y < rows.size(); y++)
+    test_nav.SetMapRow((int)y, rows[y]);
+  test_navh.Build(width, (int)rows.size(), rows);
+}
+
+bool find_path_on_mask(const std::vector<const unsigned char *> &rows, int width, bool hierarchical,
+  int fromx, int fromy, int destx, int desty, std::vector<std::pair<int, int>> &points)
+{
+  sync_test_mask(rows, width);
+  Navigation &grid = test_nav;
+  std::vector<int> path, cpath;
+  if (hierarchical)
+  {
+    if (!find_route_over_clusters(grid, test_navh, fromx, fromy, destx, desty, cpath))
+      return false;
+  }
+  else if (grid.NavigateRefined(fromx, fromy, destx, desty, path, cpath) == Navigation::NAV_UNREACHABLE)
+  {
+    return false;
+  }
+
+  points.clear();
+  for (int sq : cpath)
+  {
+    int x, y;
+    grid.UnpackSquare(sq, x, y);
+    points.push_back(std::make_pair(x, y));
+  }
+  return true;
+}
+
+bool can_see_on_mask(const std::vector<const unsigned char *> &rows, int width, int x1, int y1, int x2, int y2)
+{
+  sync_test_mask(rows, width);
+  return !test_nav.TraceLine(x1, y1, x2, y2);
+}
+#endif // AGS_RUN_TESTS
+
 
 } // namespace RouteFinder
 } // namespace Engine
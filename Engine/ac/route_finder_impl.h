@@ -15,6 +15,8 @@
 #ifndef __AC_ROUTE_FINDER_IMPL
 #define __AC_ROUTE_FINDER_IMPL
 
+#include <utility>
+#include <vector>
 #include "ac/game_version.h"
 
 // Forward declaration
@@ -28,7 +30,10 @@ namespace RouteFinder {
 void init_pathfinder();
 void shutdown_pathfinder();
 
+// Enables search over the cluster graph built from the walkable mask
+void set_hierarchical(bool on);
 void set_wallscreen(AGS::Common::Bitmap *wallscreen);
+void set_walkable_mask(AGS::Common::Bitmap *walkmask);
 
 int can_see_from(int x1, int y1, int x2, int y2);
 void get_lastcpos(int &lastcx, int &lastcy);
@@ -38,6 +43,15 @@ void set_route_move_speed(int speed_x, int speed_y);
 int find_route(short srcx, short srcy, short xx, short yy, AGS::Common::Bitmap *onscreen, int movlst, int nocross = 0, int ignore_walls = 0);
 void calculate_move_stage(MoveList * mlsp, int aaa);
 
+#ifdef AGS_RUN_TESTS
+// Finds the path corners over the given mask rows, either by the search over
+// the cluster graph only, or by the plain JPS search; does not use the room state
+bool find_path_on_mask(const std::vector<const unsigned char *> &rows, int width, bool hierarchical,
+    int fromx, int fromy, int destx, int desty, std::vector<std::pair<int, int>> &points);
+// Tests if the straight line between two points is passable on the mask rows
+bool can_see_on_mask(const std::vector<const unsigned char *> &rows, int width, int x1, int y1, int x2, int y2);
+#endif
+
 } // namespace RouteFinder
 } // namespace Engine
 } // namespace AGS
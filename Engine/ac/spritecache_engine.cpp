@@ -37,7 +37,7 @@ void SpriteCache::InitNullSpriteParams(sprkey_t index)
     _sprInfos[index].Width = _sprInfos[0].Width;
     _sprInfos[index].Height = _sprInfos[0].Height;
     _spriteData[index].Image = nullptr;
-    _spriteData[index].Offset = _spriteData[0].Offset;
+    _spriteOffsets[index] = _spriteOffsets[0];
     _spriteData[index].Size = _spriteData[0].Size;
     _spriteData[index].Flags = SPRCACHEFLAG_REMAPPED;
 }
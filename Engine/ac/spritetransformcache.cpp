@@ -0,0 +1,115 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "ac/spritetransformcache.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+struct SpriteTransformKeyHash
+{
+    size_t operator()(const SpriteTransformKey &key) const
+    {
+        size_t hash = key.Sprite;
+        const int values[] = { key.Width, key.Height, key.Mirrored, key.Antialiased, key.TintRed,
+            key.TintGreen, key.TintBlue, key.TintAmount, key.TintLight, key.LightLevel };
+        for (int value : values)
+            hash = hash * 31 + value;
+        return hash;
+    }
+};
+
+struct SpriteTransformEntry
+{
+    SpriteTransformKey      Key;
+    std::unique_ptr<Bitmap> Image;
+    size_t                  Size;
+};
+
+typedef std::list<SpriteTransformEntry> SpriteTransformList;
+// Entries ordered from the most recently used to the least recently used
+static SpriteTransformList transform_cache;
+static std::unordered_map<SpriteTransformKey, SpriteTransformList::iterator, SpriteTransformKeyHash> transform_cache_index;
+static size_t transform_cache_size = 0;
+static size_t transform_cache_max_size = DEFAULTTRANSFORMCACHESIZE_KB * 1024;
+
+
+static void remove_entry(SpriteTransformList::iterator it)
+{
+    transform_cache_index.erase(it->Key);
+    transform_cache_size -= it->Size;
+    transform_cache.erase(it);
+}
+
+static void free_space(size_t size)
+{
+    while (!transform_cache.empty() && transform_cache_size + size > transform_cache_max_size)
+        remove_entry(std::prev(transform_cache.end()));
+}
+
+void set_sprite_transform_cache_size(size_t size)
+{
+    transform_cache_max_size = size;
+    free_space(0);
+}
+
+Bitmap *get_transformed_sprite(const SpriteTransformKey &key)
+{
+    auto found = transform_cache_index.find(key);
+    if (found == transform_cache_index.end())
+        return nullptr;
+    // move to the front, as the most recently used
+    transform_cache.splice(transform_cache.begin(), transform_cache, found->second);
+    return found->second->Image.get();
+}
+
+void put_transformed_sprite(const SpriteTransformKey &key, Bitmap *image)
+{
+    const size_t size = image->GetDataSize();
+    if (size > transform_cache_max_size)
+        return;
+    auto found = transform_cache_index.find(key);
+    if (found != transform_cache_index.end())
+        remove_entry(found->second);
+    free_space(size);
+
+    SpriteTransformEntry entry;
+    entry.Key = key;
+    entry.Image.reset(BitmapHelper::CreateBitmapCopy(image));
+    entry.Size = size;
+    transform_cache.push_front(std::move(entry));
+    transform_cache_index[key] = transform_cache.begin();
+    transform_cache_size += size;
+}
+
+void invalidate_transformed_sprite(int sprite)
+{
+    for (auto it = transform_cache.begin(); it != transform_cache.end();)
+    {
+        auto next = std::next(it);
+        if (it->Key.Sprite == sprite)
+            remove_entry(it);
+        it = next;
+    }
+}
+
+void clear_sprite_transform_cache()
+{
+    transform_cache.clear();
+    transform_cache_index.clear();
+    transform_cache_size = 0;
+}
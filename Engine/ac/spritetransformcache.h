@@ -0,0 +1,71 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Cache of the scaled, flipped and tinted sprite images, made by the
+// software renderer for the characters and room objects.
+//
+// The images are shared by all the characters and objects, so that same
+// sprite drawn at the same scale and tint (e.g. walking animation) is
+// transformed only once. The memory is limited by the total size of the
+// images; the ones which were not used for the longest time are released
+// first.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__SPRITETRANSFORMCACHE_H
+#define __AGS_EE_AC__SPRITETRANSFORMCACHE_H
+
+#include <stddef.h>
+
+namespace AGS { namespace Common { class Bitmap; } }
+using namespace AGS; // FIXME later
+
+#define DEFAULTTRANSFORMCACHESIZE_KB (16 * 1024)
+
+// Describes the sprite transformation
+struct SpriteTransformKey
+{
+    int  Sprite;
+    int  Width;       // final sprite size
+    int  Height;
+    bool Mirrored;
+    bool Antialiased; // scaled with antialiasing
+    int  TintRed;
+    int  TintGreen;
+    int  TintBlue;
+    int  TintAmount;
+    int  TintLight;
+    int  LightLevel;
+
+    bool operator ==(const SpriteTransformKey &other) const
+    {
+        return Sprite == other.Sprite && Width == other.Width && Height == other.Height &&
+            Mirrored == other.Mirrored && Antialiased == other.Antialiased &&
+            TintRed == other.TintRed && TintGreen == other.TintGreen && TintBlue == other.TintBlue &&
+            TintAmount == other.TintAmount && TintLight == other.TintLight && LightLevel == other.LightLevel;
+    }
+};
+
+// Sets max size of the cached images, in bytes; 0 disables the cache
+void set_sprite_transform_cache_size(size_t size);
+// Gets the cached image, or null if there's none; the image remains owned
+// by the cache, and is valid until the next change to the cache
+Common::Bitmap *get_transformed_sprite(const SpriteTransformKey &key);
+// Puts a copy of the transformed image into the cache
+void put_transformed_sprite(const SpriteTransformKey &key, Common::Bitmap *image);
+// Removes all the images made of the given sprite, used when the sprite changes
+void invalidate_transformed_sprite(int sprite);
+// Removes all the images
+void clear_sprite_transform_cache();
+
+#endif // __AGS_EE_AC__SPRITETRANSFORMCACHE_H
@@ -115,6 +115,15 @@ void precache_view(int view)
     }
 }
 
+void prefetch_view_loop(int view, int loop)
+{
+    if (view < 0 || view >= game.numviews || loop < 0 || loop >= views[view].numLoops)
+        return;
+
+    for (int j = 0; j < views[view].loops[loop].numFrames; j++)
+        spriteset.Prefetch(views[view].loops[loop].frames[j].pic);
+}
+
 int GetPanningFromPosition(int x) {
     PCamera viewport = play.GetRoomViewport(0)->GetCamera();
     if (!viewport) return 128;
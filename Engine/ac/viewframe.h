@@ -40,6 +40,8 @@ int  ViewFrame_GetLoop(ScriptViewFrame *svf);
 int  ViewFrame_GetFrame(ScriptViewFrame *svf);
 
 void precache_view(int view);
+// schedules background loading of the sprites of the given view loop
+void prefetch_view_loop(int view, int loop);
 void CheckViewFrame (int view, int loop, int frame, int sound_volume=SCR_NO_VALUE, int sound_panning = SCR_NO_VALUE);
 // draws a view frame, flipped if appropriate
 void DrawViewFrame(Common::Bitmap *ds, const ViewFrame *vframe, int x, int y, bool alpha_blend = false);
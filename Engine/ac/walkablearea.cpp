@@ -12,6 +12,8 @@
 //
 //=============================================================================
 
+#include <algorithm>
+#include <vector>
 #include "ac/common.h"
 #include "ac/object.h"
 #include "ac/character.h"
@@ -21,6 +23,7 @@
 #include "ac/room.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/walkablearea.h"
 #include "game/roomstruct.h"
 #include "gfx/bitmap.h"
@@ -35,8 +38,38 @@ extern RoomStatus*croom;
 extern RoomObject*objs;
 
 Bitmap *walkareabackup=nullptr, *walkable_areas_temp = nullptr;
+// Blocking rectangles that are currently cut out of the walkable_areas_temp
+// (in mask coordinates); lets update the temp mask only where they change
+static std::vector<Rect> walkable_temp_blocks;
+static bool walkable_temp_valid = false;
+// Increments each time the walkable areas mask changes
+static uint32_t walkable_temp_generation = 0;
+
+void invalidate_walkable_areas_temp()
+{
+    walkable_temp_valid = false;
+    walkable_temp_blocks.clear();
+    walkable_temp_generation++;
+    set_walkable_mask(thisroom.WalkAreaMask.get());
+}
+
+// Calculates the id of the temp mask contents, which are defined by the
+// walkable areas mask and the blocks cut out of it (64-bit FNV-1a hash)
+static uint64_t calc_walkable_temp_id(const std::vector<Rect> &blocks) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](uint32_t v) {
+        for (int i = 0; i < 4; ++i, v >>= 8)
+            hash = (hash ^ (v & 0xFF)) * 1099511628211ULL;
+    };
+    add(walkable_temp_generation);
+    for (const Rect &rc : blocks) {
+        add(rc.Left); add(rc.Top); add(rc.Right); add(rc.Bottom);
+    }
+    return hash != 0 ? hash : 1; // 0 is reserved for "unknown"
+}
 
 void redo_walkable_areas() {
+    invalidate_walkable_areas_temp();
 
     // since this is an 8-bit memory bitmap, we can just use direct 
     // memory access
@@ -112,23 +145,62 @@ void scale_sprite_size(int sppic, int zoom_level, int *newwidth, int *newheight)
         newheight[0] = 1;
 }
 
-void remove_walkable_areas_from_temp(int fromx, int cwidth, int starty, int endy) {
+// Adds blocking rectangle, given in room coordinates, to the list
+static void add_walkable_block(std::vector<Rect> &blocks, int fromx, int cwidth, int starty, int endy) {
     fromx = room_to_mask_coord(fromx);
     cwidth = room_to_mask_coord(cwidth);
     starty = room_to_mask_coord(starty);
     endy = room_to_mask_coord(endy);
-    int yyy;
-    if (endy >= walkable_areas_temp->GetHeight())
-        endy = walkable_areas_temp->GetHeight() - 1;
-    if (starty < 0)
-        starty = 0;
-
-    for (; cwidth > 0; cwidth --) {
-        for (yyy = starty; yyy <= endy; yyy++)
-            walkable_areas_temp->PutPixel (fromx, yyy, 0);
-        fromx ++;
-    }
+    Rect rc(fromx, starty, fromx + cwidth - 1, endy);
+    rc.Left = std::max(0, rc.Left);
+    rc.Top = std::max(0, rc.Top);
+    rc.Right = std::min(walkable_areas_temp->GetWidth() - 1, rc.Right);
+    rc.Bottom = std::min(walkable_areas_temp->GetHeight() - 1, rc.Bottom);
+    if (!rc.IsEmpty())
+        blocks.push_back(rc);
+}
 
+static bool is_same_block(const Rect &r1, const Rect &r2) {
+    return r1.Left == r2.Left && r1.Top == r2.Top && r1.Right == r2.Right && r1.Bottom == r2.Bottom;
+}
+
+static bool has_block(const std::vector<Rect> &blocks, const Rect &rc) {
+    for (const Rect &b : blocks)
+        if (is_same_block(b, rc))
+            return true;
+    return false;
+}
+
+// Brings walkable_areas_temp to the state where it matches the walkable areas
+// mask with the given blocks cut out. Only the difference from the previous
+// call is redrawn, unless the temp mask was invalidated.
+static void update_walkable_areas_temp(const std::vector<Rect> &blocks) {
+    Bitmap *mask = thisroom.WalkAreaMask.get();
+    static std::vector<Rect> restored;
+    restored.clear();
+    if (!walkable_temp_valid) {
+        walkable_areas_temp->Blit(mask, 0, 0, 0, 0, mask->GetWidth(), mask->GetHeight());
+        walkable_temp_valid = true;
+        walkable_temp_blocks.clear();
+    } else {
+        // restore areas under the blocks which are gone or moved
+        for (const Rect &rc : walkable_temp_blocks) {
+            if (has_block(blocks, rc))
+                continue;
+            walkable_areas_temp->Blit(mask, rc.Left, rc.Top, rc.Left, rc.Top, rc.GetWidth(), rc.GetHeight());
+            restored.push_back(rc);
+        }
+    }
+    // cut out new blocks, and ones that were partially restored
+    for (const Rect &rc : blocks) {
+        bool need_cut = !has_block(walkable_temp_blocks, rc);
+        for (size_t i = 0; !need_cut && i < restored.size(); ++i)
+            need_cut = AreRectsIntersecting(rc, restored[i]);
+        if (need_cut)
+            walkable_areas_temp->FillRect(rc, 0);
+    }
+    walkable_temp_blocks = blocks;
+    set_route_mask_id(walkable_areas_temp, calc_walkable_temp_id(blocks));
 }
 
 int is_point_in_rect(int x, int y, int left, int top, int right, int bottom) {
@@ -138,12 +210,14 @@ int is_point_in_rect(int x, int y, int left, int top, int right, int bottom) {
 }
 
 Bitmap *prepare_walkable_areas (int sourceChar) {
-    // copy the walkable areas to the temp bitmap
-    walkable_areas_temp->Blit(thisroom.WalkAreaMask.get(), 0,0,0,0,thisroom.WalkAreaMask->GetWidth(),thisroom.WalkAreaMask->GetHeight());
+    static std::vector<Rect> blocks;
+    blocks.clear();
     // if the character who's moving doesn't Bitmap *, don't bother checking
     if (sourceChar < 0) ;
-    else if (game.chars[sourceChar].flags & CHF_NOBLOCKING)
+    else if (game.chars[sourceChar].flags & CHF_NOBLOCKING) {
+        update_walkable_areas_temp(blocks);
         return walkable_areas_temp;
+    }
 
     int ww;
     // for each character in the current room, make the area under
@@ -165,7 +239,7 @@ Bitmap *prepare_walkable_areas (int sourceChar) {
         if ((sourceChar >= 0) && (is_char_on_another(ww, sourceChar, nullptr, nullptr)))
             continue;
 
-        remove_walkable_areas_from_temp(fromx, cwidth, char1->get_blocking_top(), char1->get_blocking_bottom());
+        add_walkable_block(blocks, fromx, cwidth, char1->get_blocking_top(), char1->get_blocking_bottom());
     }
 
     // check for any blocking objects in the room, and deal with them
@@ -188,9 +262,10 @@ Bitmap *prepare_walkable_areas (int sourceChar) {
             x1, y1, x1 + width, y2)))
             continue;
 
-        remove_walkable_areas_from_temp(x1, width, y1, y2);
+        add_walkable_block(blocks, x1, width, y1, y2);
     }
 
+    update_walkable_areas_temp(blocks);
     return walkable_areas_temp;
 }
 
@@ -27,8 +27,8 @@ extern GameState play;
 extern IGraphicsDriver *gfxDriver;
 
 
-char *walkBehindExists = nullptr;  // whether a WB area is in this column
-int *walkBehindStartY = nullptr, *walkBehindEndY = nullptr;
+std::vector<WalkBehindRun> walkBehindRuns;
+std::vector<size_t> walkBehindRowRuns;
 char noWalkBehindsAtAll = 0;
 int walkBehindLeft[MAX_WALK_BEHINDS], walkBehindTop[MAX_WALK_BEHINDS];
 int walkBehindRight[MAX_WALK_BEHINDS], walkBehindBottom[MAX_WALK_BEHINDS];
@@ -81,15 +81,9 @@ void update_walk_behind_images()
 
 
 void recache_walk_behinds () {
-  if (walkBehindExists) {
-    free (walkBehindExists);
-    free (walkBehindStartY);
-    free (walkBehindEndY);
-  }
-
-  walkBehindExists = (char*)malloc (thisroom.WalkBehindMask->GetWidth());
-  walkBehindStartY = (int*)malloc (thisroom.WalkBehindMask->GetWidth() * sizeof(int));
-  walkBehindEndY = (int*)malloc (thisroom.WalkBehindMask->GetWidth() * sizeof(int));
+  walkBehindRuns.clear();
+  walkBehindRowRuns.resize(thisroom.WalkBehindMask->GetHeight() + 1);
+  walkBehindRowRuns[0] = 0;
   noWalkBehindsAtAll = 1;
 
   int ee,rr,tmm;
@@ -115,25 +109,29 @@ void recache_walk_behinds () {
   if ((!thisroom.WalkBehindMask->IsLinearBitmap()) || (thisroom.WalkBehindMask->GetColorDepth() != 8))
     quit("Walk behinds bitmap not linear");
 
-  for (ee=0;ee<thisroom.WalkBehindMask->GetWidth();ee++) {
-    walkBehindExists[ee] = 0;
-    for (rr=0;rr<thisroom.WalkBehindMask->GetHeight();rr++) {
-      tmm = thisroom.WalkBehindMask->GetScanLine(rr)[ee];
-      //tmm = _getpixel(thisroom.WalkBehindMask,ee,rr);
-      if ((tmm >= 1) && (tmm < MAX_WALK_BEHINDS)) {
-        if (!walkBehindExists[ee]) {
-          walkBehindStartY[ee] = rr;
-          walkBehindExists[ee] = tmm;
-          noWalkBehindsAtAll = 0;
-        }
-        walkBehindEndY[ee] = rr + 1;  // +1 to allow bottom line of screen to work
-
-        if (ee < walkBehindLeft[tmm]) walkBehindLeft[tmm] = ee;
-        if (rr < walkBehindTop[tmm]) walkBehindTop[tmm] = rr;
-        if (ee > walkBehindRight[tmm]) walkBehindRight[tmm] = ee;
-        if (rr > walkBehindBottom[tmm]) walkBehindBottom[tmm] = rr;
+  const int mask_width = thisroom.WalkBehindMask->GetWidth();
+  for (rr=0;rr<thisroom.WalkBehindMask->GetHeight();rr++) {
+    const uint8_t *scanline = thisroom.WalkBehindMask->GetScanLine(rr);
+    for (ee=0;ee<mask_width;) {
+      tmm = scanline[ee];
+      if ((tmm < 1) || (tmm >= MAX_WALK_BEHINDS)) {
+        ee++;
+        continue;
       }
+      // find where the run of this area ends
+      int run_end = ee + 1;
+      while ((run_end < mask_width) && (scanline[run_end] == tmm))
+        run_end++;
+      walkBehindRuns.push_back(WalkBehindRun(ee, run_end, tmm));
+      noWalkBehindsAtAll = 0;
+
+      if (ee < walkBehindLeft[tmm]) walkBehindLeft[tmm] = ee;
+      if (rr < walkBehindTop[tmm]) walkBehindTop[tmm] = rr;
+      if (run_end - 1 > walkBehindRight[tmm]) walkBehindRight[tmm] = run_end - 1;
+      if (rr > walkBehindBottom[tmm]) walkBehindBottom[tmm] = rr;
+      ee = run_end;
     }
+    walkBehindRowRuns[rr + 1] = walkBehindRuns.size();
   }
 
   if (walkBehindMethod == DrawAsSeparateSprite)
@@ -18,6 +18,9 @@
 #ifndef __AGS_EE_AC__WALKBEHIND_H
 #define __AGS_EE_AC__WALKBEHIND_H
 
+#include <stddef.h>
+#include <vector>
+
 enum WalkBehindMethodEnum
 {
     DrawOverCharSprite,
@@ -25,6 +28,22 @@ enum WalkBehindMethodEnum
     DrawAsSeparateCharSprite
 };
 
+// Horizontal run of pixels belonging to the same walk-behind area
+struct WalkBehindRun
+{
+    int X1;   // first column
+    int X2;   // column past the last one
+    int Area; // walk-behind area index
+
+    WalkBehindRun(int x1, int x2, int area) : X1(x1), X2(x2), Area(area) {}
+};
+// Runs of walk-behind mask pixels, found by recache_walk_behinds; they are
+// stored row after row, sorted by X1 within each row
+extern std::vector<WalkBehindRun> walkBehindRuns;
+// Index of the first run of each mask row in walkBehindRuns; has an extra
+// element at the end, so that row N runs end where the row N + 1 begin
+extern std::vector<size_t> walkBehindRowRuns;
+
 void update_walk_behind_images();
 void recache_walk_behinds ();
 
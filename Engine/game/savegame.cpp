@@ -49,10 +49,13 @@
 #include "script/script.h"
 #include "script/cc_error.h"
 #include "util/alignedstream.h"
+#include "util/compress.h"
 #include "util/file.h"
+#include "util/memorystream.h"
 #include "util/stream.h"
 #include "util/string_utils.h"
 #include "media/audio/audio_system.h"
+#include <thread>
 
 using namespace Common;
 using namespace Engine;
@@ -89,6 +92,11 @@ SavegameDescription::SavegameDescription()
 {
 }
 
+SavegameBuffer::SavegameBuffer()
+    : Compression(kSvgCompress_None)
+{
+}
+
 PreservedParams::PreservedParams()
     : SpeechVOX(0)
     , MusicVOX(0)
@@ -267,8 +275,40 @@ HSaveError ReadDescription_v321(Stream *in, SavegameVersion &svg_ver, SavegameDe
     return HSaveError::None();
 }
 
+// Reads the compression method of the game data, and replaces the stream
+// with the memory stream of unpacked data if it was compressed
+HSaveError OpenSavegameData(UStream &in)
+{
+    SavegameCompression compression = (SavegameCompression)in->ReadInt32();
+    switch (compression)
+    {
+    case kSvgCompress_None:
+        return HSaveError::None();
+    case kSvgCompress_LZ4:
+        break;
+    default:
+        return new SavegameError(kSvgErr_InconsistentFormat,
+            String::FromFormat("Unknown game data compression: %d.", compression));
+    }
+
+    const soff_t data_size = in->ReadInt64();
+    const soff_t packed_size = in->ReadInt64();
+    // LZ4 cannot pack data better than about 255:1
+    if (packed_size <= 0 || packed_size > in->GetLength() - in->GetPosition() ||
+        data_size <= 0 || data_size / 255 > packed_size)
+        return new SavegameError(kSvgErr_InconsistentFormat, "Invalid compressed game data size.");
+    std::vector<uint8_t> packed((size_t)packed_size);
+    in->Read(&packed.front(), packed.size());
+    std::vector<uint8_t> data((size_t)data_size);
+    if (!lz4_decompress(&packed.front(), packed.size(), &data.front(), data.size()))
+        return new SavegameError(kSvgErr_InconsistentData, "Failed to unpack game data.");
+    in.reset(new MemoryStream(std::move(data), kFile_Read));
+    return HSaveError::None();
+}
+
 HSaveError OpenSavegameBase(const String &filename, SavegameSource *src, SavegameDescription *desc, SavegameDescElem elems)
 {
+    WaitForSavegameWrite();
     UStream in(File::OpenFileRead(filename));
     if (!in.get())
         return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Requested filename: %s.", filename.GetCStr()));
@@ -305,6 +345,13 @@ HSaveError OpenSavegameBase(const String &filename, SavegameSource *src, Savegam
 
     if (src)
     {
+        // Unpack the game data, if it was compressed
+        if (is_new_save && svg_ver >= kSvgVersion_Compressed)
+        {
+            err = OpenSavegameData(in);
+            if (!err)
+                return err;
+        }
         src->Filename = filename;
         src->Version = svg_ver;
         src->InputStream.reset(in.release()); // give the stream away to the caller
@@ -626,7 +673,7 @@ HSaveError DoAfterRestore(const PreservedParams &pp, const RestoredData &r_data)
         int pos = r_data.AudioChans[i].Pos;
         if ((pos > 0) && (ch != nullptr))
         {
-            ch->seek(pos);
+            seek_clip(ch, pos);
         }
     }
     } // -- AudioChannelsLock
@@ -730,12 +777,24 @@ void WriteDescription(Stream *out, const String &user_text, const Bitmap *user_i
     WriteSaveImage(out, user_image);
 }
 
-PStream StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image)
+void DoBeforeSave()
 {
-    Stream *out = Common::File::CreateFile(filename);
-    if (!out)
-        return PStream();
+    if (play.cur_music_number >= 0)
+    {
+        if (IsMusicPlaying() == 0)
+            play.cur_music_number = -1;
+    }
 
+    if (displayed_room >= 0)
+    {
+        // update the current room script's data segment copy
+        if (roominst)
+            save_room_data_segment();
+    }
+}
+
+void WriteRichMediaHeader(Stream *out, const String &user_text)
+{
     // Initialize and write Vista header
     RICH_GAME_MEDIA_HEADER vistaHeader;
     memset(&vistaHeader, 0, sizeof(RICH_GAME_MEDIA_HEADER));
@@ -752,38 +811,119 @@ PStream StartSavegame(const String &filename, const String &user_text, const Bit
     vistaHeader.szComments[0] = 0;
     // MS Windows Vista rich media header
     vistaHeader.WriteToFile(out);
+}
 
+void SaveGameState(SavegameBuffer &svg, const String &user_text, const Bitmap *user_image,
+                   SavegameCompression compression)
+{
+    MemoryStream header;
+    WriteRichMediaHeader(&header, user_text);
     // Savegame signature
-    out->Write(SavegameSource::Signature.GetCStr(), SavegameSource::Signature.GetLength());
+    header.Write(SavegameSource::Signature.GetCStr(), SavegameSource::Signature.GetLength());
+
+    // Write descrition block
+    WriteDescription(&header, user_text, user_image);
+    // Game data compression method
+    header.WriteInt32(compression);
+    header.ReleaseBuffer(svg.Header);
+    svg.Compression = compression;
 
+    SaveGameData(svg.Data);
+}
+
+void SaveGameData(std::vector<uint8_t> &data)
+{
     // CHECKME: what is this plugin hook suppose to mean, and if it is called here correctly
     pl_run_plugin_hooks(AGSE_PRESAVEGAME, 0);
 
-    // Write descrition block
-    WriteDescription(out, user_text, user_image);
-    return PStream(out);
+    DoBeforeSave();
+    std::shared_ptr<MemoryStream> out(new MemoryStream());
+    SavegameComponents::WriteAllCommon(out);
+    out->ReleaseBuffer(data);
 }
 
-void DoBeforeSave()
+// Writes the prepared savegame into the file; this may be run on any thread
+bool WriteSavegameFile(Stream *out, SavegameBuffer &svg)
 {
-    if (play.cur_music_number >= 0)
+    out->Write(&svg.Header.front(), svg.Header.size());
+    if (svg.Compression == kSvgCompress_LZ4)
     {
-        if (IsMusicPlaying() == 0)
-            play.cur_music_number = -1;
+        std::vector<uint8_t> packed;
+        lz4_compress(&svg.Data.front(), svg.Data.size(), packed);
+        out->WriteInt64(svg.Data.size());
+        out->WriteInt64(packed.size());
+        out->Write(&packed.front(), packed.size());
+    }
+    else
+    {
+        out->Write(&svg.Data.front(), svg.Data.size());
     }
 
-    if (displayed_room >= 0)
+    if (!svg.RichMediaImage.empty())
     {
-        // update the current room script's data segment copy
-        if (roominst)
-            save_room_data_segment();
+        int screenShotOffset = out->GetPosition() - sizeof(RICH_GAME_MEDIA_HEADER);
+        int screenShotSize = svg.RichMediaImage.size();
+        out->Write(&svg.RichMediaImage.front(), svg.RichMediaImage.size());
+        out->Seek(12, kSeekBegin);
+        out->WriteInt32(screenShotOffset);
+        out->Seek(4);
+        out->WriteInt32(screenShotSize);
     }
+    return !out->HasErrors();
 }
 
-void SaveGameState(PStream out)
+// Savegame which is being written on the separate thread
+struct SavegameWriteJob
 {
-    DoBeforeSave();
-    SavegameComponents::WriteAllCommon(out);
+    String          Filename;
+    UStream         Out;
+    SavegameBuffer  Svg;
+    bool            Success;
+
+    SavegameWriteJob() : Success(false) {}
+};
+
+static std::thread svg_write_thread;
+static std::unique_ptr<SavegameWriteJob> svg_write_job;
+
+static void SavegameWriteThread(SavegameWriteJob *job)
+{
+    job->Success = WriteSavegameFile(job->Out.get(), job->Svg);
+    job->Out.reset(); // close the file
+}
+
+bool WriteSavegame(const String &filename, SavegameBuffer &&svg, bool async)
+{
+    WaitForSavegameWrite();
+    UStream out(File::CreateFile(filename));
+    if (!out)
+        return false;
+
+    if (!async)
+    {
+        if (!WriteSavegameFile(out.get(), svg))
+            Debug::Printf(kDbgMsg_Error, "Error writing savegame '%s'.", filename.GetCStr());
+        return true;
+    }
+
+    svg_write_job.reset(new SavegameWriteJob());
+    svg_write_job->Filename = filename;
+    svg_write_job->Out = std::move(out);
+    svg_write_job->Svg = std::move(svg);
+    svg_write_thread = std::thread(SavegameWriteThread, svg_write_job.get());
+    return true;
+}
+
+void WaitForSavegameWrite()
+{
+    if (svg_write_thread.joinable())
+        svg_write_thread.join();
+    if (svg_write_job)
+    {
+        if (!svg_write_job->Success)
+            Debug::Printf(kDbgMsg_Error, "Error writing savegame '%s'.", svg_write_job->Filename.GetCStr());
+        svg_write_job.reset();
+    }
 }
 
 } // namespace Engine
@@ -16,6 +16,7 @@
 #define __AGS_EE_GAME__SAVEGAME_H
 
 #include <memory>
+#include <vector>
 #include "ac/game_version.h"
 #include "util/error.h"
 #include "util/version.h"
@@ -43,6 +44,7 @@ typedef std::shared_ptr<Stream> PStream;
 //
 // 8      last old style saved game format (of AGS 3.2.1)
 // 9      first new style (self-descriptive block-based) format version
+// 13     game data may be compressed, the method is written after description
 //-----------------------------------------------------------------------------
 enum SavegameVersion
 {
@@ -52,7 +54,8 @@ enum SavegameVersion
     kSvgVersion_Cmp_64bit = 10,
     kSvgVersion_350_final = 11,
     kSvgVersion_350_final2= 12,
-    kSvgVersion_Current   = kSvgVersion_350_final2,
+    kSvgVersion_Compressed= 13,
+    kSvgVersion_Current   = kSvgVersion_Compressed,
     kSvgVersion_LowestSupported = kSvgVersion_321 // change if support dropped
 };
 
@@ -85,6 +88,13 @@ enum SavegameErrorType
 
 String GetSavegameErrorText(SavegameErrorType err);
 
+// Compression method of the game data in savegame
+enum SavegameCompression
+{
+    kSvgCompress_None = 0,
+    kSvgCompress_LZ4  = 1
+};
+
 typedef TypedCodeError<SavegameErrorType, GetSavegameErrorText> SavegameError;
 typedef ErrorHandle<SavegameError> HSaveError;
 typedef std::unique_ptr<Stream> UStream;
@@ -157,11 +167,38 @@ HSaveError     OpenSavegame(const String &filename, SavegameDescription &desc, S
 // Reads the game data from the save stream and reinitializes game state
 HSaveError     RestoreGameState(PStream in, SavegameVersion svg_version);
 
-// Opens savegame for writing and puts in savegame description
-PStream        StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image);
+// SavegameBuffer is a complete savegame serialized into memory, which may be
+// written to disk all at once, without stopping the game for the disk I/O
+struct SavegameBuffer
+{
+    // Rich media header, signature and savegame description
+    std::vector<uint8_t> Header;
+    // Game state data, not compressed yet
+    std::vector<uint8_t> Data;
+    // Screenshot image in BMP format, for the rich media header (optional)
+    std::vector<uint8_t> RichMediaImage;
+    // Compression method to apply to the game data when writing the file
+    SavegameCompression  Compression;
+
+    SavegameBuffer();
+};
 
-// Prepares game for saving state and writes game data into the save stream
-void           SaveGameState(PStream out);
+// Prepares game for saving state and serializes savegame description and
+// game data into the memory buffer
+void           SaveGameState(SavegameBuffer &svg, const String &user_text, const Bitmap *user_image,
+                             SavegameCompression compression);
+// Prepares game for saving state and serializes only the game data into
+// the memory buffer; it may be restored by RestoreGameState using
+// the current savegame version
+void           SaveGameData(std::vector<uint8_t> &data);
+// Creates savegame file and writes the prepared savegame into it, compressing
+// the game data if requested; if async is set, then the data is compressed
+// and written on a separate thread, and the function returns immediately.
+// Returns false if the file could not be created.
+bool           WriteSavegame(const String &filename, SavegameBuffer &&svg, bool async);
+// Waits until the savegame being written in background is completed;
+// must be called before accessing the savegame files
+void           WaitForSavegameWrite();
 
 } // namespace Engine
 } // namespace AGS
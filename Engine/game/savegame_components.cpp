@@ -373,6 +373,7 @@ HSaveError WriteAudio(PStream out)
         if ((ch != nullptr) && (ch->sourceClip != nullptr))
         {
             out->WriteInt32(((ScriptAudioClip*)ch->sourceClip)->id);
+            wait_clip_seek(ch);
             out->WriteInt32(ch->get_pos());
             out->WriteInt32(ch->priority);
             out->WriteInt32(ch->repeat ? 1 : 0);
@@ -0,0 +1,103 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <algorithm>
+#include "game/savestate.h"
+#include "util/compress.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// The difference is the older state XORed with the newer one; the bytes
+// past the end of the newer state are kept as they are
+static void XorStates(std::vector<uint8_t> &state, const std::vector<uint8_t> &next)
+{
+    const size_t common_size = std::min(state.size(), next.size());
+    for (size_t i = 0; i < common_size; ++i)
+        state[i] ^= next[i];
+}
+
+SaveStateRing::SaveStateRing()
+    : _maxCount(0)
+    , _useDelta(false)
+{
+}
+
+void SaveStateRing::SetOptions(size_t max_count, bool use_delta)
+{
+    Clear();
+    _maxCount = max_count;
+    _useDelta = use_delta;
+}
+
+void SaveStateRing::Push(std::vector<uint8_t> &&data)
+{
+    if (_maxCount == 0 || data.empty())
+        return;
+
+    if (_states.size() == _maxCount)
+        _states.pop_front();
+    // Store the previous newest state as the difference from the new one
+    if (_useDelta && !_states.empty())
+    {
+        State &prev = _states.back();
+        XorStates(prev.Data, data);
+        std::vector<uint8_t> packed;
+        lz4_compress(&prev.Data.front(), prev.Data.size(), packed);
+        prev.Data.swap(packed);
+        prev.IsDelta = true;
+    }
+
+    State state;
+    state.Size = data.size();
+    state.Data = std::move(data);
+    _states.push_back(std::move(state));
+}
+
+bool SaveStateRing::Get(size_t index, std::vector<uint8_t> &data) const
+{
+    if (index >= _states.size())
+        return false;
+
+    const size_t newest = _states.size() - 1;
+    if (!_states[newest - index].IsDelta)
+    {
+        data = _states[newest - index].Data;
+        return true;
+    }
+
+    // Go back from the newest state, applying the differences
+    data = _states[newest].Data;
+    std::vector<uint8_t> prev_data;
+    for (size_t i = newest; i-- > newest - index;)
+    {
+        const State &prev = _states[i];
+        prev_data.resize(prev.Size);
+        if (!lz4_decompress(&prev.Data.front(), prev.Data.size(), &prev_data.front(), prev_data.size()))
+            return false;
+        XorStates(prev_data, data);
+        data.swap(prev_data);
+    }
+    return true;
+}
+
+void SaveStateRing::Clear()
+{
+    _states.clear();
+}
+
+} // namespace Engine
+} // namespace AGS
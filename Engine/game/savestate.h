@@ -0,0 +1,82 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// SaveStateRing keeps a limited number of the game states serialized into
+// memory, which may be restored without any file I/O. When the ring is full,
+// the newest state replaces the oldest one.
+//
+// Optionally, all states except the newest are stored as the difference
+// from the next state, packed with LZ4. The consecutive states are usually
+// almost the same, so the differences pack very well. Restoring the newest
+// state is always instant; restoring an older one requires unpacking all
+// the differences after it.
+//
+//=============================================================================
+#ifndef __AGS_EE_GAME__SAVESTATE_H
+#define __AGS_EE_GAME__SAVESTATE_H
+
+#include <deque>
+#include <vector>
+#include "core/types.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+class SaveStateRing
+{
+public:
+    SaveStateRing();
+
+    // Sets the maximal number of kept states and whether the older states
+    // are stored as differences; removes all current states
+    void   SetOptions(size_t max_count, bool use_delta);
+    // Tells the maximal number of kept states; 0 means the ring is disabled
+    inline size_t GetMaxCount() const { return _maxCount; }
+    // Tells the number of currently kept states
+    inline size_t GetCount() const { return _states.size(); }
+
+    // Adds a new state, removing the oldest one if the ring is full
+    void   Push(std::vector<uint8_t> &&data);
+    // Gets the state data; index 0 is the newest state, 1 is the one
+    // before it, and so forth. Returns false if there's no such state, or
+    // if its data could not be unpacked.
+    bool   Get(size_t index, std::vector<uint8_t> &data) const;
+    // Removes all states
+    void   Clear();
+
+private:
+    struct State
+    {
+        // Full state data for the newest state, or the packed difference
+        // from the next state for the older ones
+        std::vector<uint8_t> Data;
+        // Size of the state data when unpacked
+        size_t               Size;
+        bool                 IsDelta;
+
+        State() : Size(0), IsDelta(false) {}
+    };
+
+    size_t            _maxCount;
+    bool              _useDelta;
+    // States from the oldest to the newest
+    std::deque<State> _states;
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GAME__SAVESTATE_H
@@ -1058,6 +1058,7 @@ void OGLGraphicsDriver::ReleaseDisplayMode()
   DeleteBackbufferTexture();
   DestroyFxPool();
   DestroyAllStageScreens();
+  std::vector<char>().swap(_texUploadBuffer);
 
   gfx_driver = nullptr;
 
@@ -1670,7 +1671,10 @@ void OGLGraphicsDriver::UpdateTextureRegion(OGLTextureTile *tile, Bitmap *bitmap
   }
 
   const bool usingLinearFiltering = _filter->UseLinearFiltering();
-  char *origPtr = (char*)malloc(sizeof(int) * tileWidth * tileHeight);
+  const size_t bufferSize = sizeof(int) * tileWidth * tileHeight;
+  if (_texUploadBuffer.size() < bufferSize)
+    _texUploadBuffer.resize(bufferSize);
+  char *origPtr = &_texUploadBuffer.front();
   const int pitch = tileWidth * sizeof(int);
   char *memPtr = origPtr + pitch * tiley + tilex * sizeof(int);
 
@@ -1725,8 +1729,6 @@ void OGLGraphicsDriver::UpdateTextureRegion(OGLTextureTile *tile, Bitmap *bitmap
 
   glBindTexture(GL_TEXTURE_2D, tile->texture);
   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileWidth, tileHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
-
-  free(origPtr);
 }
 
 void OGLGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha)
@@ -194,6 +194,7 @@ public:
     void Render(int xoff, int yoff, GlobalFlipType flip) override;
     bool GetCopyOfScreenIntoBitmap(Bitmap *destination, bool at_native_res, GraphicResolution *want_fmt) override;
     void EnableVsyncBeforeRender(bool enabled) override { }
+    void EnablePipelinedPresent(bool enabled) override { }
     void Vsync() override;
     void RenderSpritesAtScreenResolution(bool enabled, int supersampling) override;
     void FadeOut(int speed, int targetColourRed, int targetColourGreen, int targetColourBlue) override;
@@ -282,6 +283,9 @@ private:
     // find out if it's possible to reimplement these effects in main drawing routine.
     SpriteBatchDescs _backupBatchDescs;
     OGLSpriteBatches _backupBatches;
+    // Scratch buffer for converting bitmap pixels before uploading them to
+    // the texture; kept between the calls to avoid reallocating it per tile
+    std::vector<char> _texUploadBuffer;
 
     void InitSpriteBatch(size_t index, const SpriteBatchDesc &desc) override;
     void ResetAllBatches() override;
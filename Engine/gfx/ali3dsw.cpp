@@ -18,6 +18,10 @@
 
 #include "gfx/ali3dsw.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include "core/platform.h"
 #include "gfx/ali3dexception.h"
 #include "gfx/gfxfilter_allegro.h"
@@ -26,6 +30,7 @@
 #include "main/main_allegro.h"
 #include "platform/base/agsplatformdriver.h"
 #include "ac/timer.h"
+#include "debug/out.h"
 
 #if AGS_DDRAW_GAMMA_CONTROL
 // NOTE: this struct and variables are defined internally in Allegro
@@ -71,12 +76,36 @@ unsigned long _trans_alpha_blender32(unsigned long x, unsigned long y, unsigned
 RGB faded_out_palette[256];
 
 
+// State of the pipelined presentation, shared with the presenting thread.
+// Only the frame copy and the parameters below cross the thread boundary:
+// the sprite lists are rasterized and the frame is flipped on the game
+// thread, because the sprite bitmaps, virtual screen and Allegro's blender
+// settings belong to it.
+struct ALSoftwareGraphicsDriver::PresentQueue
+{
+    AllegroGfxFilter *Filter = nullptr;
+    std::unique_ptr<Bitmap> Frame; // copy of the rendered virtual screen
+    int XOff = 0;
+    int YOff = 0;
+    bool Vsync = false;
+    std::thread Thread;
+    std::mutex Mutex;
+    std::condition_variable FrameCond; // signals new frame or stop
+    std::condition_variable DoneCond;  // signals that the frame was displayed
+    bool HasFrame = false; // frame is waiting to be displayed
+    bool Busy = false;     // frame is being displayed
+    bool Stop = false;
+};
+
+
 ALSoftwareGraphicsDriver::ALSoftwareGraphicsDriver()
 {
   _tint_red = 0;
   _tint_green = 0;
   _tint_blue = 0;
   _autoVsync = false;
+  _pipelinedPresent = false;
+  _directScreen = false;
   //_spareTintingScreen = nullptr;
   _gfxModeList = nullptr;
 #if AGS_DDRAW_GAMMA_CONTROL
@@ -181,6 +210,7 @@ int ALSoftwareGraphicsDriver::GetAllegroGfxDriverID(bool windowed)
 
 void ALSoftwareGraphicsDriver::SetGraphicsFilter(PALSWFilter filter)
 {
+  StopPresentThread();
   _filter = filter;
   OnSetFilter();
 
@@ -225,12 +255,14 @@ void ALSoftwareGraphicsDriver::CreateVirtualScreen()
 {
   if (!IsModeSet() || !IsRenderFrameValid() || !IsNativeSizeValid() || !_filter)
     return;
+  StopPresentThread();
   DestroyVirtualScreen();
   // Adjust clipping so nothing gets drawn outside the game frame
   _allegroScreenWrapper->SetClip(_dstRect);
   // Initialize scaling filter and receive virtual screen pointer
   // (which may or not be the same as real screen)
   _origVirtualScreen = _filter->InitVirtualScreen(_allegroScreenWrapper, _srcRect.GetSize(), _dstRect);
+  _directScreen = _origVirtualScreen == _allegroScreenWrapper;
   // Apparently we must still create a virtual screen even if its same size and color depth,
   // because drawing sprites directly on real screen bitmap causes blinking (unless I missed something here...)
   if (_origVirtualScreen == _allegroScreenWrapper)
@@ -256,6 +288,7 @@ void ALSoftwareGraphicsDriver::DestroyVirtualScreen()
 
 void ALSoftwareGraphicsDriver::ReleaseDisplayMode()
 {
+  StopPresentThread();
   OnModeReleased();
   ClearDrawLists();
 
@@ -285,6 +318,7 @@ bool ALSoftwareGraphicsDriver::SetRenderFrame(const Rect &dst_rect)
 void ALSoftwareGraphicsDriver::ClearRectangle(int x1, int y1, int x2, int y2, RGB *colorToUse)
 {
   if (!_filter) return;
+  WaitForPresent();
   int color = 0;
   if (colorToUse != nullptr) 
     color = makecol_depth(_mode.ColorDepth, colorToUse->r, colorToUse->g, colorToUse->b);
@@ -482,8 +516,11 @@ void ALSoftwareGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, Com
     else if (drawlist[i].bitmap == (ALSoftwareBitmap*)0x1)
     {
       // draw screen tint fx
-      set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
-      surface->LitBlendBlt(surface, 0, 0, 128);
+      if (!GfxUtil::BlendSpriteLit32(surface, surface, 0, 0, makecol32(_tint_red, _tint_green, _tint_blue), 128))
+      {
+        set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
+        surface->LitBlendBlt(surface, 0, 0, 128);
+      }
       continue;
     }
 
@@ -502,13 +539,18 @@ void ALSoftwareGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, Com
     }
     else if (bitmap->_hasAlpha)
     {
-      if (bitmap->_transparency == 0) // no global transparency, simple alpha blend
-        set_alpha_blender();
-      else
-        // here _transparency is used as alpha (between 1 and 254)
-        set_blender_mode(nullptr, nullptr, _trans_alpha_blender32, 0, 0, 0, bitmap->_transparency);
+      // here _transparency is used as alpha (between 1 and 254), but 0 means no global transparency;
+      // sprite's alpha is multiplied same way as in the per-pixel blenders below
+      const int alpha_mul = bitmap->_transparency == 0 ? 256 : bitmap->_transparency;
+      if (!GfxUtil::BlendSpriteAlpha32(surface, bitmap->_bmp, drawAtX, drawAtY, alpha_mul))
+      {
+        if (bitmap->_transparency == 0) // no global transparency, simple alpha blend
+          set_alpha_blender();
+        else
+          set_blender_mode(nullptr, nullptr, _trans_alpha_blender32, 0, 0, 0, bitmap->_transparency);
 
-      surface->TransBlendBlt(bitmap->_bmp, drawAtX, drawAtY);
+        surface->TransBlendBlt(bitmap->_bmp, drawAtX, drawAtY);
+      }
     }
     else
     {
@@ -537,6 +579,12 @@ void ALSoftwareGraphicsDriver::Render(int xoff, int yoff, GlobalFlipType flip)
 {
   RenderToBackBuffer();
 
+  // NOTE: 8-bit modes are presented directly, as the palette may be changed
+  // by the game at any moment; same if the filter does not have its own
+  // virtual screen, and draws on the real screen
+  if (_pipelinedPresent && !_directScreen && _mode.ColorDepth > 8 && PresentFrame(xoff, yoff, flip))
+    return;
+
   if (_autoVsync)
     this->Vsync();
 
@@ -551,6 +599,111 @@ void ALSoftwareGraphicsDriver::Render()
   Render(0, 0, kFlip_None);
 }
 
+void ALSoftwareGraphicsDriver::EnablePipelinedPresent(bool enabled)
+{
+  _pipelinedPresent = enabled;
+  if (!enabled)
+    StopPresentThread();
+}
+
+bool ALSoftwareGraphicsDriver::PresentFrame(int xoff, int yoff, GlobalFlipType flip)
+{
+  if (!_present)
+  {
+    _present.reset(new PresentQueue());
+    _present->Filter = _filter.get();
+    try
+    {
+      _present->Thread = std::thread(PresentThread, _present.get());
+    }
+    catch (const std::system_error &)
+    {
+      Debug::Printf(kDbgMsg_Error, "Failed to start the presenting thread, using direct presentation");
+      _present.reset();
+      _pipelinedPresent = false;
+      return false;
+    }
+  }
+
+  std::unique_lock<std::mutex> lk(_present->Mutex);
+  _present->DoneCond.wait(lk, [this]() { return !_present->HasFrame && !_present->Busy; });
+  Bitmap *frame = _present->Frame.get();
+  if (!frame || frame->GetWidth() != virtualScreen->GetWidth() ||
+      frame->GetHeight() != virtualScreen->GetHeight() || frame->GetColorDepth() != virtualScreen->GetColorDepth())
+  {
+    frame = new Bitmap(virtualScreen->GetWidth(), virtualScreen->GetHeight(), virtualScreen->GetColorDepth());
+    _present->Frame.reset(frame);
+  }
+  switch (flip)
+  {
+  case kFlip_Horizontal:
+    frame->FlipBlt(virtualScreen, 0, 0, Common::kBitmap_HFlip);
+    break;
+  case kFlip_Vertical:
+    frame->FlipBlt(virtualScreen, 0, 0, Common::kBitmap_VFlip);
+    break;
+  case kFlip_Both:
+    frame->FlipBlt(virtualScreen, 0, 0, Common::kBitmap_HVFlip);
+    break;
+  default:
+    frame->Blit(virtualScreen, 0, 0, 0, 0, virtualScreen->GetWidth(), virtualScreen->GetHeight());
+    break;
+  }
+  _present->XOff = xoff;
+  _present->YOff = yoff;
+  _present->Vsync = _autoVsync;
+  _present->HasFrame = true;
+  _present->FrameCond.notify_one();
+  return true;
+}
+
+void ALSoftwareGraphicsDriver::PresentThread(PresentQueue *queue)
+{
+  std::unique_lock<std::mutex> lk(queue->Mutex);
+  for (;;)
+  {
+    queue->FrameCond.wait(lk, [queue]() { return queue->Stop || queue->HasFrame; });
+    if (queue->Stop)
+      break;
+    queue->HasFrame = false;
+    queue->Busy = true;
+    lk.unlock();
+
+    if (queue->Vsync)
+      vsync();
+    // the frame is already flipped, if needed
+    queue->Filter->RenderScreen(queue->Frame.get(), queue->XOff, queue->YOff);
+
+    lk.lock();
+    queue->Busy = false;
+    queue->DoneCond.notify_all();
+  }
+}
+
+void ALSoftwareGraphicsDriver::WaitForPresent()
+{
+  if (!_present)
+    return;
+  std::unique_lock<std::mutex> lk(_present->Mutex);
+  _present->DoneCond.wait(lk, [this]() { return !_present->HasFrame && !_present->Busy; });
+}
+
+void ALSoftwareGraphicsDriver::StopPresentThread()
+{
+  if (!_present)
+    return;
+  WaitForPresent();
+  {
+    std::lock_guard<std::mutex> lk(_present->Mutex);
+    _present->Stop = true;
+    _present->FrameCond.notify_all();
+  }
+  _present->Thread.join();
+  // the filter must not refer to the queued frame after it's gone
+  _present->Filter->ForgetRenderSource(_present->Frame.get());
+  _present.reset();
+}
+
 void ALSoftwareGraphicsDriver::Vsync()
 {
   vsync();
@@ -596,6 +749,7 @@ bool ALSoftwareGraphicsDriver::GetCopyOfScreenIntoBitmap(Bitmap *destination, bo
         *want_fmt = GraphicResolution(destination->GetWidth(), destination->GetHeight(), _mode.ColorDepth);
     return false;
   }
+  WaitForPresent();
   _filter->GetCopyOfScreenIntoBitmap(destination);
   return true;
 }
@@ -619,8 +773,11 @@ void ALSoftwareGraphicsDriver::highcolor_fade_in(Bitmap *vs, void(*draw_callback
    for (int a = 0; a < 256; a+=speed)
    {
        bmp_buff->Fill(clearColor);
-       set_trans_blender(0,0,0,a);
-       bmp_buff->TransBlendBlt(bmp_orig, 0, 0);
+       if (!GfxUtil::BlendSpriteTrans32(bmp_buff, bmp_orig, 0, 0, a))
+       {
+           set_trans_blender(0,0,0,a);
+           bmp_buff->TransBlendBlt(bmp_orig, 0, 0);
+       }
        if (draw_callback)
        {
            draw_callback();
@@ -655,8 +812,11 @@ void ALSoftwareGraphicsDriver::highcolor_fade_out(Bitmap *vs, void(*draw_callbac
     for (int a = 255 - speed; a > 0; a -= speed)
     {
         bmp_buff->Fill(clearColor);
-        set_trans_blender(0, 0, 0, a);
-        bmp_buff->TransBlendBlt(bmp_orig, 0, 0);
+        if (!GfxUtil::BlendSpriteTrans32(bmp_buff, bmp_orig, 0, 0, a))
+        {
+            set_trans_blender(0, 0, 0, a);
+            bmp_buff->TransBlendBlt(bmp_orig, 0, 0);
+        }
         if (draw_callback)
         {
             draw_callback();
@@ -720,6 +880,7 @@ void ALSoftwareGraphicsDriver::__fade_out_range(int speed, int from, int to, int
 }
 
 void ALSoftwareGraphicsDriver::FadeOut(int speed, int targetColourRed, int targetColourGreen, int targetColourBlue) {
+  WaitForPresent();
   if (_mode.ColorDepth > 8) 
   {
     highcolor_fade_out(virtualScreen, _drawPostScreenCallback, 0, 0, speed * 4, targetColourRed, targetColourGreen, targetColourBlue);
@@ -731,6 +892,7 @@ void ALSoftwareGraphicsDriver::FadeOut(int speed, int targetColourRed, int targe
 }
 
 void ALSoftwareGraphicsDriver::FadeIn(int speed, PALETTE p, int targetColourRed, int targetColourGreen, int targetColourBlue) {
+  WaitForPresent();
   if (_drawScreenCallback)
   {
     _drawScreenCallback();
@@ -749,6 +911,7 @@ void ALSoftwareGraphicsDriver::FadeIn(int speed, PALETTE p, int targetColourRed,
 
 void ALSoftwareGraphicsDriver::BoxOutEffect(bool blackingOut, int speed, int delay)
 {
+  WaitForPresent();
   if (blackingOut)
   {
     int yspeed = _srcRect.GetHeight() / (_srcRect.GetWidth() / speed);
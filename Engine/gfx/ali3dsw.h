@@ -180,6 +180,7 @@ public:
     void SetGamma(int newGamma) override;
     void UseSmoothScaling(bool enabled) override { }
     void EnableVsyncBeforeRender(bool enabled) override { _autoVsync = enabled; }
+    void EnablePipelinedPresent(bool enabled) override;
     void Vsync() override;
     void RenderSpritesAtScreenResolution(bool enabled, int supersampling) override { }
     bool RequiresFullRedrawEachFrame() override { return false; }
@@ -200,6 +201,13 @@ private:
     int _gamma;
 
     bool _autoVsync;
+    // Pipelined presentation: the rendered frame is copied and handed over
+    // to the presenting thread, which scales it to the real screen
+    struct PresentQueue;
+    bool _pipelinedPresent;
+    // Filter draws directly on the real screen, which disables pipelining
+    bool _directScreen;
+    std::unique_ptr<PresentQueue> _present;
     Bitmap *_allegroScreenWrapper;
     // Virtual screen bitmap is either a wrapper over Allegro's real screen
     // bitmap, or bitmap provided by the graphics filter. It should not be
@@ -238,6 +246,16 @@ private:
     void ReleaseDisplayMode();
     // Renders single sprite batch on the precreated surface
     void RenderSpriteBatch(const ALSpriteBatch &batch, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Passes rendered virtual screen to the presenting thread;
+    // returns false if the thread could not be started
+    bool PresentFrame(int xoff, int yoff, GlobalFlipType flip);
+    // Waits until the presenting thread has finished displaying last frame;
+    // must be called before accessing the real screen or gfx filter directly
+    void WaitForPresent();
+    // Stops the presenting thread, if one is running
+    void StopPresentThread();
+    // Presenting thread's loop
+    static void PresentThread(PresentQueue *queue);
 
     void highcolor_fade_in(Bitmap *vs, void(*draw_callback)(), int offx, int offy, int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
     void highcolor_fade_out(Bitmap *vs, void(*draw_callback)(), int offx, int offy, int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
@@ -16,6 +16,11 @@
 #include "gfx/blender.h"
 #include "util/wgt2allg.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_BLEND_SSE2
+#include <emmintrin.h>
+#endif
+
 extern "C" {
     // Fallback routine for when we don't have anything better to do.
     unsigned long _blender_black(unsigned long x, unsigned long y, unsigned long n);
@@ -298,3 +303,140 @@ void set_argb2any_blender()
         _blender_alpha15, skiptranspixels_blender_alpha16, _blender_alpha24,
         0, 0, 0, 0xff); // TODO: do we need to support proper 15- and 24-bit here?
 }
+
+
+//
+// Span blenders.
+// Allegro's blenders calculate each color component as
+//   y + (x - y) * n / 256
+// where n is the alpha value + 1 (or 0 if alpha was 0); here this is done
+// as (x * n + y * (256 - n)) / 256, which gives same result but does not
+// need a signed intermediate value.
+// Because per-pixel blenders add unmasked y to the red & blue result, the
+// green component of y also takes part in rounding of the red one; this is
+// reproduced here, so that the results are exactly the same.
+//
+
+// Blends RGB components of two pixels; resulting alpha is zero
+FORCEINLINE uint32_t blend_rgb(uint32_t x, uint32_t y, uint32_t n)
+{
+    const uint32_t rb = (((x & 0xFF00FF) * n + (y & 0xFF00FF) * (256 - n) + ((y & 0x00FF00) << 8)) >> 8) & 0xFF00FF;
+    const uint32_t g  = (((x & 0x00FF00) * n + (y & 0x00FF00) * (256 - n)) >> 8) & 0x00FF00;
+    return rb | g;
+}
+
+#if defined (AGS_BLEND_SSE2)
+
+// Blends 4 pixels; n is given for each pixel in the lower half of its lane
+static inline __m128i blend_4px(__m128i x, __m128i y, __m128i n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i n256 = _mm_set1_epi16(256);
+    // selects red components, for adding the green ones to them
+    const __m128i red_mask = _mm_set_epi16(0, -1, 0, 0, 0, -1, 0, 0);
+    n = _mm_or_si128(n, _mm_slli_epi32(n, 16));
+    const __m128i n_lo = _mm_unpacklo_epi32(n, n);
+    const __m128i n_hi = _mm_unpackhi_epi32(n, n);
+    const __m128i y_lo = _mm_unpacklo_epi8(y, zero);
+    const __m128i y_hi = _mm_unpackhi_epi8(y, zero);
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), n_lo),
+                               _mm_mullo_epi16(y_lo, _mm_sub_epi16(n256, n_lo)));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), n_hi),
+                               _mm_mullo_epi16(y_hi, _mm_sub_epi16(n256, n_hi)));
+    lo = _mm_add_epi16(lo, _mm_and_si128(_mm_slli_epi64(y_lo, 16), red_mask));
+    hi = _mm_add_epi16(hi, _mm_and_si128(_mm_slli_epi64(y_hi, 16), red_mask));
+    return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+// Picks pixels from "keep" where mask is set, and from "res" elsewhere
+static inline __m128i select_4px(__m128i mask, __m128i keep, __m128i res)
+{
+    return _mm_or_si128(_mm_and_si128(mask, keep), _mm_andnot_si128(mask, res));
+}
+
+#endif
+
+void blend_span_argb2rgb(const uint32_t *src, uint32_t *dst, int count, int alpha_mul)
+{
+    int x = 0;
+#if defined (AGS_BLEND_SSE2)
+    const __m128i mask_color = _mm_set1_epi32(MASK_COLOR_32);
+    const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i a_shift = _mm_cvtsi32_si128(_rgb_a_shift_32);
+    const __m128i a_max = _mm_set1_epi32(0xFF);
+    const __m128i mul = _mm_set1_epi32(alpha_mul);
+    const __m128i one = _mm_set1_epi32(1);
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + x));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + x));
+        __m128i n = _mm_and_si128(_mm_srl_epi32(s, a_shift), a_max);
+        n = _mm_srli_epi32(_mm_mullo_epi16(n, mul), 8);
+        n = _mm_add_epi32(_mm_add_epi32(n, one), _mm_cmpeq_epi32(n, _mm_setzero_si128()));
+        const __m128i res = _mm_and_si128(blend_4px(s, d, n), rgb_mask);
+        _mm_storeu_si128((__m128i*)(dst + x), select_4px(_mm_cmpeq_epi32(s, mask_color), d, res));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        if (src[x] == MASK_COLOR_32)
+            continue;
+        uint32_t n = geta32(src[x]) * alpha_mul / 256;
+        if (n)
+            n++;
+        dst[x] = blend_rgb(src[x], dst[x], n);
+    }
+}
+
+void blend_span_trans(const uint32_t *src, uint32_t *dst, int count, int alpha, bool keep_alpha)
+{
+    const uint32_t n = alpha ? alpha + 1 : 0;
+    const uint32_t alpha_mask = keep_alpha ? 0xFF000000 : 0;
+    int x = 0;
+#if defined (AGS_BLEND_SSE2)
+    const __m128i mask_color = _mm_set1_epi32(MASK_COLOR_32);
+    const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i a_mask = _mm_set1_epi32(alpha_mask);
+    const __m128i nv = _mm_set1_epi32(n);
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + x));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + x));
+        const __m128i res = _mm_or_si128(_mm_and_si128(blend_4px(s, d, nv), rgb_mask), _mm_and_si128(d, a_mask));
+        _mm_storeu_si128((__m128i*)(dst + x), select_4px(_mm_cmpeq_epi32(s, mask_color), d, res));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        if (src[x] == MASK_COLOR_32)
+            continue;
+        dst[x] = blend_rgb(src[x], dst[x], n) | (dst[x] & alpha_mask);
+    }
+}
+
+void blend_span_lit(const uint32_t *src, uint32_t *dst, int count, uint32_t color, int alpha, bool keep_alpha)
+{
+    const uint32_t n = alpha ? alpha + 1 : 0;
+    const uint32_t alpha_mask = keep_alpha ? 0xFF000000 : 0;
+    int x = 0;
+#if defined (AGS_BLEND_SSE2)
+    const __m128i mask_color = _mm_set1_epi32(MASK_COLOR_32);
+    const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i a_mask = _mm_set1_epi32(alpha_mask);
+    const __m128i col = _mm_set1_epi32(color);
+    const __m128i nv = _mm_set1_epi32(n);
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + x));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + x));
+        const __m128i res = _mm_or_si128(_mm_and_si128(blend_4px(col, s, nv), rgb_mask), _mm_and_si128(s, a_mask));
+        _mm_storeu_si128((__m128i*)(dst + x), select_4px(_mm_cmpeq_epi32(s, mask_color), d, res));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        if (src[x] == MASK_COLOR_32)
+            continue;
+        dst[x] = blend_rgb(color, src[x], n) | (src[x] & alpha_mask);
+    }
+}
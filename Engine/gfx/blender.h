@@ -19,6 +19,8 @@
 #ifndef __AC_BLENDER_H
 #define __AC_BLENDER_H
 
+#include "core/types.h"
+
 //
 // Allegro's standard alpha blenders result in:
 // - src and dst RGB are combined proportionally to src alpha
@@ -53,6 +55,27 @@ unsigned long _argb2rgb_blender(unsigned long src_col, unsigned long dst_col, un
 unsigned long _rgb2argb_blender(unsigned long src_col, unsigned long dst_col, unsigned long src_alpha);
 // Sets the alpha channel to opaque. Used when drawing a non-alpha sprite onto an alpha-sprite.
 unsigned long _opaque_alpha_blender(unsigned long src_col, unsigned long dst_col, unsigned long src_alpha);
+// Trans blender that preserves destination's alpha channel, used by set_my_trans_blender.
+unsigned long _myblender_alpha_trans24(unsigned long src_col, unsigned long dst_col, unsigned long n);
+
+//
+// Span blenders process a row of 32-bit pixels at once, which lets them use
+// vector instructions and spares a blender callback per pixel. Each of them
+// gives exactly same results as the respective per-pixel blender.
+// Source pixels of the mask color are skipped, same as in sprite drawing.
+//
+// Blends source over destination proportionally to the source alpha
+// multiplied by alpha_mul / 256; final alpha is zero. This is same as
+// _argb2rgb_blender and Allegro's alpha blender.
+void blend_span_argb2rgb(const uint32_t *src, uint32_t *dst, int count, int alpha_mul);
+// Blends source over destination using constant alpha (0 - 255); the final
+// alpha is either kept from the destination, or zero. This is same as
+// _myblender_alpha_trans24 and Allegro's trans blender respectively.
+void blend_span_trans(const uint32_t *src, uint32_t *dst, int count, int alpha, bool keep_alpha);
+// Writes source pixels blended towards the given color using constant alpha;
+// the final alpha is either kept from the source, or zero. This is same as
+// drawing lit sprite using trans blenders described above.
+void blend_span_lit(const uint32_t *src, uint32_t *dst, int count, uint32_t color, int alpha, bool keep_alpha);
 
 // Additive alpha blender plain copies src over, applying a summ of src and
 // dst alpha values.
@@ -0,0 +1,233 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "gfx/gfx_convert.h"
+#include "util/wgt2allg.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_CONVERT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define AGS_CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace GfxConvert
+{
+
+static inline uint32_t MakeColor(const VMemFormat &fmt, int r, int g, int b, int a)
+{
+    return ((a & 0xFF) << fmt.AShift) | ((r & 0xFF) << fmt.RShift) |
+        ((g & 0xFF) << fmt.GShift) | ((b & 0xFF) << fmt.BShift);
+}
+
+void MakePaletteTable(const VMemFormat &fmt, bool use_mask, uint32_t table[256])
+{
+    for (int i = 0; i < 256; ++i)
+        table[i] = MakeColor(fmt, getr8(i), getg8(i), getb8(i), 0xFF);
+    if (use_mask)
+        table[MASK_COLOR_8] = 0;
+}
+
+void ConvertRow8(const uint8_t *src, uint32_t *dst, int count, const uint32_t table[256])
+{
+    for (int x = 0; x < count; ++x)
+        dst[x] = table[src[x]];
+}
+
+// The vector code expands 5 and 6-bit components by replicating their
+// high bits, which is what Allegro scale tables contain; this is checked
+// once, just in case
+static bool CanExpand16ByBits()
+{
+    static int result = -1;
+    if (result < 0)
+    {
+        result = 1;
+        for (int i = 0; i < 32 && result; ++i)
+            result = _rgb_scale_5[i] == ((i << 3) | (i >> 2));
+        for (int i = 0; i < 64 && result; ++i)
+            result = _rgb_scale_6[i] == ((i << 2) | (i >> 4));
+    }
+    return result != 0;
+}
+
+#if defined (AGS_CONVERT_SSE2)
+
+static inline __m128i Component16(__m128i px, int src_shift, int bits, int dst_shift)
+{
+    const __m128i mask = _mm_set1_epi32((1 << bits) - 1);
+    __m128i c = _mm_and_si128(_mm_srl_epi32(px, _mm_cvtsi32_si128(src_shift)), mask);
+    c = _mm_or_si128(_mm_slli_epi32(c, 8 - bits), _mm_srli_epi32(c, 2 * bits - 8));
+    return _mm_sll_epi32(c, _mm_cvtsi32_si128(dst_shift));
+}
+
+static inline __m128i Convert4x16(__m128i px, const VMemFormat &fmt, __m128i alpha, bool use_mask)
+{
+    __m128i out = _mm_or_si128(alpha, Component16(px, _rgb_r_shift_16, 5, fmt.RShift));
+    out = _mm_or_si128(out, Component16(px, _rgb_g_shift_16, 6, fmt.GShift));
+    out = _mm_or_si128(out, Component16(px, _rgb_b_shift_16, 5, fmt.BShift));
+    if (use_mask)
+        out = _mm_andnot_si128(_mm_cmpeq_epi32(px, _mm_set1_epi32(MASK_COLOR_16)), out);
+    return out;
+}
+
+static int ConvertRow16Vector(const uint16_t *src, uint32_t *dst, int count, const VMemFormat &fmt, bool use_mask)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32((int)(0xFFu << fmt.AShift));
+    int x = 0;
+    for (; x + 8 <= count; x += 8)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i*)(src + x));
+        _mm_storeu_si128((__m128i*)(dst + x), Convert4x16(_mm_unpacklo_epi16(px, zero), fmt, alpha, use_mask));
+        _mm_storeu_si128((__m128i*)(dst + x + 4), Convert4x16(_mm_unpackhi_epi16(px, zero), fmt, alpha, use_mask));
+    }
+    return x;
+}
+
+static inline __m128i Component32(__m128i px, int src_shift, int dst_shift)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i c = _mm_and_si128(_mm_srl_epi32(px, _mm_cvtsi32_si128(src_shift)), mask);
+    return _mm_sll_epi32(c, _mm_cvtsi32_si128(dst_shift));
+}
+
+static int ConvertRow32Vector(const uint32_t *src, uint32_t *dst, int count, const VMemFormat &fmt,
+    bool has_alpha, bool use_mask)
+{
+    const __m128i mask_color = _mm_set1_epi32(MASK_COLOR_32);
+    const __m128i opaque = _mm_set1_epi32((int)(0xFFu << fmt.AShift));
+    int x = 0;
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i*)(src + x));
+        __m128i out = has_alpha ? Component32(px, _rgb_a_shift_32, fmt.AShift) : opaque;
+        out = _mm_or_si128(out, Component32(px, _rgb_r_shift_32, fmt.RShift));
+        out = _mm_or_si128(out, Component32(px, _rgb_g_shift_32, fmt.GShift));
+        out = _mm_or_si128(out, Component32(px, _rgb_b_shift_32, fmt.BShift));
+        if (use_mask)
+            out = _mm_andnot_si128(_mm_cmpeq_epi32(px, mask_color), out);
+        _mm_storeu_si128((__m128i*)(dst + x), out);
+    }
+    return x;
+}
+
+#elif defined (AGS_CONVERT_NEON)
+
+static inline uint32x4_t Component16(uint32x4_t px, int src_shift, int bits, int dst_shift)
+{
+    uint32x4_t c = vandq_u32(vshlq_u32(px, vdupq_n_s32(-src_shift)), vdupq_n_u32((1 << bits) - 1));
+    c = vorrq_u32(vshlq_u32(c, vdupq_n_s32(8 - bits)), vshlq_u32(c, vdupq_n_s32(8 - 2 * bits)));
+    return vshlq_u32(c, vdupq_n_s32(dst_shift));
+}
+
+static inline uint32x4_t Convert4x16(uint32x4_t px, const VMemFormat &fmt, uint32x4_t alpha, bool use_mask)
+{
+    uint32x4_t out = vorrq_u32(alpha, Component16(px, _rgb_r_shift_16, 5, fmt.RShift));
+    out = vorrq_u32(out, Component16(px, _rgb_g_shift_16, 6, fmt.GShift));
+    out = vorrq_u32(out, Component16(px, _rgb_b_shift_16, 5, fmt.BShift));
+    if (use_mask)
+        out = vbicq_u32(out, vceqq_u32(px, vdupq_n_u32(MASK_COLOR_16)));
+    return out;
+}
+
+static int ConvertRow16Vector(const uint16_t *src, uint32_t *dst, int count, const VMemFormat &fmt, bool use_mask)
+{
+    const uint32x4_t alpha = vdupq_n_u32(0xFFu << fmt.AShift);
+    int x = 0;
+    for (; x + 8 <= count; x += 8)
+    {
+        uint16x8_t px = vld1q_u16(src + x);
+        vst1q_u32(dst + x, Convert4x16(vmovl_u16(vget_low_u16(px)), fmt, alpha, use_mask));
+        vst1q_u32(dst + x + 4, Convert4x16(vmovl_u16(vget_high_u16(px)), fmt, alpha, use_mask));
+    }
+    return x;
+}
+
+static inline uint32x4_t Component32(uint32x4_t px, int src_shift, int dst_shift)
+{
+    uint32x4_t c = vandq_u32(vshlq_u32(px, vdupq_n_s32(-src_shift)), vdupq_n_u32(0xFF));
+    return vshlq_u32(c, vdupq_n_s32(dst_shift));
+}
+
+static int ConvertRow32Vector(const uint32_t *src, uint32_t *dst, int count, const VMemFormat &fmt,
+    bool has_alpha, bool use_mask)
+{
+    const uint32x4_t mask_color = vdupq_n_u32(MASK_COLOR_32);
+    const uint32x4_t opaque = vdupq_n_u32(0xFFu << fmt.AShift);
+    int x = 0;
+    for (; x + 4 <= count; x += 4)
+    {
+        uint32x4_t px = vld1q_u32(src + x);
+        uint32x4_t out = has_alpha ? Component32(px, _rgb_a_shift_32, fmt.AShift) : opaque;
+        out = vorrq_u32(out, Component32(px, _rgb_r_shift_32, fmt.RShift));
+        out = vorrq_u32(out, Component32(px, _rgb_g_shift_32, fmt.GShift));
+        out = vorrq_u32(out, Component32(px, _rgb_b_shift_32, fmt.BShift));
+        if (use_mask)
+            out = vbicq_u32(out, vceqq_u32(px, mask_color));
+        vst1q_u32(dst + x, out);
+    }
+    return x;
+}
+
+#else
+
+static int ConvertRow16Vector(const uint16_t *, uint32_t *, int, const VMemFormat &, bool)
+{
+    return 0;
+}
+
+static int ConvertRow32Vector(const uint32_t *, uint32_t *, int, const VMemFormat &, bool, bool)
+{
+    return 0;
+}
+
+#endif
+
+void ConvertRow16(const uint16_t *src, uint32_t *dst, int count, const VMemFormat &fmt, bool use_mask)
+{
+    int x = CanExpand16ByBits() ? ConvertRow16Vector(src, dst, count, fmt, use_mask) : 0;
+    for (; x < count; ++x)
+    {
+        if (use_mask && src[x] == MASK_COLOR_16)
+            dst[x] = 0;
+        else
+            dst[x] = MakeColor(fmt, getr16(src[x]), getg16(src[x]), getb16(src[x]), 0xFF);
+    }
+}
+
+void ConvertRow32(const uint32_t *src, uint32_t *dst, int count, const VMemFormat &fmt,
+    bool has_alpha, bool use_mask)
+{
+    int x = ConvertRow32Vector(src, dst, count, fmt, has_alpha, use_mask);
+    for (; x < count; ++x)
+    {
+        if (use_mask && src[x] == MASK_COLOR_32)
+            dst[x] = 0;
+        else
+            dst[x] = MakeColor(fmt, getr32(src[x]), getg32(src[x]), getb32(src[x]),
+                has_alpha ? geta32(src[x]) : 0xFF);
+    }
+}
+
+} // namespace GfxConvert
+
+} // namespace Engine
+} // namespace AGS
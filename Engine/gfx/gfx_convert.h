@@ -0,0 +1,98 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Conversion of bitmap pixels into the 32-bit texture formats.
+//
+// These are the inner loops of the texture uploads, converting one row of
+// pixels at a time. They use SSE2 or NEON instructions where available, and
+// do not depend on any graphics driver, so may be tested on their own.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__GFXCONVERT_H
+#define __AGS_EE_GFX__GFXCONVERT_H
+
+#include "core/types.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace GfxConvert
+{
+    // Positions of the color components in the destination 32-bit pixel
+    struct VMemFormat
+    {
+        int RShift;
+        int GShift;
+        int BShift;
+        int AShift;
+    };
+
+    // Makes a table of the 256 palette colors converted to the destination
+    // format, for the 8-bit rows conversion; if use_mask is set, then
+    // the mask color is converted to fully transparent black
+    void MakePaletteTable(const VMemFormat &fmt, bool use_mask, uint32_t table[256]);
+    // Converts 8-bit pixels using the palette table
+    void ConvertRow8(const uint8_t *src, uint32_t *dst, int count, const uint32_t table[256]);
+    // Converts 16-bit pixels; alpha is fully opaque, except for the mask
+    // color pixels, which become fully transparent black if use_mask is set
+    void ConvertRow16(const uint16_t *src, uint32_t *dst, int count, const VMemFormat &fmt, bool use_mask);
+    // Converts 32-bit pixels; alpha is taken from the source if has_alpha is
+    // set, or made fully opaque otherwise; the mask color pixels become fully
+    // transparent black if use_mask is set
+    void ConvertRow32(const uint32_t *src, uint32_t *dst, int count, const VMemFormat &fmt,
+        bool has_alpha, bool use_mask);
+
+    // Reconsiders colour of the transparent pixels in the converted row.
+    // Transparent pixel followed by the opaque one takes its colour, and other
+    // transparent pixels get average colour of their opaque neighbours if
+    // linear filtering is used; this stops the filter from drawing dark
+    // outlines around the sprites. The source rows above and below are
+    // null when there are none.
+    template <typename T, typename TSum, typename TMakeColor>
+    void FixTransparentRow(const T *src, const T *src_before, const T *src_after, int count,
+        T mask_color, bool fix_from_next, bool linear_filter,
+        void (*get_pixel)(const T*, TSum*, TSum*, TSum*, TSum*), TMakeColor make_color, uint32_t *dst)
+    {
+        for (int x = 0; x < count; x++)
+        {
+            if (src[x] != mask_color)
+                continue;
+            if (fix_from_next && x < count - 1 && src[x + 1] != mask_color)
+            {
+                dst[x] = dst[x + 1] & 0x00FFFFFF;
+            }
+            else if (linear_filter)
+            {
+                TSum red = 0, green = 0, blue = 0, divisor = 0;
+                if (x > 0)
+                    get_pixel(&src[x - 1], &red, &green, &blue, &divisor);
+                if (x < count - 1)
+                    get_pixel(&src[x + 1], &red, &green, &blue, &divisor);
+                if (src_before)
+                    get_pixel(&src_before[x], &red, &green, &blue, &divisor);
+                if (src_after)
+                    get_pixel(&src_after[x], &red, &green, &blue, &divisor);
+                if (divisor > 0)
+                    dst[x] = make_color(red / divisor, green / divisor, blue / divisor);
+            }
+        }
+    }
+} // namespace GfxConvert
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__GFXCONVERT_H
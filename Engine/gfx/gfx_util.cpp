@@ -15,6 +15,7 @@
 #include "core/platform.h"
 #include "gfx/gfx_util.h"
 #include "gfx/blender.h"
+#include "util/math.h"
 
 // CHECKME: is this hack still relevant?
 #if AGS_PLATFORM_OS_IOS || AGS_PLATFORM_OS_ANDROID
@@ -95,6 +96,12 @@ void DrawSpriteBlend(Bitmap *ds, const Point &ds_at, Bitmap *sprite,
     if (blend_alpha <= 0)
         return; // do not draw 100% transparent image
 
+    if (blend_mode == kBlendMode_Alpha && !dst_has_alpha && src_has_alpha &&
+        // same as _argb2rgb_blender
+        BlendSpriteAlpha32(ds, sprite, ds_at.X, ds_at.Y, (blend_alpha & 0xFF) + 1))
+    {
+        return;
+    }
     if (// support only 32-bit blending at the moment
         ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32 &&
         // set blenders if applicable and tell if succeeded
@@ -174,8 +181,11 @@ void DrawSpriteWithTransparency(Bitmap *ds, Bitmap *sprite, int x, int y, int al
     {
         if (alpha < 0xFF && surface_depth > 8 && sprite_depth > 8) 
         {
-            set_trans_blender(0, 0, 0, alpha);
-            ds->TransBlendBlt(sprite, x, y);
+            if (!BlendSpriteTrans32(ds, sprite, x, y, alpha))
+            {
+                set_trans_blender(0, 0, 0, alpha);
+                ds->TransBlendBlt(sprite, x, y);
+            }
         }
         else
         {
@@ -184,6 +194,50 @@ void DrawSpriteWithTransparency(Bitmap *ds, Bitmap *sprite, int x, int y, int al
     }
 }
 
+// Runs span blender over each row of the sprite, clipped by the destination's
+// clipping rectangle; blend_row receives source and destination pixels
+template <typename TBlendRow>
+static bool BlendSprite32(Bitmap *ds, Bitmap *sprite, int x, int y, TBlendRow blend_row)
+{
+    if (ds->GetColorDepth() != 32 || sprite->GetColorDepth() != 32 ||
+        !ds->IsMemoryBitmap() || !sprite->IsMemoryBitmap())
+        return false;
+
+    const Rect clip = ds->GetClip();
+    const int x1 = Math::Max(x, Math::Max(0, clip.Left));
+    const int y1 = Math::Max(y, Math::Max(0, clip.Top));
+    const int x2 = Math::Min(x + sprite->GetWidth() - 1, Math::Min(ds->GetWidth() - 1, clip.Right));
+    const int y2 = Math::Min(y + sprite->GetHeight() - 1, Math::Min(ds->GetHeight() - 1, clip.Bottom));
+    for (int dst_y = y1; dst_y <= y2; ++dst_y)
+    {
+        const uint32_t *src_row = (const uint32_t*)sprite->GetScanLine(dst_y - y) + (x1 - x);
+        uint32_t *dst_row = (uint32_t*)ds->GetScanLineForWriting(dst_y) + x1;
+        blend_row(src_row, dst_row, x2 - x1 + 1);
+    }
+    return true;
+}
+
+bool BlendSpriteAlpha32(Bitmap *ds, Bitmap *sprite, int x, int y, int alpha_mul)
+{
+    return BlendSprite32(ds, sprite, x, y,
+        [alpha_mul](const uint32_t *src, uint32_t *dst, int count)
+        { blend_span_argb2rgb(src, dst, count, alpha_mul); });
+}
+
+bool BlendSpriteTrans32(Bitmap *ds, Bitmap *sprite, int x, int y, int alpha, bool keep_alpha)
+{
+    return BlendSprite32(ds, sprite, x, y,
+        [alpha, keep_alpha](const uint32_t *src, uint32_t *dst, int count)
+        { blend_span_trans(src, dst, count, alpha, keep_alpha); });
+}
+
+bool BlendSpriteLit32(Bitmap *ds, Bitmap *sprite, int x, int y, color_t color, int alpha, bool keep_alpha)
+{
+    return BlendSprite32(ds, sprite, x, y,
+        [color, alpha, keep_alpha](const uint32_t *src, uint32_t *dst, int count)
+        { blend_span_lit(src, dst, count, color, alpha, keep_alpha); });
+}
+
 } // namespace GfxUtil
 
 } // namespace Engine
@@ -51,6 +51,23 @@ namespace GfxUtil
     // ignores image's alpha channel, even if there's one;
     // does proper conversion depending on respected color depths.
     void DrawSpriteWithTransparency(Bitmap *ds, Bitmap *sprite, int x, int y, int alpha = 0xFF);
+
+    // Fast blending of 32-bit sprites over 32-bit bitmaps, done by whole rows
+    // of pixels (see span blenders in blender.h); sprite pixels of the mask
+    // color are skipped. These return false without drawing anything if the
+    // bitmaps are not suitable, in which case caller should use Allegro's
+    // blenders instead.
+    //
+    // Blends sprite using its alpha channel, multiplied by alpha_mul / 256;
+    // final alpha is zero (same as Allegro's alpha blender).
+    bool BlendSpriteAlpha32(Bitmap *ds, Bitmap *sprite, int x, int y, int alpha_mul = 256);
+    // Blends sprite using constant alpha (same as Allegro's trans blender);
+    // optionally keeps destination's alpha.
+    bool BlendSpriteTrans32(Bitmap *ds, Bitmap *sprite, int x, int y, int alpha, bool keep_alpha = false);
+    // Draws sprite, blending its pixels towards the given color using
+    // constant alpha (same as drawing lit sprite with the trans blender);
+    // optionally keeps sprite's alpha.
+    bool BlendSpriteLit32(Bitmap *ds, Bitmap *sprite, int x, int y, color_t color, int alpha, bool keep_alpha = false);
 } // namespace GfxUtil
 
 } // namespace Engine
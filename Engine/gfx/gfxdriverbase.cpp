@@ -17,6 +17,7 @@
 #include "gfx/bitmap.h"
 #include "gfx/gfxfilter.h"
 #include "gfx/gfxdriverbase.h"
+#include "gfx/gfx_convert.h"
 #include "gfx/gfx_util.h"
 
 using namespace AGS::Common;
@@ -277,7 +278,7 @@ void VideoMemoryGraphicsDriver::DestroyFxPool()
 #define algetb8(c)  getb8(c)
 
 
-__inline void get_pixel_if_not_transparent8(unsigned char *pixel, unsigned char *red, unsigned char *green, unsigned char *blue, unsigned char *divisor)
+__inline void get_pixel_if_not_transparent8(const unsigned char *pixel, unsigned char *red, unsigned char *green, unsigned char *blue, unsigned char *divisor)
 {
   if (pixel[0] != MASK_COLOR_8)
   {
@@ -288,7 +289,7 @@ __inline void get_pixel_if_not_transparent8(unsigned char *pixel, unsigned char
   }
 }
 
-__inline void get_pixel_if_not_transparent16(unsigned short *pixel, unsigned short *red, unsigned short *green, unsigned short *blue, unsigned short *divisor)
+__inline void get_pixel_if_not_transparent16(const unsigned short *pixel, unsigned short *red, unsigned short *green, unsigned short *blue, unsigned short *divisor)
 {
   if (pixel[0] != MASK_COLOR_16)
   {
@@ -299,7 +300,7 @@ __inline void get_pixel_if_not_transparent16(unsigned short *pixel, unsigned sho
   }
 }
 
-__inline void get_pixel_if_not_transparent32(unsigned int *pixel, unsigned int *red, unsigned int *green, unsigned int *blue, unsigned int *divisor)
+__inline void get_pixel_if_not_transparent32(const unsigned int *pixel, unsigned int *red, unsigned int *green, unsigned int *blue, unsigned int *divisor)
 {
   if (pixel[0] != MASK_COLOR_32)
   {
@@ -319,139 +320,44 @@ void VideoMemoryGraphicsDriver::BitmapToVideoMem(const Bitmap *bitmap, const boo
                                                  char *dst_ptr, const int dst_pitch, const bool usingLinearFiltering)
 {
   const int src_depth = bitmap->GetColorDepth();
-  bool lastPixelWasTransparent = false;
+  const GfxConvert::VMemFormat fmt = { _vmem_r_shift_32, _vmem_g_shift_32, _vmem_b_shift_32, _vmem_a_shift_32 };
+  auto make_color = [this](unsigned int r, unsigned int g, unsigned int b) { return VMEMCOLOR_RGBA(r, g, b, 0); };
+  uint32_t palette[256];
+  if (src_depth == 8)
+    GfxConvert::MakePaletteTable(fmt, true, palette);
+  // pixels with alpha channel are used as is
+  const bool fix_from_next = !(src_depth == 32 && has_alpha);
+
   for (int y = 0; y < tile->height; y++)
   {
-    lastPixelWasTransparent = false;
     const uint8_t *scanline_before = bitmap->GetScanLine(y + tile->y - 1);
     const uint8_t *scanline_at     = bitmap->GetScanLine(y + tile->y);
     const uint8_t *scanline_after  = bitmap->GetScanLine(y + tile->y + 1);
     unsigned int* memPtrLong = (unsigned int*)dst_ptr;
 
-    for (int x = 0; x < tile->width; x++)
+    if (src_depth == 8)
     {
-      if (src_depth == 8)
-      {
-        unsigned char* srcData = (unsigned char*)&scanline_at[(x + tile->x) * sizeof(char)];
-        if (*srcData == MASK_COLOR_8)
-        {
-          if (!usingLinearFiltering)
-            memPtrLong[x] = 0;
-          // set to transparent, but use the colour from the neighbouring 
-          // pixel to stop the linear filter doing black outlines
-          else
-          {
-            unsigned char red = 0, green = 0, blue = 0, divisor = 0;
-            if (x > 0)
-              get_pixel_if_not_transparent8(&srcData[-1], &red, &green, &blue, &divisor);
-            if (x < tile->width - 1)
-              get_pixel_if_not_transparent8(&srcData[1], &red, &green, &blue, &divisor);
-            if (y > 0)
-              get_pixel_if_not_transparent8((unsigned char*)&scanline_before[(x + tile->x) * sizeof(char)], &red, &green, &blue, &divisor);
-            if (y < tile->height - 1)
-              get_pixel_if_not_transparent8((unsigned char*)&scanline_after[(x + tile->x) * sizeof(char)], &red, &green, &blue, &divisor);
-            if (divisor > 0)
-              memPtrLong[x] = VMEMCOLOR_RGBA(red / divisor, green / divisor, blue / divisor, 0);
-            else
-              memPtrLong[x] = 0;
-          }
-          lastPixelWasTransparent = true;
-        }
-        else
-        {
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr8(*srcData), algetg8(*srcData), algetb8(*srcData), 0xFF);
-          if (lastPixelWasTransparent)
-          {
-            // update the colour of the previous tranparent pixel, to
-            // stop black outlines when linear filtering
-            memPtrLong[x - 1] = memPtrLong[x] & 0x00FFFFFF;
-            lastPixelWasTransparent = false;
-          }
-        }
-      }
-      else if (src_depth == 16)
-      {
-        unsigned short* srcData = (unsigned short*)&scanline_at[(x + tile->x) * sizeof(short)];
-        if (*srcData == MASK_COLOR_16) 
-        {
-          if (!usingLinearFiltering)
-            memPtrLong[x] = 0;
-          // set to transparent, but use the colour from the neighbouring 
-          // pixel to stop the linear filter doing black outlines
-          else
-          {
-            unsigned short red = 0, green = 0, blue = 0, divisor = 0;
-            if (x > 0)
-              get_pixel_if_not_transparent16(&srcData[-1], &red, &green, &blue, &divisor);
-            if (x < tile->width - 1)
-              get_pixel_if_not_transparent16(&srcData[1], &red, &green, &blue, &divisor);
-            if (y > 0)
-              get_pixel_if_not_transparent16((unsigned short*)&scanline_before[(x + tile->x) * sizeof(short)], &red, &green, &blue, &divisor);
-            if (y < tile->height - 1)
-              get_pixel_if_not_transparent16((unsigned short*)&scanline_after[(x + tile->x) * sizeof(short)], &red, &green, &blue, &divisor);
-            if (divisor > 0)
-              memPtrLong[x] = VMEMCOLOR_RGBA(red / divisor, green / divisor, blue / divisor, 0);
-            else
-              memPtrLong[x] = 0;
-          }
-          lastPixelWasTransparent = true;
-        }
-        else
-        {
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr16(*srcData), algetg16(*srcData), algetb16(*srcData), 0xFF);
-          if (lastPixelWasTransparent)
-          {
-            // update the colour of the previous tranparent pixel, to
-            // stop black outlines when linear filtering
-            memPtrLong[x - 1] = memPtrLong[x] & 0x00FFFFFF;
-            lastPixelWasTransparent = false;
-          }
-        }
-      }
-      else if (src_depth == 32)
-      {
-        unsigned int* memPtrLong = (unsigned int*)dst_ptr;
-        unsigned int* srcData = (unsigned int*)&scanline_at[(x + tile->x) * sizeof(int)];
-        if (*srcData == MASK_COLOR_32)
-        {
-          if (!usingLinearFiltering)
-            memPtrLong[x] = 0;
-          // set to transparent, but use the colour from the neighbouring 
-          // pixel to stop the linear filter doing black outlines
-          else
-          {
-            unsigned int red = 0, green = 0, blue = 0, divisor = 0;
-            if (x > 0)
-              get_pixel_if_not_transparent32(&srcData[-1], &red, &green, &blue, &divisor);
-            if (x < tile->width - 1)
-              get_pixel_if_not_transparent32(&srcData[1], &red, &green, &blue, &divisor);
-            if (y > 0)
-              get_pixel_if_not_transparent32((unsigned int*)&scanline_before[(x + tile->x) * sizeof(int)], &red, &green, &blue, &divisor);
-            if (y < tile->height - 1)
-              get_pixel_if_not_transparent32((unsigned int*)&scanline_after[(x + tile->x) * sizeof(int)], &red, &green, &blue, &divisor);
-            if (divisor > 0)
-              memPtrLong[x] = VMEMCOLOR_RGBA(red / divisor, green / divisor, blue / divisor, 0);
-            else
-              memPtrLong[x] = 0;
-          }
-          lastPixelWasTransparent = true;
-        }
-        else if (has_alpha)
-        {
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr32(*srcData), algetg32(*srcData), algetb32(*srcData), algeta32(*srcData));
-        }
-        else
-        {
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr32(*srcData), algetg32(*srcData), algetb32(*srcData), 0xFF);
-          if (lastPixelWasTransparent)
-          {
-            // update the colour of the previous tranparent pixel, to
-            // stop black outlines when linear filtering
-            memPtrLong[x - 1] = memPtrLong[x] & 0x00FFFFFF;
-            lastPixelWasTransparent = false;
-          }
-        }
-      }
+      GfxConvert::ConvertRow8(scanline_at + tile->x, memPtrLong, tile->width, palette);
+      GfxConvert::FixTransparentRow<unsigned char, unsigned char>((const unsigned char*)scanline_at + tile->x,
+        y > 0 ? (const unsigned char*)scanline_before + tile->x : nullptr,
+        y < tile->height - 1 ? (const unsigned char*)scanline_after + tile->x : nullptr,
+        tile->width, MASK_COLOR_8, fix_from_next, usingLinearFiltering, get_pixel_if_not_transparent8, make_color, memPtrLong);
+    }
+    else if (src_depth == 16)
+    {
+      GfxConvert::ConvertRow16((const uint16_t*)scanline_at + tile->x, memPtrLong, tile->width, fmt, true);
+      GfxConvert::FixTransparentRow<unsigned short, unsigned short>((const unsigned short*)scanline_at + tile->x,
+        y > 0 ? (const unsigned short*)scanline_before + tile->x : nullptr,
+        y < tile->height - 1 ? (const unsigned short*)scanline_after + tile->x : nullptr,
+        tile->width, MASK_COLOR_16, fix_from_next, usingLinearFiltering, get_pixel_if_not_transparent16, make_color, memPtrLong);
+    }
+    else if (src_depth == 32)
+    {
+      GfxConvert::ConvertRow32((const uint32_t*)scanline_at + tile->x, memPtrLong, tile->width, fmt, has_alpha, true);
+      GfxConvert::FixTransparentRow<unsigned int, unsigned int>((const unsigned int*)scanline_at + tile->x,
+        y > 0 ? (const unsigned int*)scanline_before + tile->x : nullptr,
+        y < tile->height - 1 ? (const unsigned int*)scanline_after + tile->x : nullptr,
+        tile->width, MASK_COLOR_32, fix_from_next, usingLinearFiltering, get_pixel_if_not_transparent32, make_color, memPtrLong);
     }
 
     dst_ptr += dst_pitch;
@@ -462,33 +368,22 @@ void VideoMemoryGraphicsDriver::BitmapToVideoMemOpaque(const Bitmap *bitmap, con
     char *dst_ptr, const int dst_pitch)
 {
   const int src_depth = bitmap->GetColorDepth();
+  const GfxConvert::VMemFormat fmt = { _vmem_r_shift_32, _vmem_g_shift_32, _vmem_b_shift_32, _vmem_a_shift_32 };
+  uint32_t palette[256];
+  if (src_depth == 8)
+    GfxConvert::MakePaletteTable(fmt, false, palette);
+
   for (int y = 0; y < tile->height; y++)
   {
     const uint8_t *scanline_at = bitmap->GetScanLine(y + tile->y);
     unsigned int* memPtrLong = (unsigned int*)dst_ptr;
 
-    for (int x = 0; x < tile->width; x++)
-    {
-      if (src_depth == 8)
-      {
-        unsigned char* srcData = (unsigned char*)&scanline_at[(x + tile->x) * sizeof(char)];
-        memPtrLong[x] = VMEMCOLOR_RGBA(algetr8(*srcData), algetg8(*srcData), algetb8(*srcData), 0xFF);
-      }
-      else if (src_depth == 16)
-      {
-        unsigned short* srcData = (unsigned short*)&scanline_at[(x + tile->x) * sizeof(short)];
-        memPtrLong[x] = VMEMCOLOR_RGBA(algetr16(*srcData), algetg16(*srcData), algetb16(*srcData), 0xFF);
-      }
-      else if (src_depth == 32)
-      {
-        unsigned int* memPtrLong = (unsigned int*)dst_ptr;
-        unsigned int* srcData = (unsigned int*)&scanline_at[(x + tile->x) * sizeof(int)];
-        if (has_alpha)
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr32(*srcData), algetg32(*srcData), algetb32(*srcData), algeta32(*srcData));
-        else
-          memPtrLong[x] = VMEMCOLOR_RGBA(algetr32(*srcData), algetg32(*srcData), algetb32(*srcData), 0xFF);
-      }
-    }
+    if (src_depth == 8)
+      GfxConvert::ConvertRow8(scanline_at + tile->x, memPtrLong, tile->width, palette);
+    else if (src_depth == 16)
+      GfxConvert::ConvertRow16((const uint16_t*)scanline_at + tile->x, memPtrLong, tile->width, fmt, false);
+    else if (src_depth == 32)
+      GfxConvert::ConvertRow32((const uint32_t*)scanline_at + tile->x, memPtrLong, tile->width, fmt, has_alpha, false);
 
     dst_ptr += dst_pitch;
   }
@@ -68,6 +68,7 @@ Bitmap *AllegroGfxFilter::ShutdownAndReturnRealScreen()
     delete realScreenSizedBuffer;
     virtualScreen = nullptr;
     realScreenSizedBuffer = nullptr;
+    lastBlitFrom = nullptr;
     Bitmap *real_scr = realScreen;
     realScreen = nullptr;
     return real_scr;
@@ -161,6 +162,12 @@ void AllegroGfxFilter::GetCopyOfScreenIntoBitmap(Bitmap *copyBitmap, bool copy_w
     }
 }
 
+void AllegroGfxFilter::ForgetRenderSource(Bitmap *toRender)
+{
+    if (lastBlitFrom == toRender)
+        lastBlitFrom = virtualScreen;
+}
+
 Bitmap *AllegroGfxFilter::PreRenderPass(Bitmap *toRender)
 {
     // do nothing by default
@@ -46,6 +46,9 @@ public:
     virtual void ClearRect(int x1, int y1, int x2, int y2, int color);
     virtual void GetCopyOfScreenIntoBitmap(Bitmap *copyBitmap);
     virtual void GetCopyOfScreenIntoBitmap(Bitmap *copyBitmap, bool copy_with_yoffset);
+    // Tells that the bitmap passed to RenderScreen earlier is about to be
+    // destroyed; the screen copies are made from the virtual screen instead
+    void ForgetRenderSource(Bitmap *toRender);
 
     static const GfxFilterInfo FilterInfo;
 
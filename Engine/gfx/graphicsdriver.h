@@ -147,6 +147,10 @@ public:
   // fail and optionally write wanted destination format into 'want_fmt' pointer.
   virtual bool GetCopyOfScreenIntoBitmap(Common::Bitmap *destination, bool at_native_res, GraphicResolution *want_fmt = nullptr) = 0;
   virtual void EnableVsyncBeforeRender(bool enabled) = 0;
+  // Enables or disables presenting rendered frames on a separate thread, which
+  // lets engine construct the next frame while the previous one is displayed.
+  // Drivers that do not need this may ignore the setting.
+  virtual void EnablePipelinedPresent(bool enabled) = 0;
   virtual void Vsync() = 0;
   // Enables or disables rendering mode that draws sprite list directly into
   // the final resolution, as opposed to drawing to native-resolution buffer
@@ -18,15 +18,18 @@
 #include <ctype.h> // toupper
 
 #include "core/platform.h"
+#include "ac/game.h"
 #include "ac/gamesetup.h"
 #include "ac/gamesetupstruct.h"
 #include "ac/gamestate.h"
 #include "ac/global_translation.h"
 #include "ac/path_helper.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "ac/system.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "font/fonts.h"
 #include "main/mainheader.h"
 #include "main/config.h"
 #include "platform/base/agsplatformdriver.h"
@@ -36,6 +39,7 @@
 #include "util/path.h"
 #include "util/string_utils.h"
 #include "media/audio/audio_system.h"
+#include "media/audio/soundcache.h"
 
 
 using namespace AGS::Common;
@@ -501,6 +505,10 @@ void apply_config(const ConfigTree &cfg)
         }
 
         psp_audio_multithreaded = INIreadint(cfg, "sound", "threaded", psp_audio_multithreaded);
+        int sound_cache_kb = INIreadint(cfg, "sound", "cachemax", DEFAULTSOUNDCACHESIZE_KB);
+        if (sound_cache_kb > 0)
+            set_sound_cache_max_size((size_t)sound_cache_kb * 1024);
+        set_sound_cache_decode_limit((size_t)std::max(0, INIreadint(cfg, "sound", "decode_max")) * 1024);
 
         // Legacy graphics settings has to be translated into new options;
         // they must be read first, to let newer options override them, if ones are present
@@ -538,6 +546,7 @@ void apply_config(const ConfigTree &cfg)
         usetup.Screen.DisplayMode.VSync = INIreadint(cfg, "graphics", "vsync") > 0;
         usetup.RenderAtScreenRes = INIreadint(cfg, "graphics", "render_at_screenres") > 0;
         usetup.Supersampling = INIreadint(cfg, "graphics", "supersampling", 1);
+        usetup.PresentThread = INIreadint(cfg, "graphics", "present_thread") > 0;
 
         usetup.enable_antialiasing = INIreadint(cfg, "misc", "antialias") > 0;
 
@@ -552,6 +561,14 @@ void apply_config(const ConfigTree &cfg)
         int cache_size_kb = INIreadint(cfg, "misc", "cachemax", DEFAULTCACHESIZE_KB);
         if (cache_size_kb > 0)
             spriteset.SetMaxCacheSize((size_t)cache_size_kb * 1024);
+        set_sprite_transform_cache_size((size_t)std::max(0, INIreadint(cfg, "misc", "transformcachemax", DEFAULTTRANSFORMCACHESIZE_KB)) * 1024);
+        set_text_cache_size((size_t)std::max(0, INIreadint(cfg, "misc", "textcachemax", DEFAULTTEXTCACHESIZE_KB)) * 1024);
+        spriteset.SetFileMapping(INIreadint(cfg, "misc", "spritefile_mmap") > 0);
+        usetup.HierarchicalPathfinder = INIreadint(cfg, "misc", "hierarchical_pathfinder") > 0;
+        usetup.CompressSaves = INIreadint(cfg, "misc", "compress_saves") > 0;
+        usetup.AsyncSaves = INIreadint(cfg, "misc", "async_saves") > 0;
+        set_savestate_options((size_t)std::max(0, INIreadint(cfg, "misc", "savestates", DEFAULTSAVESTATES)),
+            INIreadint(cfg, "misc", "savestate_delta", 1) > 0);
 
         usetup.mouse_auto_lock = INIreadint(cfg, "mouse", "auto_lock") > 0;
 
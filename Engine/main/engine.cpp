@@ -625,7 +625,7 @@ void engine_init_rand()
 
 void engine_init_pathfinder()
 {
-    init_pathfinder(loaded_game_file_version);
+    init_pathfinder(loaded_game_file_version, usetup.HierarchicalPathfinder);
 }
 
 void engine_pre_init_gfx()
@@ -1135,12 +1135,6 @@ void engine_setup_scsystem_auxiliary()
     }
 }
 
-void engine_update_mp3_thread()
-{
-    update_mp3_thread();
-    platform->Delay(50);
-}
-
 void engine_start_multithreaded_audio()
 {
   // PSP: Initialize the sound cache.
@@ -1149,7 +1143,7 @@ void engine_start_multithreaded_audio()
   // Create sound update thread. This is a workaround for sound stuttering.
   if (psp_audio_multithreaded)
   {
-    if (!audioThread.CreateAndStart(engine_update_mp3_thread, true))
+    if (!start_audio_thread())
     {
       Debug::Printf(kDbgMsg_Info, "Failed to start audio thread, audio will be processed on the main thread");
       psp_audio_multithreaded = 0;
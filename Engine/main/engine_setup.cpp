@@ -76,6 +76,7 @@ void engine_post_gfxmode_driver_setup()
     gfxDriver->SetCallbackForPolling(update_polled_stuff_if_runtime);
     gfxDriver->SetCallbackToDrawScreen(draw_game_screen_callback, construct_engine_overlay);
     gfxDriver->SetCallbackForNullSprite(GfxDriverNullSpriteCallback);
+    gfxDriver->EnablePipelinedPresent(usetup.PresentThread);
 }
 
 // Reset gfx driver callbacks
@@ -84,6 +85,7 @@ void engine_pre_gfxmode_driver_cleanup()
     gfxDriver->SetCallbackForPolling(nullptr);
     gfxDriver->SetCallbackToDrawScreen(nullptr, nullptr);
     gfxDriver->SetCallbackForNullSprite(nullptr);
+    gfxDriver->EnablePipelinedPresent(false);
     gfxDriver->SetMemoryBackBuffer(nullptr);
 }
 
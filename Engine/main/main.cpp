@@ -97,7 +97,6 @@ int psp_ignore_acsetup_cfg_file = 0;
 int psp_clear_cache_on_room_change = 0;
 
 int psp_midi_preload_patches = 0;
-int psp_audio_cachesize = 10;
 char psp_game_file_name[] = "";
 char psp_translation[] = "default";
 
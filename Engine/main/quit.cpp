@@ -26,6 +26,7 @@
 #include "debug/debugger.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "main/config.h"
 #include "main/engine.h"
 #include "main/main.h"
@@ -37,6 +38,7 @@
 #include "core/assetmanager.h"
 #include "plugin/plugin_engine.h"
 #include "media/audio/audio_system.h"
+#include "media/audio/soundcache.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
@@ -111,7 +113,8 @@ void quit_shutdown_audio()
 #endif
 
     // Quit the sound thread.
-    audioThread.Stop();
+    stop_audio_thread();
+    clear_sound_cache();
 
     remove_sound();
 }
@@ -252,6 +255,9 @@ void quit(const char *quitmsg)
 
     quit_shutdown_scripts();
 
+    // make sure that the last savegame is completely written
+    WaitForSavegameWrite();
+
     quit_shutdown_platform(qreason);
 
     our_eip = 9019;
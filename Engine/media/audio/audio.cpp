@@ -13,10 +13,14 @@
 //=============================================================================
 
 #include <math.h>
+#include <array>
+#include <atomic>
+#include <thread>
 
 #include "core/platform.h"
 #include "util/wgt2allg.h"
 #include "media/audio/audio.h"
+#include "media/audio/audiocommandqueue.h"
 #include "ac/audiocliptype.h"
 #include "ac/gamesetupstruct.h"
 #include "ac/dynobj/cc_audioclip.h"
@@ -38,10 +42,83 @@
 #include "core/assetmanager.h"
 #include "ac/timer.h"
 #include "main/game_run.h"
+#include "platform/base/agsplatformdriver.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
 
+//-----------------------
+// Audio thread commands.
+// The audio thread keeps its own list of the channel clips, which is only
+// changed by the commands from the game, so that it never has to wait for
+// the game thread; when there's no audio thread, commands run immediately.
+
+static AudioCommandQueue _audioCommands;
+static std::array<SOUNDCLIP *,MAX_SOUND_CHANNELS+1> _pollChannels;
+static std::atomic<bool> _audioThreadRunning(false);
+
+static void run_audio_command(const AudioCommand &cmd)
+{
+    switch (cmd.Type)
+    {
+    case kAudioCmd_SetChannel:
+        _pollChannels[cmd.Channel] = cmd.Clip;
+        break;
+    case kAudioCmd_Seek:
+        cmd.Clip->seek(cmd.Value);
+        cmd.Clip->pendingSeeks--;
+        break;
+    case kAudioCmd_Destroy:
+        for (auto &ch : _pollChannels)
+            if (ch == cmd.Clip)
+                ch = nullptr;
+        cmd.Clip->destroy();
+        delete cmd.Clip;
+        break;
+    default:
+        break;
+    }
+}
+
+static void run_audio_commands()
+{
+    AudioCommand cmd;
+    while (_audioCommands.Pop(cmd))
+        run_audio_command(cmd);
+}
+
+static void send_audio_command(const AudioCommand &cmd)
+{
+    if (!_audioThreadRunning)
+    {
+        run_audio_command(cmd);
+        return;
+    }
+    // the audio thread runs commands on each update, so the queue may
+    // only overflow if there's a burst of them; wait for a free slot then
+    while (!_audioCommands.Push(cmd))
+        std::this_thread::yield();
+}
+
+void seek_clip(SOUNDCLIP *clip, int pos)
+{
+    clip->pendingSeeks++;
+    send_audio_command(AudioCommand(kAudioCmd_Seek, -1, clip, pos));
+}
+
+void wait_clip_seek(SOUNDCLIP *clip)
+{
+    // the audio thread runs commands on each update, so this takes at most
+    // one update period
+    while (clip->pendingSeeks > 0 && _audioThreadRunning)
+        std::this_thread::yield();
+}
+
+void destroy_clip(SOUNDCLIP *clip)
+{
+    send_audio_command(AudioCommand(kAudioCmd_Destroy, -1, clip));
+}
+
 //-----------------------
 //sound channel management; all access goes through here, which can't be done without a lock
 
@@ -67,6 +144,7 @@ SOUNDCLIP *AudioChannelsLock::SetChannel(int index, SOUNDCLIP* ch)
     else if (_channels[index] != nullptr && ch != nullptr)
         Debug::Printf(kDbgMsg_Warn, "WARNING: channel %d - clip overwritten", index);
     _channels[index] = ch;
+    send_audio_command(AudioCommand(kAudioCmd_SetChannel, index, ch));
     return ch;
 }
 
@@ -74,6 +152,7 @@ SOUNDCLIP *AudioChannelsLock::MoveChannel(int to, int from)
 {
     auto from_ch = _channels[from];
     _channels[from] = nullptr;
+    send_audio_command(AudioCommand(kAudioCmd_SetChannel, from, nullptr));
     return SetChannel(to, from_ch);
 }
 
@@ -117,7 +196,7 @@ ScriptAudioChannel scrAudioChannel[MAX_SOUND_CHANNELS + 1];
 char acaudio_buffer[256];
 int reserved_channel_count = 0;
 
-AGS::Engine::Thread audioThread;
+static AGS::Engine::Thread audioThread;
 
 void calculate_reserved_channel_count()
 {
@@ -256,10 +335,14 @@ SOUNDCLIP *load_sound_clip(ScriptAudioClip *audioClip, bool repeat)
     switch (audioClip->fileType)
     {
     case eAudioFileOGG:
-        soundClip = my_load_static_ogg(asset_name, audioClip->defaultVolume, repeat);
+        soundClip = my_load_decoded_sound(asset_name, audioClip->defaultVolume, repeat, MUS_OGG);
+        if (!soundClip)
+            soundClip = my_load_static_ogg(asset_name, audioClip->defaultVolume, repeat);
         break;
     case eAudioFileMP3:
-        soundClip = my_load_static_mp3(asset_name, audioClip->defaultVolume, repeat);
+        soundClip = my_load_decoded_sound(asset_name, audioClip->defaultVolume, repeat, MUS_MP3);
+        if (!soundClip)
+            soundClip = my_load_static_mp3(asset_name, audioClip->defaultVolume, repeat);
         break;
     case eAudioFileWAV:
     case eAudioFileVOC:
@@ -529,9 +612,8 @@ void stop_and_destroy_channel_ex(int chid, bool resetLegacyMusicSettings)
     SOUNDCLIP* ch = lock.GetChannel(chid);
 
     if (ch != nullptr) {
-        ch->destroy();
-        delete ch;
         lock.SetChannel(chid, nullptr);
+        destroy_clip(ch);
         ch = nullptr;
     }
 
@@ -935,18 +1017,43 @@ extern volatile char want_exit;
 
 void update_mp3_thread()
 {
-	if (switching_away_from_game) { return; }
+    run_audio_commands();
 
-    AudioChannelsLock lock;
+	if (switching_away_from_game) { return; }
 
-    for(int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+    for (auto *ch : _pollChannels)
     {
-        auto* ch = lock.GetChannel(i);
         if (ch)
             ch->poll();
     }
 }
 
+static void audio_thread_update()
+{
+    update_mp3_thread();
+    // streams refill their buffers in large chunks, but the commands should
+    // be handled without noticeable delay
+    platform->Delay(10);
+}
+
+bool start_audio_thread()
+{
+    _audioThreadRunning = true;
+    if (audioThread.CreateAndStart(audio_thread_update, true))
+        return true;
+    _audioThreadRunning = false;
+    run_audio_commands();
+    return false;
+}
+
+void stop_audio_thread()
+{
+    audioThread.Stop();
+    _audioThreadRunning = false;
+    // complete whatever was not handled by the thread
+    run_audio_commands();
+}
+
 //this is called at various points to give streaming logic a chance to update
 //it seems those calls have been littered around and points where it ameliorated skipping
 //a better solution would be to forcibly thread the streaming logic
@@ -1219,18 +1326,19 @@ static void play_new_music(int mnum, SOUNDCLIP *music)
     else
         new_clip = load_music_from_disk(mnum, (play.music_repeat > 0));
 
-    AudioChannelsLock lock;
-    auto* ch = lock.SetChannel(useChannel, new_clip);
-    if (ch != nullptr) {
-        if (!ch->play()) {
+    // start the clip before assigning to the channel, as the audio thread
+    // may begin polling it right away
+    if (new_clip != nullptr) {
+        if (!new_clip->play()) {
             // previous behavior was to set channel[] to null on error, so continue to do that here.
-            ch->destroy();
-            delete ch;
-            ch = nullptr;
-            lock.SetChannel(useChannel, nullptr);
+            new_clip->destroy();
+            delete new_clip;
+            new_clip = nullptr;
         } else
-            current_music_type = ch->get_sound_type();
+            current_music_type = new_clip->get_sound_type();
     }
+    AudioChannelsLock lock;
+    lock.SetChannel(useChannel, new_clip);
 
     post_new_music_check(useChannel);
     update_music_volume();
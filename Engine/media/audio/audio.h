@@ -27,11 +27,9 @@
 
 struct SOUNDCLIP;
 
-//controls access to the channels, since that's the main point of synchronization between the streaming thread and the user code
+//controls access to the channels from the game side;
+//the audio thread does not use it, as it receives channel changes through the command queue
 //this is going to be dependent on the underlying mutexes being recursive
-//yes, we will have more recursive traffic on mutexes than we need
-//however this should mostly be happening only when playing sounds, and possibly when sounds numbering only several
-//the load should not be high
 class AudioChannelsLock : public AGS::Engine::MutexLock
 {
 private:
@@ -64,6 +62,14 @@ bool channel_has_clip(int chanid);
 bool channel_is_playing(int chanid);
 // Sets new clip to the channel
 void set_clip_to_channel(int chanid, SOUNDCLIP *clip);
+// Changes clip's playback position; done on the audio thread, if one is running
+void seek_clip(SOUNDCLIP *clip, int pos);
+// Waits until the clip's seeks sent to the audio thread are done; should be
+// called before reading the clip's position
+void wait_clip_seek(SOUNDCLIP *clip);
+// Stops and deletes the clip, which may be still used by the audio thread;
+// the clip must be removed from the channel before calling this
+void destroy_clip(SOUNDCLIP *clip);
 
 
 void        calculate_reserved_channel_count();
@@ -129,12 +135,15 @@ ScriptAudioClip *get_audio_clip_for_music(int mnum);
 SOUNDCLIP * load_music_from_disk(int mnum, bool doRepeat);
 void        newmusic(int mnum);
 
-extern AGS::Engine::Thread audioThread;
 extern volatile bool _audio_doing_crossfade;
 extern volatile int psp_audio_multithreaded;
 
 void update_polled_mp3();
 void update_mp3_thread();
+// Starts the thread which updates the playing clips; returns false if
+// threads are not available, in which case clips are updated by the game
+bool start_audio_thread();
+void stop_audio_thread();
 
 extern void cancel_scheduled_music_update();
 extern void schedule_music_update_at(AGS_Clock::time_point);
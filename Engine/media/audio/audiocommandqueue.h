@@ -0,0 +1,99 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Commands passed from the game thread to the audio thread.
+//
+// The queue has exactly one writer (game thread) and one reader (audio
+// thread), which lets it work without locking: each side only modifies its
+// own position index, and reads the other one.
+//
+//=============================================================================
+#ifndef __AC_AUDIOCOMMANDQUEUE_H
+#define __AC_AUDIOCOMMANDQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+struct SOUNDCLIP;
+
+enum AudioCommandType
+{
+    kAudioCmd_None,
+    // Assign clip to the channel polled by the audio thread (or clear it)
+    kAudioCmd_SetChannel,
+    // Change playback position of the clip
+    kAudioCmd_Seek,
+    // Stop playback and dispose the clip; the clip must not be referenced
+    // by the game anymore
+    kAudioCmd_Destroy
+};
+
+struct AudioCommand
+{
+    AudioCommandType Type;
+    int              Channel;
+    SOUNDCLIP       *Clip;
+    int              Value;
+
+    AudioCommand()
+        : Type(kAudioCmd_None), Channel(-1), Clip(nullptr), Value(0) {}
+    AudioCommand(AudioCommandType type, int channel, SOUNDCLIP *clip, int value = 0)
+        : Type(type), Channel(channel), Clip(clip), Value(value) {}
+};
+
+class AudioCommandQueue
+{
+public:
+    AudioCommandQueue()
+        : _head(0), _tail(0) {}
+
+    // Puts the command at the end of the queue; fails if the queue is full.
+    // Must only be called by the writing thread.
+    bool Push(const AudioCommand &cmd)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % QueueSize;
+        if (next == _head.load(std::memory_order_acquire))
+            return false;
+        _items[tail] = cmd;
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Takes the command from the front of the queue; fails if the queue is empty.
+    // Must only be called by the reading thread.
+    bool Pop(AudioCommand &cmd)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        cmd = _items[head];
+        _head.store((head + 1) % QueueSize, std::memory_order_release);
+        return true;
+    }
+
+    bool IsEmpty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static const size_t QueueSize = 256;
+
+    AudioCommand        _items[QueueSize];
+    std::atomic<size_t> _head; // next command to read
+    std::atomic<size_t> _tail; // next free slot to write
+};
+
+#endif // __AC_AUDIOCOMMANDQUEUE_H
@@ -33,6 +33,7 @@ void al_duh_set_loop(AL_DUH_PLAYER *dp, int loop) {
 
 void MYMOD::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     if (al_poll_duh(duhPlayer)) {
@@ -42,18 +43,21 @@ void MYMOD::poll()
 
 void MYMOD::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     al_duh_set_volume(duhPlayer, VOLUME_TO_DUMB_VOL(get_final_volume()));
 }
 
 void MYMOD::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     adjust_volume();
 }
 
 void MYMOD::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (duhPlayer) {
         al_stop_duh(duhPlayer);
     }
@@ -69,6 +73,7 @@ void MYMOD::destroy()
 
 void MYMOD::seek(int patnum)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
 
     al_stop_duh(duhPlayer);
@@ -87,6 +92,7 @@ void MYMOD::seek(int patnum)
 
 int MYMOD::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
 
     // determine the current track number (DUMB calls them 'orders')
@@ -106,6 +112,7 @@ int MYMOD::get_real_mod_pos()
 
 int MYMOD::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
     return (get_real_mod_pos() * 10) / 655;
 }
@@ -126,12 +133,14 @@ int MYMOD::get_voice()
 }
 
 void MYMOD::pause() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
     al_pause_duh(duhPlayer);
     state_ = SoundClipPaused;
 }
 
 void MYMOD::resume() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPaused) { return; }
     al_resume_duh(duhPlayer);
     state_ = SoundClipPlaying;
@@ -142,6 +151,7 @@ int MYMOD::get_sound_type() {
 }
 
 int MYMOD::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune == nullptr) { return 0; }
     
     duhPlayer = al_start_duh(tune, 2, 0, 1.0, 8192, 22050);
@@ -21,6 +21,7 @@
 
 int MYMOD::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (done)
         return done;
 
@@ -32,6 +33,7 @@ int MYMOD::poll()
 
 void MYMOD::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     if (!done)
         set_mod_volume(newvol);
@@ -39,6 +41,7 @@ void MYMOD::set_volume(int newvol)
 
 void MYMOD::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     stop_mod();
     destroy_mod(tune);
     tune = NULL;
@@ -46,12 +49,14 @@ void MYMOD::destroy()
 
 void MYMOD::seek(int patnum)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (is_mod_playing() != 0)
         goto_mod_track(patnum);
 }
 
 int MYMOD::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_mod_playing())
         return -1;
     return mi.trk;
@@ -59,6 +64,7 @@ int MYMOD::get_pos()
 
 int MYMOD::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     return 0;                   // we don't know ms offset
 }
 
@@ -78,6 +84,7 @@ int MYMOD::get_sound_type() {
 }
 
 int MYMOD::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     play_mod(tune, repeat);
 
     return 1;
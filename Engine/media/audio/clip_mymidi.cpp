@@ -19,6 +19,7 @@
 
 void MYMIDI::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     if (midi_pos < 0)
@@ -27,18 +28,21 @@ void MYMIDI::poll()
 
 void MYMIDI::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     ::set_volume(-1, get_final_volume());
 }
 
 void MYMIDI::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     adjust_volume();
 }
 
 void MYMIDI::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     stop_midi();
     
     if (tune) {
@@ -51,18 +55,21 @@ void MYMIDI::destroy()
 
 void MYMIDI::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     midi_seek(pos);
 }
 
 int MYMIDI::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
     return midi_pos;
 }
 
 int MYMIDI::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     return 0;                   // we don't know ms with midi
 }
 
@@ -78,12 +85,14 @@ int MYMIDI::get_voice()
 }
 
 void MYMIDI::pause() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
     midi_pause();
     state_ = SoundClipPaused;
 }
 
 void MYMIDI::resume() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPaused) { return; }
     midi_resume();
     state_ = SoundClipPlaying;
@@ -94,6 +103,7 @@ int MYMIDI::get_sound_type() {
 }
 
 int MYMIDI::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune == nullptr) { return 0; }
 
     lengthInSeconds = get_midi_length(tune);
@@ -27,6 +27,7 @@
 
 void MYMP3::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     // update the buffer
@@ -61,6 +62,7 @@ void MYMP3::poll()
 
 void MYMP3::adjust_stream()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     almp3_adjust_mp3stream(stream, get_final_volume(), panning, speed);
@@ -68,11 +70,13 @@ void MYMP3::adjust_stream()
 
 void MYMP3::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     adjust_stream();
 }
 
 void MYMP3::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     // boost MP3 volume
     newvol += 20;
     if (newvol > 255)
@@ -84,12 +88,14 @@ void MYMP3::set_volume(int newvol)
 
 void MYMP3::set_speed(int new_speed)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     speed = new_speed;
     adjust_stream();
 }
 
 void MYMP3::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (stream) {
         AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
         almp3_stop_mp3stream(stream);
@@ -108,18 +114,21 @@ void MYMP3::destroy()
 
 void MYMP3::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     quit("Tried to seek an mp3stream");
 }
 
 int MYMP3::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     return 0; // Return 0 to signify that Seek is not supported
     // return almp3_get_pos_msecs_mp3stream (stream);
 }
 
 int MYMP3::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
 	AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     return almp3_get_pos_msecs_mp3stream(stream);
@@ -145,6 +154,7 @@ int MYMP3::get_sound_type() {
 }
 
 int MYMP3::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (in == nullptr) { return 0; }
 
     {
@@ -30,6 +30,7 @@ extern "C" {
 
 void MYOGG::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     AGS_PACKFILE_OBJ* obj = (AGS_PACKFILE_OBJ*)in->userdata;
@@ -61,17 +62,20 @@ void MYOGG::poll()
 
 void MYOGG::adjust_stream()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     alogg_adjust_oggstream(stream, get_final_volume(), panning, speed);
 }
 
 void MYOGG::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     adjust_stream();
 }
 
 void MYOGG::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     // boost MP3 volume
     newvol += 20;
     if (newvol > 255)
@@ -82,12 +86,14 @@ void MYOGG::set_volume(int newvol)
 
 void MYOGG::set_speed(int new_speed)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     speed = new_speed;
     adjust_stream();
 }
 
 void MYOGG::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (stream) {
         alogg_stop_oggstream(stream);
         alogg_destroy_oggstream(stream);
@@ -105,17 +111,20 @@ void MYOGG::destroy()
 
 void MYOGG::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     quit("Attempted to seek an oggstream; operation not permitted");
 }
 
 int MYOGG::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     return 0;
 }
 
 int MYOGG::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     // Unfortunately the alogg_get_pos_msecs_oggstream function
     // returns the ms offset that was last decoded, so it's always
     // ahead of the actual playback. Therefore we have this
@@ -178,6 +187,7 @@ int MYOGG::get_sound_type() {
 }
 
 int MYOGG::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (in == nullptr) { return 0; }
     
     if (alogg_play_oggstream(stream, MP3CHUNKSIZE, (vol > 230) ? vol : vol + 20, panning) != ALOGG_OK) {
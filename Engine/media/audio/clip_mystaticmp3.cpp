@@ -31,6 +31,7 @@ AGS::Engine::Mutex _mp3_mutex;
 
 void MYSTATICMP3::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     int oldeip = our_eip;
@@ -51,6 +52,7 @@ void MYSTATICMP3::poll()
 
 void MYSTATICMP3::adjust_stream()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     almp3_adjust_mp3(tune, get_final_volume(), panning, speed, repeat);
@@ -58,23 +60,27 @@ void MYSTATICMP3::adjust_stream()
 
 void MYSTATICMP3::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     adjust_stream();
 }
 
 void MYSTATICMP3::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     adjust_stream();
 }
 
 void MYSTATICMP3::set_speed(int new_speed)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     speed = new_speed;
     adjust_stream();
 }
 
 void MYSTATICMP3::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune) {
         AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
         almp3_stop_mp3(tune);
@@ -92,6 +98,7 @@ void MYSTATICMP3::destroy()
 
 void MYSTATICMP3::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     almp3_seek_abs_msecs_mp3(tune, pos);
@@ -99,6 +106,7 @@ void MYSTATICMP3::seek(int pos)
 
 int MYSTATICMP3::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     return almp3_get_pos_msecs_mp3(tune);
@@ -106,6 +114,7 @@ int MYSTATICMP3::get_pos()
 
 int MYSTATICMP3::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     int result = get_pos();
     return result;
 }
@@ -130,6 +139,7 @@ int MYSTATICMP3::get_sound_type() {
 }
 
 int MYSTATICMP3::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune == nullptr) { return 0; }
 
     {
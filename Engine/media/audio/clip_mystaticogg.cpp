@@ -31,6 +31,7 @@ extern int use_extra_sound_offset;  // defined in ac.cpp
 
 void MYSTATICOGG::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     if (alogg_poll_ogg(tune) == ALOGG_POLL_PLAYJUSTFINISHED) {
@@ -44,29 +45,34 @@ void MYSTATICOGG::poll()
 
 void MYSTATICOGG::adjust_stream()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     alogg_adjust_ogg(tune, get_final_volume(), panning, speed, repeat);
 }
 
 void MYSTATICOGG::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     adjust_stream();
 }
 
 void MYSTATICOGG::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     adjust_stream();
 }
 
 void MYSTATICOGG::set_speed(int new_speed)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     speed = new_speed;
     adjust_stream();
 }
 
 void MYSTATICOGG::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune) {
         alogg_stop_ogg(tune);
         alogg_destroy_ogg(tune);
@@ -83,6 +89,7 @@ void MYSTATICOGG::destroy()
 
 void MYSTATICOGG::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
 
     // we stop and restart it because otherwise the buffer finishes
@@ -94,12 +101,14 @@ void MYSTATICOGG::seek(int pos)
 
 int MYSTATICOGG::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
     return get_pos_ms();
 }
 
 int MYSTATICOGG::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
 
     // Unfortunately the alogg_get_pos_msecs function
@@ -164,6 +173,7 @@ int MYSTATICOGG::get_sound_type() {
 
 int MYSTATICOGG::play_from(int position)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (tune == nullptr) { return 0; }
 
     if (use_extra_sound_offset) 
@@ -191,6 +201,7 @@ int MYSTATICOGG::play_from(int position)
 }
 
 int MYSTATICOGG::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     return play_from(0);
 }
 
@@ -23,6 +23,7 @@
 
 void MYWAVE::poll()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     if (voice_get_position(voice) < 0)
@@ -33,6 +34,7 @@ void MYWAVE::poll()
 
 void MYWAVE::adjust_volume()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     if (voice < 0) { return; }
     voice_set_volume(voice, get_final_volume());
@@ -40,12 +42,14 @@ void MYWAVE::adjust_volume()
 
 void MYWAVE::set_volume(int newvol)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     vol = newvol;
     adjust_volume();
 }
 
 void MYWAVE::destroy()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     // Stop sound and decrease reference count.
     if (wave) {
         stop_sample(wave);
@@ -58,18 +62,25 @@ void MYWAVE::destroy()
 
 void MYWAVE::seek(int pos)
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
+    if (sound_type != MUS_WAVE)
+        pos = (int)(((int64_t)pos * voice_get_frequency(voice)) / 1000);
     voice_set_position(voice, pos);
 }
 
 int MYWAVE::get_pos()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return -1; }
+    if (sound_type != MUS_WAVE)
+        return get_pos_ms();
     return voice_get_position(voice);
 }
 
 int MYWAVE::get_pos_ms()
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     // convert the offset in samples into the offset in ms
     //return ((1000000 / voice_get_frequency(voice)) * voice_get_position(voice)) / 1000;
 
@@ -94,10 +105,11 @@ int MYWAVE::get_voice()
 }
 
 int MYWAVE::get_sound_type() {
-    return MUS_WAVE;
+    return sound_type;
 }
 
 int MYWAVE::play() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (wave == nullptr) { return 0; }
 
     voice = play_sample(wave, vol, panning, 1000, repeat);
@@ -113,4 +125,5 @@ int MYWAVE::play() {
 MYWAVE::MYWAVE() : SOUNDCLIP() {
     wave = nullptr;
     voice = -1;
+    sound_type = MUS_WAVE;
 }
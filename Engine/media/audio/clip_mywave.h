@@ -22,6 +22,9 @@ struct MYWAVE:public SOUNDCLIP
 {
     SAMPLE *wave;
     int voice;
+    // type of the sound asset; if it's not a wave, then the sample was
+    // decoded from compressed format, and positions are in milliseconds
+    int sound_type;
 
     void poll() override;
 
@@ -78,6 +78,54 @@ SOUNDCLIP *my_load_wave(const AssetPath &asset_name, int voll, int loop)
     return thiswave;
 }
 
+static SAMPLE *decode_ogg(const char *data, size_t size)
+{
+    ALOGG_OGG *ogg = alogg_create_ogg_from_buffer((void*)data, (int)size);
+    if (ogg == nullptr)
+        return nullptr;
+    SAMPLE *sample = alogg_create_sample_from_ogg(ogg);
+    alogg_destroy_ogg(ogg);
+    return sample;
+}
+
+#ifndef NO_MP3_PLAYER
+static SAMPLE *decode_mp3(const char *data, size_t size)
+{
+    AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
+    ALMP3_MP3 *mp3 = almp3_create_mp3((void*)data, (int)size);
+    if (mp3 == nullptr)
+        return nullptr;
+    SAMPLE *sample = almp3_create_sample_from_mp3(mp3);
+    almp3_destroy_mp3(mp3);
+    return sample;
+}
+#endif
+
+SOUNDCLIP *my_load_decoded_sound(const AssetPath &asset_name, int voll, bool loop, int sound_type)
+{
+    SoundDecodeFunc decode = nullptr;
+    if (sound_type == MUS_OGG)
+        decode = decode_ogg;
+#ifndef NO_MP3_PLAYER
+    else if (sound_type == MUS_MP3)
+        decode = decode_mp3;
+#endif
+    if (decode == nullptr)
+        return nullptr;
+
+    SAMPLE *new_sample = get_cached_decoded_sound(asset_name, decode);
+    if (new_sample == nullptr)
+        return nullptr;
+
+    thiswave = new MYWAVE();
+    thiswave->wave = new_sample;
+    thiswave->vol = voll;
+    thiswave->repeat = loop;
+    thiswave->sound_type = sound_type;
+
+    return thiswave;
+}
+
 PACKFILE *mp3in;
 
 #ifndef NO_MP3_PLAYER
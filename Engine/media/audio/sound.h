@@ -23,6 +23,9 @@
 #include "media/audio/soundclip.h"
 
 SOUNDCLIP *my_load_wave(const AssetPath &asset_name, int voll, int loop);
+// Loads compressed sound as a decoded sample, if sound cache allows that;
+// sound_type tells the format of the asset, either MUS_OGG or MUS_MP3
+SOUNDCLIP *my_load_decoded_sound(const AssetPath &asset_name, int voll, bool loop, int sound_type);
 SOUNDCLIP *my_load_mp3(const AssetPath &asset_name, int voll);
 SOUNDCLIP *my_load_static_mp3(const AssetPath &asset_name, int voll, bool loop);
 SOUNDCLIP *my_load_static_ogg(const AssetPath &asset_name, int voll, bool loop);
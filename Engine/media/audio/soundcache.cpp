@@ -12,8 +12,11 @@
 //
 //=============================================================================
 
+#include <list>
 #include <stdlib.h>
 #include <string.h>
+#include <unordered_map>
+#include <unordered_set>
 #include "ac/file.h"
 #include "util/wgt2allg.h"
 #include "media/audio/soundcache.h"
@@ -21,40 +24,156 @@
 #include "util/mutex.h"
 #include "util/mutex_lock.h"
 #include "util/string.h"
+#include "util/string_types.h"
 #include "debug/out.h"
 
 using namespace Common;
 
-sound_cache_entry_t* sound_cache_entries = nullptr;
-unsigned int sound_cache_counter = 0;
+struct SoundCacheEntry
+{
+    String Key;
+    char  *Data;
+    size_t Size;     // memory used by the data
+    bool   IsSample; // data is a SAMPLE
+    int    Refs;     // number of clips using this data
+};
+
+typedef std::list<SoundCacheEntry> SoundCacheList;
+// Entries ordered from the most recently used to the least recently used
+static SoundCacheList sound_cache;
+static std::unordered_map<String, SoundCacheList::iterator> sound_cache_index;
+static std::unordered_map<const char*, SoundCacheList::iterator> sound_cache_data;
+// Assets which were found too large to be decoded
+static std::unordered_set<String> sound_cache_nodecode;
+static size_t sound_cache_max_size = DEFAULTSOUNDCACHESIZE_KB * 1024;
+static size_t sound_cache_decode_limit = 0;
+static SoundCacheStats sound_cache_stats;
 
 AGS::Engine::Mutex _sound_cache_mutex;
 
 
-void clear_sound_cache()
+static String make_cache_key(const AssetPath &asset_name, bool decoded)
 {
-    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+    return String::FromFormat("%s|%s%s", asset_name.first.GetCStr(),
+        asset_name.second.GetCStr(), decoded ? "|pcm" : "");
+}
+
+static size_t get_sample_size(const SAMPLE *sample)
+{
+    return (size_t)sample->len * (sample->stereo ? 2 : 1) * (sample->bits / 8);
+}
+
+static void free_sound_data(char *data, bool is_sample)
+{
+    if (is_sample)
+        destroy_sample((SAMPLE*)data);
+    else
+        free(data);
+}
+
+static void remove_entry(SoundCacheList::iterator it)
+{
+    sound_cache_index.erase(it->Key);
+    sound_cache_data.erase(it->Data);
+    sound_cache_stats.CachedSize -= it->Size;
+    sound_cache.erase(it);
+}
 
-    if (sound_cache_entries)
+// Releases least recently used unreferenced entries until the new data
+// of the given size fits into the limit; returns false if that's not possible
+static bool make_room(size_t size)
+{
+    if (size > sound_cache_max_size)
+        return false;
+    for (auto it = sound_cache.end(); it != sound_cache.begin() &&
+         sound_cache_stats.CachedSize + size > sound_cache_max_size; )
     {
-        int i;
-        for (i = 0; i < psp_audio_cachesize; i++)
-        {
-            if (sound_cache_entries[i].data)
-            {
-                free(sound_cache_entries[i].data);
-                sound_cache_entries[i].data = nullptr;
-                free(sound_cache_entries[i].file_name);
-                sound_cache_entries[i].file_name = nullptr;
-                sound_cache_entries[i].reference = 0;
-            }
-        }
+        --it;
+        if (it->Refs > 0)
+            continue;
+#ifdef SOUND_CACHE_DEBUG
+        Debug::Printf("..evicting %s\n", it->Key.GetCStr());
+#endif
+        free_sound_data(it->Data, it->IsSample);
+        sound_cache_stats.Evictions++;
+        remove_entry(it++);
     }
-    else
+    return sound_cache_stats.CachedSize + size <= sound_cache_max_size;
+}
+
+// Returns referenced data from the cache, or NULL if there's no such entry
+static char *find_cached(const String &key, size_t &size)
+{
+    auto found = sound_cache_index.find(key);
+    if (found == sound_cache_index.end())
     {
-        sound_cache_entries = (sound_cache_entry_t*)malloc(psp_audio_cachesize * sizeof(sound_cache_entry_t));
-        memset(sound_cache_entries, 0, psp_audio_cachesize * sizeof(sound_cache_entry_t));
+        sound_cache_stats.Misses++;
+        return nullptr;
     }
+    sound_cache_stats.Hits++;
+    auto it = found->second;
+    it->Refs++;
+    sound_cache.splice(sound_cache.begin(), sound_cache, it);
+    size = it->IsSample ? 0 : it->Size;
+    return it->Data;
+}
+
+// Puts the newly loaded data in cache, if there's room for it
+static void add_cached(const String &key, char *data, size_t size, bool is_sample)
+{
+    if (!make_room(size))
+    {
+#ifdef SOUND_CACHE_DEBUG
+        Debug::Printf("..loading uncached\n");
+#endif
+        return;
+    }
+    SoundCacheEntry entry;
+    entry.Key = key;
+    entry.Data = data;
+    entry.Size = size;
+    entry.IsSample = is_sample;
+    entry.Refs = 1;
+    sound_cache.push_front(entry);
+    sound_cache_index[key] = sound_cache.begin();
+    sound_cache_data[data] = sound_cache.begin();
+    sound_cache_stats.CachedSize += size;
+}
+
+void set_sound_cache_max_size(size_t size)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+    sound_cache_max_size = size;
+    make_room(0);
+}
+
+void set_sound_cache_decode_limit(size_t size)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+    sound_cache_decode_limit = size;
+    sound_cache_nodecode.clear();
+}
+
+void clear_sound_cache()
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+    if (sound_cache_stats.Hits + sound_cache_stats.Misses > 0)
+        Debug::Printf(kDbgMsg_Info, "Sound cache: %u hits, %u misses, %u evictions, %u KB used",
+            (unsigned)sound_cache_stats.Hits, (unsigned)sound_cache_stats.Misses,
+            (unsigned)sound_cache_stats.Evictions, (unsigned)(sound_cache_stats.CachedSize / 1024));
+
+    // Referenced data is only forgotten here, and freed by sound_cache_free
+    for (auto &entry : sound_cache)
+    {
+        if (entry.Refs == 0)
+            free_sound_data(entry.Data, entry.IsSample);
+    }
+    sound_cache.clear();
+    sound_cache_index.clear();
+    sound_cache_data.clear();
+    sound_cache_nodecode.clear();
+    sound_cache_stats.CachedSize = 0;
 }
 
 void sound_cache_free(char* buffer, bool is_wave)
@@ -64,33 +183,22 @@ void sound_cache_free(char* buffer, bool is_wave)
 #ifdef SOUND_CACHE_DEBUG
     Debug::Printf("sound_cache_free(%p %d)\n", buffer, (unsigned int)is_wave);
 #endif
-    int i;
-    for (i = 0; i < psp_audio_cachesize; i++)
+    auto found = sound_cache_data.find(buffer);
+    if (found != sound_cache_data.end())
     {
-        if (sound_cache_entries[i].data == buffer)
-        {
-            if (sound_cache_entries[i].reference > 0)
-                sound_cache_entries[i].reference--;
-
+        if (found->second->Refs > 0)
+            found->second->Refs--;
 #ifdef SOUND_CACHE_DEBUG
-            Debug::Printf("..decreased reference count of slot %d to %d\n", i, sound_cache_entries[i].reference);
+        Debug::Printf("..decreased reference count of %s to %d\n", found->second->Key.GetCStr(), found->second->Refs);
 #endif
-            return;
-        }
+        return;
     }
 
 #ifdef SOUND_CACHE_DEBUG
     Debug::Printf("..freeing uncached sound\n");
 #endif
-
     // Sound is uncached
-    if (i == psp_audio_cachesize)
-    {
-        if (is_wave)
-            destroy_sample((SAMPLE*)buffer);
-        else
-            free(buffer);
-    }
+    free_sound_data(buffer, is_wave);
 }
 
 
@@ -99,136 +207,110 @@ char* get_cached_sound(const AssetPath &asset_name, bool is_wave, size_t &size)
 	AGS::Engine::MutexLock _lock(_sound_cache_mutex);
 
 #ifdef SOUND_CACHE_DEBUG
-    Debug::Printf("get_cached_sound(%s %d)\n", asset_name.first.GetCStr(), (unsigned int)is_wave);
+    Debug::Printf("get_cached_sound(%s %d)\n", asset_name.second.GetCStr(), (unsigned int)is_wave);
 #endif
 
     size = 0;
+    const String key = make_cache_key(asset_name, false);
+    char *data = find_cached(key, size);
+    if (data)
+        return data;
 
-    int i;
-    for (i = 0; i < psp_audio_cachesize; i++)
-    {
-        if (sound_cache_entries[i].data == nullptr)
-            continue;
-
-        if (strcmp(asset_name.second, sound_cache_entries[i].file_name) == 0)
-        {
-#ifdef SOUND_CACHE_DEBUG
-            Debug::Printf("..found in slot %d\n", i);
-#endif
-            sound_cache_entries[i].reference++;
-            sound_cache_entries[i].last_used = sound_cache_counter++;
-            size = sound_cache_entries[i].size;
-
-            return sound_cache_entries[i].data;
-        }
-    }
-
-    // Not found
-    PACKFILE *mp3in = nullptr;
-    SAMPLE* wave = nullptr;
-
+    // Not found, load new file
     if (is_wave)
     {
         PACKFILE *wavin = PackfileFromAsset(asset_name, size);
-        if (wavin != nullptr)
-        {
-            wave = load_wav_pf(wavin);
-            pack_fclose(wavin);
-        }
-    }  
+        if (wavin == nullptr)
+            return nullptr;
+        SAMPLE *wave = load_wav_pf(wavin);
+        pack_fclose(wavin);
+        size = 0; // ??? CHECKME
+        if (wave == nullptr)
+            return nullptr;
+        data = (char*)wave;
+        add_cached(key, data, get_sample_size(wave), true);
+    }
     else
     {
-        mp3in = PackfileFromAsset(asset_name, size);
+        PACKFILE *mp3in = PackfileFromAsset(asset_name, size);
         if (mp3in == nullptr)
+            return nullptr;
+        data = (char *)malloc(size);
+        if (data == nullptr)
         {
+            pack_fclose(mp3in);
             return nullptr;
         }
+        pack_fread(data, size, mp3in);
+        pack_fclose(mp3in);
+        add_cached(key, data, size, false);
     }
+    return data;
+}
 
-    // Find free slot
-    for (i = 0; i < psp_audio_cachesize; i++)
-    {
-        if (sound_cache_entries[i].data == nullptr)
-            break;
-    }
-
-    // No free slot?
-    if (i == psp_audio_cachesize)
+SAMPLE* get_cached_decoded_sound(const AssetPath &asset_name, SoundDecodeFunc decode)
+{
+    size_t size = 0;
+    size_t decode_limit;
+    const String key = make_cache_key(asset_name, true);
     {
-        unsigned int oldest = sound_cache_counter;
-        int index = -1;
-
-        for (i = 0; i < psp_audio_cachesize; i++)
-        {
-            if (sound_cache_entries[i].reference == 0)
-            {
-                if (sound_cache_entries[i].last_used < oldest)
-                {
-                    oldest = sound_cache_entries[i].last_used;
-                    index = i;
-                }
-            }
-        }
-
-        i = index;
+        AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+        decode_limit = sound_cache_decode_limit;
+        if (decode_limit == 0)
+            return nullptr;
+        if (sound_cache_nodecode.count(key) > 0)
+            return nullptr;
+        char *data = find_cached(key, size);
+        if (data)
+            return (SAMPLE*)data;
     }
 
-    // Load new file
-    char* newdata;
-
-    if (is_wave)
+    // The clip is loaded and decoded without holding the lock,
+    // so that the other cache lookups don't wait for it
+    PACKFILE *in = PackfileFromAsset(asset_name, size);
+    if (in == nullptr)
+        return nullptr;
+    if (size > decode_limit)
     {
-        size = 0; // ??? CHECKME
-        newdata = (char*)wave;
+        pack_fclose(in);
+        AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+        // don't count as a miss, the asset will be requested undecoded
+        sound_cache_stats.Misses--;
+        sound_cache_nodecode.insert(key);
+        return nullptr;
     }
-    else
+    char *buf = (char *)malloc(size);
+    if (buf == nullptr)
     {
-        newdata = (char *)malloc(size);
-
-        if (newdata == nullptr)
-        {
-            pack_fclose(mp3in);
-            return nullptr;
-        }
-
-        pack_fread(newdata, size, mp3in);
-        pack_fclose(mp3in);
+        pack_fclose(in);
+        return nullptr;
     }
+    pack_fread(buf, size, in);
+    pack_fclose(in);
+    SAMPLE *sample = decode(buf, size);
+    free(buf);
 
-    if (i == -1)
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+    if (sample == nullptr)
     {
-        // No cache slot empty, return uncached data
-#ifdef SOUND_CACHE_DEBUG
-        Debug::Printf("..loading uncached\n");
-#endif
-        return newdata;  
+        sound_cache_nodecode.insert(key);
+        return nullptr;
     }
-    else
+    // the same clip could have been decoded and cached by another thread meanwhile
+    auto found = sound_cache_index.find(key);
+    if (found != sound_cache_index.end())
     {
-        // Add to cache, free old sound first
-#ifdef SOUND_CACHE_DEBUG
-        Debug::Printf("..loading cached in slot %d\n", i);
-#endif	
-
-        if (sound_cache_entries[i].data) {
-            if (sound_cache_entries[i].is_wave)
-                destroy_sample((SAMPLE*)sound_cache_entries[i].data);
-            else
-                free(sound_cache_entries[i].data);
-	}
-	
-        sound_cache_entries[i].size = size;
-        sound_cache_entries[i].data = newdata;
-
-        if (sound_cache_entries[i].file_name)
-            free(sound_cache_entries[i].file_name);
-        sound_cache_entries[i].file_name = (char*)malloc(strlen(asset_name.second) + 1);
-        strcpy(sound_cache_entries[i].file_name, asset_name.second);
-        sound_cache_entries[i].reference = 1;
-        sound_cache_entries[i].last_used = sound_cache_counter++;
-        sound_cache_entries[i].is_wave = is_wave;
-
-        return sound_cache_entries[i].data;	
+        destroy_sample(sample);
+        auto it = found->second;
+        it->Refs++;
+        sound_cache.splice(sound_cache.begin(), sound_cache, it);
+        return (SAMPLE*)it->Data;
     }
+    add_cached(key, (char*)sample, get_sample_size(sample), true);
+    return sample;
+}
 
+const SoundCacheStats &get_sound_cache_stats()
+{
+    return sound_cache_stats;
 }
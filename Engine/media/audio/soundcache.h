@@ -17,32 +17,47 @@
 
 #include "ac/asset_helper.h"
 
-// PSP: A simple sound cache. The size can be configured in the config file.
-// The data rate while reading from disk on the PSP is usually between 500 to 900 kiB/s,
-// caching the last used sound files therefore improves game performance.
+// Sound cache keeps recently used sound assets in memory, so that playing
+// them again does not require reading the file. Compressed sounds may be
+// optionally stored already decoded, if they are small enough.
+// The memory is limited by the total size of the cached data; the data which
+// was not used for the longest time is released first, but never the one
+// still referenced by a playing clip.
 
 //#define SOUND_CACHE_DEBUG
 
-typedef struct
-{
-    char* file_name;
-    int number;
-    int free;
-    unsigned int last_used;
-    unsigned int size;
-    char* data;
-    int reference;
-    bool is_wave;
-} sound_cache_entry_t;
-
-extern int psp_use_sound_cache;
-extern int psp_sound_cache_max_size;
-extern int psp_audio_cachesize;
+#define DEFAULTSOUNDCACHESIZE_KB (32 * 1024)
+
+struct SAMPLE;
+
 extern int psp_midi_preload_patches;
 
+struct SoundCacheStats
+{
+    size_t Hits = 0;       // requests served from the cache
+    size_t Misses = 0;     // requests which required loading the asset
+    size_t Evictions = 0;  // entries released to free space for the new ones
+    size_t CachedSize = 0; // total size of the cached data, in bytes
+};
+
+// Decodes compressed sound data into the PCM sample; returns NULL on failure
+typedef SAMPLE *(*SoundDecodeFunc)(const char *data, size_t size);
+
+// Sets max size of the cached data, in bytes
+void set_sound_cache_max_size(size_t size);
+// Sets max size of the compressed asset which may be stored decoded;
+// 0 disables storing the decoded sounds
+void set_sound_cache_decode_limit(size_t size);
+// Releases all the unreferenced data; the data which is still in use
+// gets freed when the last clip is done with it
 void clear_sound_cache();
 void sound_cache_free(char* buffer, bool is_wave);
+// Gets sound asset data (or loaded wave SAMPLE, if is_wave is set)
 char* get_cached_sound(const AssetPath &asset_name, bool is_wave, size_t &size);
+// Gets sound asset decoded into a SAMPLE; returns NULL if decoded sounds
+// are not cached, the asset is too large for it, or decoding failed
+SAMPLE* get_cached_decoded_sound(const AssetPath &asset_name, SoundDecodeFunc decode);
+const SoundCacheStats &get_sound_cache_stats();
 
 
 #endif // __AC_SOUNDCACHE_H
@@ -20,6 +20,7 @@
 
 int SOUNDCLIP::play_from(int position) 
 {
+    AGS::Engine::MutexLock _lock(_mutex);
     int retVal = play();
     if ((retVal != 0) && (position > 0))
     {
@@ -29,6 +30,7 @@ int SOUNDCLIP::play_from(int position)
 }
 
 void SOUNDCLIP::set_panning(int newPanning) {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (!is_playing()) { return; }
     
     int voice = get_voice();
@@ -39,6 +41,7 @@ void SOUNDCLIP::set_panning(int newPanning) {
 }
 
 void SOUNDCLIP::pause() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPlaying) { return; }
 
     int voice = get_voice();
@@ -49,6 +52,7 @@ void SOUNDCLIP::pause() {
 }
 
 void SOUNDCLIP::resume() {
+    AGS::Engine::MutexLock _lock(_mutex);
     if (state_ != SoundClipPaused) { return; }
 
     int voice = get_voice();
@@ -75,6 +79,7 @@ SOUNDCLIP::SOUNDCLIP() {
     ySource = -1;
     maximumPossibleDistanceAway = 0;
     directionalVolModifier = 0;
+    pendingSeeks = 0;
 }
 
 SOUNDCLIP::~SOUNDCLIP() = default;
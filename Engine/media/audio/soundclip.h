@@ -19,7 +19,9 @@
 #ifndef __AC_SOUNDCLIP_H
 #define __AC_SOUNDCLIP_H
 
+#include <atomic>
 #include "util/mutex.h"
+#include "util/mutex_lock.h"
 
 // JJS: This is needed for the derieved classes
 extern volatile int psp_audio_multithreaded;
@@ -50,6 +52,8 @@ struct SOUNDCLIP
     int directionalVolModifier;
     bool repeat;
     void *sourceClip;
+    // number of seeks sent to the audio thread and not done yet
+    std::atomic<int> pendingSeeks;
 
     virtual void poll() = 0;
     virtual void destroy() = 0;
@@ -71,7 +75,11 @@ struct SOUNDCLIP
     virtual void pause();
     virtual void resume();
 
-    inline bool is_playing() const { return state_ == SoundClipPlaying || state_ == SoundClipPaused; }
+    inline bool is_playing() const
+    {
+        AGS::Engine::MutexLock _lock(_mutex);
+        return state_ == SoundClipPlaying || state_ == SoundClipPaused;
+    }
 
     inline int get_speed() const
     {
@@ -146,6 +154,11 @@ struct SOUNDCLIP
 
 protected:
 
+    // guards the playback state, as the clip is polled by the audio thread
+    // while the game keeps controlling it; the mutex is recursive, so the
+    // clip methods may call each other
+    mutable AGS::Engine::Mutex _mutex;
+
     SoundClipState state_;
 
     // mute mode overrides the volume; if set, any volume assigned is stored
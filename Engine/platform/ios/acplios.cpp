@@ -58,7 +58,6 @@ extern int psp_gfx_smoothing;
 unsigned int psp_audio_samplerate = 44100;
 int psp_audio_enabled = 1;
 volatile int psp_audio_multithreaded = 1;
-int psp_audio_cachesize = 10;
 int psp_midi_enabled = 1;
 int psp_midi_preload_patches = 0;
 
@@ -93,7 +92,6 @@ const int CONFIG_CLEAR_CACHE = 1;
 const int CONFIG_AUDIO_RATE = 2;
 const int CONFIG_AUDIO_ENABLED = 3;
 const int CONFIG_AUDIO_THREADED = 4;
-const int CONFIG_AUDIO_CACHESIZE = 5;
 const int CONFIG_MIDI_ENABLED = 6;
 const int CONFIG_MIDI_PRELOAD = 7;
 const int CONFIG_VIDEO_FRAMEDROP = 8;
@@ -158,7 +156,6 @@ bool writeConfigFile()
     fprintf(config, "samplerate = %d\n", psp_audio_samplerate );
     fprintf(config, "enabled = %d\n", psp_audio_enabled);
     fprintf(config, "threaded = %d\n", psp_audio_multithreaded);
-    fprintf(config, "cache_size = %d\n", psp_audio_cachesize);
     
     fprintf(config, "[midi]\n");
     fprintf(config, "enabled = %d\n", psp_midi_enabled);
@@ -206,9 +203,6 @@ int readIntConfigValue(int id)
     case CONFIG_AUDIO_THREADED:
       return psp_audio_multithreaded;
       break;
-    case CONFIG_AUDIO_CACHESIZE:
-      return psp_audio_cachesize;
-      break;
     case CONFIG_MIDI_ENABLED:
       return psp_midi_enabled;
       break;
@@ -288,9 +282,6 @@ void setIntConfigValue(int id, int value)
     case CONFIG_AUDIO_THREADED:
       psp_audio_multithreaded = value;
       break;
-    case CONFIG_AUDIO_CACHESIZE:
-      psp_audio_cachesize = value;
-      break;
     case CONFIG_MIDI_ENABLED:
       psp_midi_enabled = value;
       break;
@@ -504,7 +495,6 @@ bool ReadConfiguration(char* filename, bool read_everything)
     ReadInteger((int*)&psp_audio_samplerate, cfg, "sound", "samplerate", 0, 44100, 44100);
     ReadInteger((int*)&psp_audio_enabled, cfg, "sound", "enabled", 0, 1, 1);
     ReadInteger((int*)&psp_audio_multithreaded, cfg, "sound", "threaded", 0, 1, 1);
-    ReadInteger((int*)&psp_audio_cachesize, cfg, "sound", "cache_size", 1, 50, 10);
 
     ReadInteger((int*)&psp_midi_enabled, cfg, "midi", "enabled", 0, 1, 1);
     ReadInteger((int*)&psp_midi_preload_patches, cfg, "midi", "preload_patches", 0, 1, 0);
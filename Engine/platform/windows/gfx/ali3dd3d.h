@@ -194,6 +194,7 @@ public:
     void Render(int xoff, int yoff, GlobalFlipType flip) override;
     bool GetCopyOfScreenIntoBitmap(Bitmap *destination, bool at_native_res, GraphicResolution *want_fmt) override;
     void EnableVsyncBeforeRender(bool enabled) override { }
+    void EnablePipelinedPresent(bool enabled) override { }
     void Vsync() override;
     void RenderSpritesAtScreenResolution(bool enabled, int supersampling) override { _renderSprAtScreenRes = enabled; };
     void FadeOut(int speed, int targetColourRed, int targetColourGreen, int targetColourBlue) override;
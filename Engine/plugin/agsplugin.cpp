@@ -29,6 +29,7 @@
 #include "ac/global_audio.h"
 #include "ac/global_plugin.h"
 #include "ac/global_walkablearea.h"
+#include "ac/walkablearea.h"
 #include "ac/keycode.h"
 #include "ac/mouse.h"
 #include "ac/movelist.h"
@@ -36,6 +37,7 @@
 #include "ac/parser.h"
 #include "ac/path_helper.h"
 #include "ac/roomstatus.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
 #include "ac/dynobj/cc_dynamicobject_addr_and_manager.h"
 #include "ac/dynobj/scriptobject.h"
@@ -491,7 +493,11 @@ BITMAP *IAGSEngine::GetSpriteGraphic (int32 num) {
 }
 BITMAP *IAGSEngine::GetRoomMask (int32 index) {
     if (index == MASK_WALKABLE)
+    {
+        // plugin may draw on the mask
+        invalidate_walkable_areas_temp();
         return (BITMAP*)thisroom.WalkAreaMask->GetAllegroBitmap();
+    }
     else if (index == MASK_WALKBEHIND)
         return (BITMAP*)thisroom.WalkBehindMask->GetAllegroBitmap();
     else if (index == MASK_HOTSPOT)
@@ -695,6 +701,7 @@ int IAGSEngine::CallGameScriptFunction(const char *name, int32 globalScript, int
 
 void IAGSEngine::NotifySpriteUpdated(int32 slot) {
     int ff;
+    invalidate_transformed_sprite(slot);
     // wipe the character cache when we change rooms
     for (ff = 0; ff < game.numcharacters; ff++) {
         if ((charcache[ff].inUse) && (charcache[ff].sppic == slot)) {
@@ -57,7 +57,8 @@ enum ScriptOpArgIsReg
     kScOpArg3IsReg      = 0x0004,
     kScOpOneArgIsReg    = kScOpArg1IsReg,
     kScOpTwoArgsAreReg  = kScOpArg1IsReg | kScOpArg2IsReg,
-    kScOpTreeArgsAreReg = kScOpArg1IsReg | kScOpArg2IsReg | kScOpArg3IsReg
+    kScOpTreeArgsAreReg = kScOpArg1IsReg | kScOpArg2IsReg | kScOpArg3IsReg,
+    kScOpArgs1And3AreReg = kScOpArg1IsReg | kScOpArg3IsReg
 };
 
 struct ScriptCommandInfo
@@ -154,6 +155,9 @@ const ScriptCommandInfo sccmd_info[CC_NUM_SCCMDS] =
     ScriptCommandInfo( SCMD_DYNAMICBOUNDS   , "dynamicbounds"     , 1, kScOpOneArgIsReg ),
     ScriptCommandInfo( SCMD_NEWARRAY        , "newarray"          , 3, kScOpOneArgIsReg ),
     ScriptCommandInfo( SCMD_NEWUSEROBJECT   , "newuserobject"     , 2, kScOpOneArgIsReg ),
+    ScriptCommandInfo( SCMD_LITADDREG       , "movl.add"          , 3, kScOpArgs1And3AreReg ),
+    ScriptCommandInfo( SCMD_MEMREADSPOFFS   , "memread4.sp.offs"  , 2, kScOpArg2IsReg ),
+    ScriptCommandInfo( SCMD_MEMWRITESPOFFS  , "memwrite4.sp.offs" , 2, kScOpArg2IsReg ),
 };
 
 const char *regnames[] = { "null", "sp", "mar", "ax", "bx", "cx", "op", "dx" };
@@ -241,6 +245,9 @@ ccInstance::ccInstance()
     numimports = 0;
     resolved_imports = nullptr;
     code_fixups         = nullptr;
+    prepared_ops        = nullptr;
+    prepared_opmap      = nullptr;
+    num_prepared_ops    = 0;
 
     memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
     memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -447,100 +454,39 @@ int ccInstance::Run(int32_t curpc)
 
     while (1) {
 
-        /*
-		if (!codeInst->ReadOperation(codeOp, pc))
+        // Take the pre-decoded operation if there's one for this position,
+        // otherwise read it from the code stream now
+        const ScriptOperation *op;
+        const int32_t op_index = (codeInst->prepared_opmap && pc >= 0 && pc < codeInst->codesize) ?
+            codeInst->prepared_opmap[pc] : -1;
+        if (op_index >= 0)
         {
-            return -1;
-        }
-        */
-        /* ReadOperation */
-        //=====================================================================
-        codeOp.Instruction.Code			= codeInst->code[pc];
-        codeOp.Instruction.InstanceId	= (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-        codeOp.Instruction.Code		   &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-        if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS)
-        {
-            cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-            return -1;
-        }
-
-        codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
-        if (pc + codeOp.ArgCount >= codeInst->codesize)
-        {
-            cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-            return -1;
-        }
-
-        int pc_at = pc + 1;
-        for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at)
-        {
-            char fixup = codeInst->code_fixups[pc_at];
-            if (fixup > 0)
+            const ScriptPreparedOp &prep_op = codeInst->prepared_ops[op_index];
+            if (prep_op.HasLateFixups)
             {
-                // could be relative pointer or import address
-                /*
-                if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-                {
-                    return -1;
-                }
-                */
-                /* FixupArgument */
-                //=====================================================================
-                switch (fixup)
-                {
-                case FIXUP_GLOBALDATA:
-                    {
-                        ScriptVariable *gl_var = (ScriptVariable*)codeInst->code[pc_at];
-                        codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
-                    }
-                    break;
-                case FIXUP_FUNCTION:
-                    // originally commented -- CHECKME: could this be used in very old versions of AGS?
-                    //      code[fixup] += (long)&code[0];
-                    // This is a program counter value, presumably will be used as SCMD_CALL argument
-                    codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
-                    break;
-                case FIXUP_STRING:
-                    codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
-                    break;
-                case FIXUP_IMPORT:
-                    {
-                        const ScriptImport *import = simp.getByIndex((int32_t)codeInst->code[pc_at]);
-                        if (import)
-                        {
-                            codeOp.Args[i] = import->Value;
-                        }
-                        else
-                        {
-                            cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
-                            return -1;
-                        }
-                    }
-                    break;
-                case FIXUP_STACK:
-                    codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-                    break;
-                default:
-                    cc_error("internal fixup type error: %d", fixup);
+                codeOp = prep_op.Op;
+                if (!FixupLateArguments(codeOp, prep_op.LateFixups))
                     return -1;
-                }
-                /* End FixupArgument */
-                //=====================================================================
+                op = &codeOp;
             }
             else
             {
-                // should be a numeric literal (int32 or float)
-                codeOp.Args[i].SetInt32( (int32_t)codeInst->code[pc_at] );
+                op = &prep_op.Op;
             }
         }
-        /* End ReadOperation */
-        //=====================================================================
+        else
+        {
+            char late_fixups[MAX_SCMD_ARGS];
+            if (!codeInst->ReadOperation(codeOp, pc, late_fixups) ||
+                !FixupLateArguments(codeOp, late_fixups))
+                return -1;
+            op = &codeOp;
+        }
 
         // save the arguments for quick access
-        RuntimeScriptValue &arg1 = codeOp.Args[0];
-        RuntimeScriptValue &arg2 = codeOp.Args[1];
-        RuntimeScriptValue &arg3 = codeOp.Args[2];
+        const RuntimeScriptValue &arg1 = op->Args[0];
+        const RuntimeScriptValue &arg2 = op->Args[1];
+        const RuntimeScriptValue &arg3 = op->Args[2];
         RuntimeScriptValue &reg1 = 
             registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
         RuntimeScriptValue &reg2 = 
@@ -551,10 +497,10 @@ int ccInstance::Run(int32_t curpc)
 
         if (write_debug_dump)
         {
-            DumpInstruction(codeOp);
+            DumpInstruction(*op);
         }
 
-        switch (codeOp.Instruction.Code) {
+        switch (op->Instruction.Code) {
       case SCMD_LINENUM:
           line_number = arg1.IValue;
           currentline = arg1.IValue;
@@ -751,7 +697,7 @@ int ccInstance::Run(int32_t curpc)
           PUSH_CALL_STACK;
 
           ASSERT_STACK_SPACE_AVAILABLE(1);
-          PushValueToStack(RuntimeScriptValue().SetInt32(pc + codeOp.ArgCount + 1));
+          PushValueToStack(RuntimeScriptValue().SetInt32(pc + op->ArgCount + 1));
           if (ccError)
           {
               return -1;
@@ -1014,7 +960,7 @@ int ccInstance::Run(int32_t curpc)
           ccInstance *wasRunning = runningInst;
 
           // extract the instance ID
-          int32_t instId = codeOp.Instruction.InstanceId;
+          int32_t instId = op->Instruction.InstanceId;
           // determine the offset into the code of the instance we want
           runningInst = loadedInstances[instId];
           intptr_t callAddr = reg1.Ptr - (char*)&runningInst->code[0];
@@ -1296,15 +1242,42 @@ int ccInstance::Run(int32_t curpc)
           if (loopIterationCheckDisabled == 0)
               loopIterationCheckDisabled++;
           break;
+      case SCMD_LITADDREG:
+          {
+          // Fused LITTOREG and ADDREG
+          RuntimeScriptValue &reg3 =
+              registers[arg3.IValue >= 0 && arg3.IValue < CC_NUM_REGISTERS ? arg3.IValue : 0];
+          reg1 = arg2;
+          reg3.IValue += reg1.IValue;
+          break;
+          }
+      case SCMD_MEMREADSPOFFS:
+          // Fused LOADSPOFFS and MEMREAD
+          registers[SREG_MAR] = GetStackPtrOffsetRw(arg1.IValue);
+          if (ccError)
+          {
+              return -1;
+          }
+          reg2 = registers[SREG_MAR].ReadValue();
+          break;
+      case SCMD_MEMWRITESPOFFS:
+          // Fused LOADSPOFFS and MEMWRITE
+          registers[SREG_MAR] = GetStackPtrOffsetRw(arg1.IValue);
+          if (ccError)
+          {
+              return -1;
+          }
+          registers[SREG_MAR].WriteValue(reg2);
+          break;
       default:
-          cc_error("instruction %d is not implemented", codeOp.Instruction.Code);
+          cc_error("instruction %d is not implemented", op->Instruction.Code);
           return -1;
         }
 
         if (flags & INSTF_ABORTED)
             return 0;
 
-        pc += codeOp.ArgCount + 1;
+        pc += op->ArgCount + 1;
     }
 }
 
@@ -1468,6 +1441,9 @@ bool ccInstance::_Create(PScript scri, ccInstance * joined)
     {
         resolved_imports = joined->resolved_imports;
         code_fixups = joined->code_fixups;
+        prepared_ops = joined->prepared_ops;
+        prepared_opmap = joined->prepared_opmap;
+        num_prepared_ops = joined->num_prepared_ops;
     }
     else
     {
@@ -1483,6 +1459,10 @@ bool ccInstance::_Create(PScript scri, ccInstance * joined)
         {
             return false;
         }
+        if (!PrepareOperations())
+        {
+            return false;
+        }
     }
 
     exports = new RuntimeScriptValue[scri->numexports];
@@ -1569,9 +1549,14 @@ void ccInstance::Free()
     {
         delete [] resolved_imports;
         delete [] code_fixups;
+        delete [] prepared_ops;
+        delete [] prepared_opmap;
     }
     resolved_imports = nullptr;
     code_fixups = nullptr;
+    prepared_ops = nullptr;
+    prepared_opmap = nullptr;
+    num_prepared_ops = 0;
 }
 
 bool ccInstance::ResolveScriptImports(PScript scri)
@@ -1763,26 +1748,86 @@ bool ccInstance::CreateRuntimeCodeFixups(PScript scri)
     return true;
 }
 
-/*
-bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
+bool ccInstance::PrepareOperations()
+{
+    prepared_opmap = new int32_t[codesize];
+    for (int32_t i = 0; i < codesize; ++i)
+        prepared_opmap[i] = -1;
+
+    // First count the operations, to allocate exact amount of memory
+    num_prepared_ops = 0;
+    int32_t at_pc = 0;
+    while (at_pc < codesize)
+    {
+        const int32_t op_code = code[at_pc] & INSTANCE_ID_REMOVEMASK;
+        if (op_code < 0 || op_code >= CC_NUM_SCCMDS)
+            break;
+        at_pc += sccmd_info[op_code].ArgCount + 1;
+        num_prepared_ops++;
+    }
+    prepared_ops = new ScriptPreparedOp[num_prepared_ops];
+
+    int32_t op_index = 0;
+    for (at_pc = 0; op_index < num_prepared_ops; ++op_index)
+    {
+        ScriptPreparedOp &prep_op = prepared_ops[op_index];
+        if (!ReadOperation(prep_op.Op, at_pc, prep_op.LateFixups))
+            break;
+        for (int i = 0; i < prep_op.Op.ArgCount; ++i)
+            prep_op.HasLateFixups |= prep_op.LateFixups[i] != 0;
+        prepared_opmap[at_pc] = op_index;
+        at_pc += prep_op.Op.ArgCount + 1;
+    }
+
+    if (at_pc < codesize)
+    {
+        // Could not decode whole code stream in one pass; the operations
+        // which were read may still be used, the rest will be decoded at runtime
+        Debug::Printf(kDbgMsg_Warn, "WARNING: script code could not be fully pre-decoded, stopped at %d (code size: %d)",
+            at_pc, codesize);
+        ccError = 0;
+    }
+    return true;
+}
+
+bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc, char *late_fixups) const
 {
-	op.Instruction.Code			= code[at_pc];
-	op.Instruction.InstanceId	= (op.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-	op.Instruction.Code		   &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+    if (at_pc < 0 || at_pc >= codesize)
+    {
+        cc_error("invalid code position %d (code size: %d)", at_pc, codesize);
+        return false;
+    }
 
-    int want_args = sccmd_info[op.Instruction.Code].ArgCount;
-    if (at_pc + want_args >= codesize)
+    op.Instruction.Code         = code[at_pc];
+    op.Instruction.InstanceId   = (op.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+    op.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+    if (op.Instruction.Code < 0 || op.Instruction.Code >= CC_NUM_SCCMDS)
     {
-        cc_error("unexpected end of code data at %d", at_pc + want_args);
+        cc_error("invalid instruction %d found in code stream", op.Instruction.Code);
+        return false;
+    }
+
+    op.ArgCount = sccmd_info[op.Instruction.Code].ArgCount;
+    if (at_pc + op.ArgCount >= codesize)
+    {
+        cc_error("unexpected end of code data (%d; %d)", at_pc + op.ArgCount, codesize);
         return false;
     }
-    op.ArgCount = want_args;
 
     at_pc++;
+    for (int i = 0; i < MAX_SCMD_ARGS; ++i)
+        late_fixups[i] = 0;
     for (int i = 0; i < op.ArgCount; ++i, ++at_pc)
     {
         char fixup = code_fixups[at_pc];
-        if (fixup > 0)
+        if (fixup == FIXUP_STACK || fixup == FIXUP_IMPORT)
+        {
+            // these are resolved at runtime, keep the raw value meanwhile
+            late_fixups[i] = fixup;
+            op.Args[i].SetInt32( (int32_t)code[at_pc] );
+        }
+        else if (fixup > 0)
         {
             // could be relative pointer or import address
             if (!FixupArgument(code[at_pc], fixup, op.Args[i]))
@@ -1799,9 +1844,8 @@ bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 
     return true;
 }
-*/
-/*
-bool ccInstance::FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument)
+
+bool ccInstance::FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument) const
 {
     switch (fixup_type)
     {
@@ -1820,30 +1864,46 @@ bool ccInstance::FixupArgument(intptr_t code_value, char fixup_type, RuntimeScri
     case FIXUP_STRING:
         argument.SetStringLiteral(&strings[0] + code_value);
         break;
-    case FIXUP_IMPORT:
+    default:
+        cc_error("internal fixup type error: %d", fixup_type);
+        return false;
+    }
+    return true;
+}
+
+bool ccInstance::FixupLateArguments(ScriptOperation &op, const char *late_fixups)
+{
+    for (int i = 0; i < op.ArgCount; ++i)
+    {
+        switch (late_fixups[i])
         {
-            const ScriptImport *import = simp.getByIndex((int32_t)code_value);
-            if (import)
-            {
-                argument = import->Value;
-            }
-            else
+        case 0:
+            break;
+        case FIXUP_IMPORT:
             {
-                cc_error("cannot resolve import, key = %ld", code_value);
-                return false;
+                const ScriptImport *import = simp.getByIndex(op.Args[i].IValue);
+                if (import)
+                {
+                    op.Args[i] = import->Value;
+                }
+                else
+                {
+                    cc_error("cannot resolve import, key = %d", op.Args[i].IValue);
+                    return false;
+                }
             }
+            break;
+        case FIXUP_STACK:
+            op.Args[i] = GetStackPtrOffsetFw(op.Args[i].IValue);
+            break;
+        default:
+            cc_error("internal fixup type error: %d", late_fixups[i]);
+            return false;
         }
-        break;
-    case FIXUP_STACK:
-        argument = GetStackPtrOffsetFw((int32_t)code_value);
-        break;
-    default:
-        cc_error("internal fixup type error: %d", fixup_type);
-        return false;;
     }
     return true;
 }
-*/
+
 //-----------------------------------------------------------------------------
 
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval)
@@ -71,6 +71,25 @@ struct ScriptOperation
 	int				    ArgCount;
 };
 
+// Script operation decoded in advance, with its arguments resolved as far
+// as that is possible before the script is run
+struct ScriptPreparedOp
+{
+    ScriptPreparedOp()
+    {
+        for (int i = 0; i < MAX_SCMD_ARGS; ++i)
+            LateFixups[i] = 0;
+        HasLateFixups = false;
+    }
+
+    ScriptOperation     Op;
+    // Fixup types of the arguments that depend on the execution state
+    // (stack offsets and imports) and may only be resolved at runtime;
+    // such arguments keep the raw code value until then
+    char                LateFixups[MAX_SCMD_ARGS];
+    bool                HasLateFixups;
+};
+
 struct ScriptVariable
 {
     ScriptVariable()
@@ -149,6 +168,12 @@ public:
 
     char *code_fixups;
 
+    // Pre-decoded operations, and the table which maps code positions to
+    // their indexes; positions that do not start an operation are set to -1
+    ScriptPreparedOp *prepared_ops;
+    int32_t *prepared_opmap;
+    int32_t num_prepared_ops;
+
     // returns the currently executing instance, or NULL if none
     static ccInstance *GetCurrentInstance(void);
     // create a runnable instance of the supplied script
@@ -190,10 +215,17 @@ protected:
     bool    AddGlobalVar(const ScriptVariable &glvar);
     ScriptVariable *FindGlobalVar(int32_t var_addr);
     bool    CreateRuntimeCodeFixups(PScript scri);
-	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
+    // Decodes every operation in the code in advance, so that the interpreter
+    // does not have to do this each time it is run
+    bool    PrepareOperations();
+    // Reads operation at the given code position; arguments which cannot be
+    // resolved before the script is run are recorded in late_fixups array
+    bool    ReadOperation(ScriptOperation &op, int32_t at_pc, char *late_fixups) const;
 
     // Runtime fixups
-    //bool    FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument);
+    bool    FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument) const;
+    // Resolves arguments which depend on the current execution state
+    bool    FixupLateArguments(ScriptOperation &op, const char *late_fixups);
 
     // Stack processing
     // Push writes new value and increments stack ptr;
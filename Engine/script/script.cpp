@@ -536,6 +536,13 @@ void post_script_cleanup() {
     case ePSASaveGameDialog:
         save_game_dialog();
         break;
+    case ePSASaveState:
+        save_game_state();
+        break;
+    case ePSARestoreState:
+        cancel_all_scripts();
+        try_restore_game_state(thisData);
+        return;
     default:
         quitprintf("undefined post script action found: %d", copyof.postScriptActions[ii]);
         }
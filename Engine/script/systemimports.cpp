@@ -26,7 +26,9 @@ int SystemImports::add(const String &name, const RuntimeScriptValue &value, ccIn
 {
     int ixof;
 
-    if ((ixof = get_index_of(name)) >= 0) {
+    IndexMap::const_iterator it = index.find(name);
+    if (it != index.end()) {
+        ixof = it->second;
         // Only allow override if not a script-exported function
         if (anotherscr == nullptr) {
             imports[ixof].Value = value;
@@ -45,7 +47,9 @@ int SystemImports::add(const String &name, const RuntimeScriptValue &value, ccIn
         }
     }
 
-    btree[name] = ixof;
+    index[name] = ixof;
+    if (name.FindChar('$') != -1)
+        partial_index[name] = ixof;
     if (ixof == imports.size())
         imports.push_back(ScriptImport());
     imports[ixof].Name          = name; // TODO: rather make a string copy here for safety reasons
@@ -54,14 +58,20 @@ int SystemImports::add(const String &name, const RuntimeScriptValue &value, ccIn
     return 0;
 }
 
+void SystemImports::remove_at(int idx)
+{
+    index.erase(imports[idx].Name);
+    partial_index.erase(imports[idx].Name);
+    imports[idx].Name = nullptr;
+    imports[idx].Value.Invalidate();
+    imports[idx].InstancePtr = nullptr;
+}
+
 void SystemImports::remove(const String &name) {
     int idx = get_index_of(name);
     if (idx < 0)
         return;
-    btree.erase(imports[idx].Name);
-    imports[idx].Name = nullptr;
-    imports[idx].Value.Invalidate();
-    imports[idx].InstancePtr = nullptr;
+    remove_at(idx);
 }
 
 const ScriptImport *SystemImports::getByName(const String &name)
@@ -83,16 +93,19 @@ const ScriptImport *SystemImports::getByIndex(int index)
 
 int SystemImports::get_index_of(const String &name)
 {
-    IndexMap::const_iterator it = btree.find(name);
-    if (it != btree.end())
+    IndexMap::const_iterator it = index.find(name);
+    if (it != index.end())
         return it->second;
 
-    // CHECKME: what are "mangled names" and where do they come from?
-    String mangled_name = String::FromFormat("%s$", name.GetCStr());
-    // if it's a function with a mangled name, allow it
-    it = btree.lower_bound(mangled_name);
-    if (it != btree.end() && it->first.CompareLeft(mangled_name) == 0)
-        return it->second;
+    if (!partial_index.empty())
+    {
+        // CHECKME: what are "mangled names" and where do they come from?
+        String mangled_name = String::FromFormat("%s$", name.GetCStr());
+        // if it's a function with a mangled name, allow it
+        PartialIndexMap::const_iterator pit = partial_index.lower_bound(mangled_name);
+        if (pit != partial_index.end() && pit->first.CompareLeft(mangled_name) == 0)
+            return pit->second;
+    }
 
     if (name.GetLength() > 3)
     {
@@ -120,17 +133,13 @@ void SystemImports::RemoveScriptExports(ccInstance *inst)
             continue;
 
         if (imports[i].InstancePtr == inst)
-        {
-            btree.erase(imports[i].Name);
-            imports[i].Name = nullptr;
-            imports[i].Value.Invalidate();
-            imports[i].InstancePtr = nullptr;
-        }
+            remove_at(i);
     }
 }
 
 void SystemImports::clear()
 {
-    btree.clear();
+    index.clear();
+    partial_index.clear();
     imports.clear();
 }
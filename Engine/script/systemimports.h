@@ -16,7 +16,10 @@
 #define __CC_SYSTEMIMPORTS_H
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "script/cc_instance.h"    // ccInstance
+#include "util/string_types.h"
 
 struct ICCDynamicObject;
 struct ICCStaticObject;
@@ -38,12 +41,17 @@ struct ScriptImport
 struct SystemImports
 {
 private:
-    // Note we can't use a hash-map here, because we sometimes need to search
-    // by partial keys.
-    typedef std::map<String, int> IndexMap;
+    // Exact names are looked up in a hash map; the names with a '$' are
+    // also kept in a sorted map, because they are sometimes searched by
+    // partial keys (name without the mangled suffix).
+    typedef std::unordered_map<String, int> IndexMap;
+    typedef std::map<String, int> PartialIndexMap;
 
     std::vector<ScriptImport> imports;
-    IndexMap btree;
+    IndexMap index;
+    PartialIndexMap partial_index;
+
+    void remove_at(int idx);
 
 public:
     int  add(const String &name, const RuntimeScriptValue &value, ccInstance *inst);
@@ -27,8 +27,12 @@ void Test_DoAllTests()
     Test_Version();
     Test_File();
     Test_IniFile();
+    Test_SaveState();
+    Test_Route();
 
+    Test_Fonts();
     Test_Gfx();
+    Test_SpriteFile();
 }
 
 #endif // AGS_RUN_TESTS
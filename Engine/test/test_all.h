@@ -22,9 +22,15 @@ void Test_Math();
 void Test_File();
 void Test_IniFile();
 // Graphics tests
+void Test_Fonts();
 void Test_Gfx();
+void Test_SpriteFile();
 // Memory / bit-byte operations
 void Test_Memory();
+// Game state tests
+void Test_SaveState();
+// Pathfinding tests
+void Test_Route();
 // String tests
 void Test_ScriptSprintf();
 void Test_String();
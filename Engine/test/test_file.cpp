@@ -19,6 +19,7 @@
 #include "debug/assert.h"
 #include "util/alignedstream.h"
 #include "util/file.h"
+#include "util/memorystream.h"
 
 using namespace AGS::Common;
 
@@ -188,6 +189,30 @@ void Test_File()
     assert(int32val == 20);
 
     assert(!File::TestReadFile("test.tmp"));
+
+    //-----------------------------------------------------
+    // Memory stream
+    MemoryStream mem_out;
+    mem_out.WriteInt32(0);
+    String::WriteString("test", &mem_out);
+    mem_out.WriteInt64(-20202);
+    soff_t mem_end = mem_out.GetPosition();
+    mem_out.Seek(0, kSeekBegin);
+    mem_out.WriteInt32(40);
+    mem_out.Seek(mem_end, kSeekBegin);
+    std::vector<uint8_t> mem_buf;
+    mem_out.ReleaseBuffer(mem_buf);
+    assert(mem_out.GetLength() == 0);
+    assert(mem_buf.size() == (size_t)mem_end);
+
+    MemoryStream mem_in(std::move(mem_buf), kFile_Read);
+    assert(!mem_in.CanWrite());
+    assert(mem_in.ReadInt32() == 40);
+    assert(strcmp(String::FromStream(&mem_in), "test") == 0);
+    assert(mem_in.ReadInt64() == -20202);
+    assert(mem_in.EOS());
+    assert(mem_in.ReadByte() == -1);
+    assert(!mem_in.Seek(1, kSeekEnd));
 }
 
 #endif // AGS_RUN_TESTS
@@ -0,0 +1,215 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "core/platform.h"
+#ifdef AGS_RUN_TESTS
+
+#include <stdint.h>
+#include <string.h>
+#include "ac/display.h"
+#include "ac/gamestructdefines.h"
+#include "debug/assert.h"
+#include "font/agsfontrenderer.h"
+#include "font/fonts.h"
+#include "font/textruncache.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+// defined in fonts.cpp
+void unescape_script_string(const char *cstr, std::vector<char> &out);
+
+// Font which measures text like a bitmap font: by adding up the character
+// widths; the characters above 'z' are reported as having no known advance
+// and have to be measured by the renderer
+class TestFontRenderer : public IAGSFontRenderer, public IAGSFontRenderer2
+{
+public:
+    static int CharWidth(uint8_t c) { return c == ' ' ? 3 : 4 + c % 5; }
+    static bool HasAdvance(uint8_t c) { return c <= 'z'; }
+
+    bool LoadFromDisk(int fontNumber, int fontSize) override { return true; }
+    void FreeMemory(int fontNumber) override {}
+    bool SupportsExtendedCharacters(int fontNumber) override { return true; }
+    int GetTextWidth(const char *text, int fontNumber) override
+    {
+        int width = 0;
+        for (; *text; ++text)
+            width += CharWidth(*text);
+        return width;
+    }
+    int GetTextHeight(const char *text, int fontNumber) override { return 10; }
+    void RenderText(const char *text, int fontNumber, BITMAP *destination, int x, int y, int colour) override {}
+    void AdjustYCoordinateForFont(int *ycoord, int fontNumber) override {}
+    void EnsureTextValidForFont(char *text, int fontNumber) override {}
+
+    bool IsBitmapFont() override { return true; }
+    bool LoadFromDiskEx(int fontNumber, int fontSize, const FontRenderParams *params) override { return true; }
+    bool GetCharAdvances(int fontNumber, int advances[256]) override
+    {
+        for (int c = 0; c < 256; ++c)
+            advances[c] = HasAdvance(c) ? CharWidth(c) : -1;
+        return true;
+    }
+    bool IsTextRenderOpaque(int fontNumber, int colorDepth) override { return true; }
+};
+
+// The line splitting which measures the whole line for every new character
+static size_t SplitLinesByPrefixes(const char *text, SplitLines &lines, int width, int font)
+{
+    width -= 1;
+    lines.Reset();
+    unescape_script_string(text, lines.LineBuf);
+    char *theline = &lines.LineBuf.front();
+    size_t i = 0;
+    while (theline[i] != 0)
+    {
+        size_t split_at = -1;
+        const char next_char = theline[i + 1];
+        theline[i + 1] = 0;
+        if (theline[i] == '\n')
+            split_at = i;
+        else if (wgettextwidth_compensate(theline, font) > width)
+        {
+            int endline = i;
+            while ((theline[endline] != ' ') && (endline > 0))
+                endline--;
+            split_at = endline == 0 ? i - 1 : endline;
+        }
+        theline[i + 1] = next_char;
+
+        if (split_at != -1)
+        {
+            if (split_at == 0 && !((theline[0] == ' ') || (theline[0] == '\n')))
+            {
+                lines.Reset();
+                return 0;
+            }
+            const char split_char = theline[split_at];
+            theline[split_at] = 0;
+            lines.Add(theline);
+            theline[split_at] = split_char;
+            theline += split_at;
+            if ((theline[0] == ' ') || (theline[0] == '\n'))
+                theline++;
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+    if (i > 0)
+        lines.Add(theline);
+    return lines.Count();
+}
+
+// Tests that the lines are split at the same places as when measuring every
+// line prefix in whole, both for the characters with the known advances and
+// for the ones measured by the renderer
+static void Test_SplitLines(int font)
+{
+    const char *texts[] = {
+        "",
+        "Hello",
+        "The quick brown fox jumps over the lazy dog",
+        "A verylongwordwhichdoesnotfitontheline at all",
+        "First line[Second line\\[with bracket] and the rest of it",
+        "Accented \xE9\xE8\xEA and \xFC\xF6\xE4 characters, {braces} and ~tildes~ mixed in",
+        "\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9",
+        "  leading and  double  spaces ",
+        "[[empty lines[",
+    };
+    SplitLines lines, expect_lines;
+    for (const char *text : texts)
+    {
+        for (int width = 1; width <= 160; ++width)
+        {
+            const size_t count = split_lines(text, lines, width, font);
+            const size_t expect_count = SplitLinesByPrefixes(text, expect_lines, width, font);
+            assert(count == expect_count);
+            for (size_t i = 0; i < count; ++i)
+                assert(lines[i] == expect_lines[i]);
+        }
+    }
+}
+
+// Tests that the text images are found only by the same text, font, color
+// and color depth, and that the least recently used ones are removed first
+static void Test_TextRunCache()
+{
+    TextRunCache cache(1000);
+    const TextRunKey key("Hello", 1, 15, 8);
+    assert(cache.Get(key) == nullptr);
+    Bitmap *image = new Bitmap();
+    assert(cache.Put(key, std::unique_ptr<Bitmap>(image), 300));
+    assert(cache.Get(key) == image);
+    assert(cache.Get(TextRunKey("Hello", 1, 15, 8)) == image);
+    assert(cache.Get(TextRunKey("Hello!", 1, 15, 8)) == nullptr);
+    assert(cache.Get(TextRunKey("hello", 1, 15, 8)) == nullptr);
+    assert(cache.Get(TextRunKey("Hello", 2, 15, 8)) == nullptr);
+    assert(cache.Get(TextRunKey("Hello", 1, 14, 8)) == nullptr);
+    assert(cache.Get(TextRunKey("Hello", 1, 15, 32)) == nullptr);
+
+    // the image of the same text is replaced
+    image = new Bitmap();
+    assert(cache.Put(key, std::unique_ptr<Bitmap>(image), 400));
+    assert(cache.Get(key) == image);
+    assert(cache.GetCount() == 1 && cache.GetSize() == 400);
+
+    // the least recently used images are removed to make room
+    const TextRunKey key_a("A", 1, 15, 8), key_b("B", 1, 15, 8), key_c("C", 1, 15, 8);
+    assert(cache.Put(key_a, std::unique_ptr<Bitmap>(new Bitmap()), 300));
+    assert(cache.Put(key_b, std::unique_ptr<Bitmap>(new Bitmap()), 300));
+    assert(cache.GetCount() == 3 && cache.GetSize() == 1000);
+    assert(cache.Get(key) == image); // now key_a is the least recently used
+    assert(cache.Put(key_c, std::unique_ptr<Bitmap>(new Bitmap()), 300));
+    assert(cache.GetCount() == 3 && cache.GetSize() == 1000);
+    assert(cache.Get(key_a) == nullptr);
+    assert(cache.Get(key_b) && cache.Get(key_c) && cache.Get(key));
+
+    // the image larger than the cache is not put there
+    assert(!cache.Put(TextRunKey("Huge", 1, 15, 8), std::unique_ptr<Bitmap>(new Bitmap()), 1001));
+    assert(cache.GetCount() == 3 && cache.GetSize() == 1000);
+
+    // the images which do not fit the new limit are removed
+    cache.SetMaxSize(700);
+    assert(cache.GetCount() == 2 && cache.GetSize() == 700);
+    assert(cache.Get(key_b) == nullptr);
+    assert(cache.Get(key) == image);
+    cache.SetMaxSize(0);
+    assert(cache.GetCount() == 0 && cache.GetSize() == 0);
+
+    cache.SetMaxSize(1000);
+    assert(cache.Put(key, std::unique_ptr<Bitmap>(new Bitmap()), 300));
+    cache.Clear();
+    assert(cache.GetCount() == 0 && cache.GetSize() == 0);
+    assert(cache.Get(key) == nullptr);
+}
+
+void Test_Fonts()
+{
+    Test_TextRunCache();
+
+    TestFontRenderer renderer;
+    font_set_renderer(0, &renderer, &renderer);
+    Test_SplitLines(0);
+    // the outline adds to the measured width
+    FontInfo finfo;
+    finfo.Outline = FONT_OUTLINE_AUTO;
+    finfo.AutoOutlineThickness = 2;
+    set_fontinfo(0, finfo);
+    Test_SplitLines(0);
+    free_all_fonts();
+}
+
+#endif // AGS_RUN_TESTS
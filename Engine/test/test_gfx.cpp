@@ -16,13 +16,176 @@
 #ifdef AGS_RUN_TESTS
 
 #include <stdlib.h>
+#include <string.h>
+#include "gfx/blender.h"
+#include "gfx/gfx_convert.h"
 #include "gfx/gfx_def.h"
 #include "debug/assert.h"
+#include "util/wgt2allg.h"
 
 namespace GfxDef = AGS::Common::GfxDef;
+namespace GfxConvert = AGS::Engine::GfxConvert;
+
+static uint32_t Test_MakeColor(const GfxConvert::VMemFormat &fmt, int r, int g, int b, int a)
+{
+    return ((uint32_t)a << fmt.AShift) | ((uint32_t)r << fmt.RShift) |
+        ((uint32_t)g << fmt.GShift) | ((uint32_t)b << fmt.BShift);
+}
+
+// Test that the vectorized row conversions give same results as the
+// plain per-pixel conversion, including the row tails and mask pixels
+static void Test_GfxConvert(const GfxConvert::VMemFormat &fmt)
+{
+    uint32_t palette[256];
+    uint8_t src8[256 + 37];
+    uint32_t dst8[256 + 37];
+    for (int i = 0; i < 256 + 37; ++i)
+        src8[i] = (uint8_t)(i * 7);
+    GfxConvert::MakePaletteTable(fmt, true, palette);
+    assert(palette[MASK_COLOR_8] == 0);
+    GfxConvert::ConvertRow8(src8, dst8, 256 + 37, palette);
+    for (int i = 0; i < 256 + 37; ++i)
+    {
+        uint32_t expect = src8[i] == MASK_COLOR_8 ? 0 :
+            Test_MakeColor(fmt, getr8(src8[i]), getg8(src8[i]), getb8(src8[i]), 0xFF);
+        assert(dst8[i] == expect);
+    }
+    GfxConvert::MakePaletteTable(fmt, false, palette);
+    for (int i = 0; i < 256; ++i)
+        assert(palette[i] == Test_MakeColor(fmt, getr8(i), getg8(i), getb8(i), 0xFF));
+
+    const int count = 37;
+    uint16_t src16[count];
+    uint32_t src32[count];
+    uint32_t dst[count];
+    for (int i = 0; i < count; ++i)
+    {
+        src16[i] = (i % 7 == 3) ? MASK_COLOR_16 : (uint16_t)(i * 1783 + 11);
+        src32[i] = (i % 7 == 3) ? MASK_COLOR_32 : (uint32_t)(i * 0x1F3A5C71u + 0x0102);
+    }
+
+    GfxConvert::ConvertRow16(src16, dst, count, fmt, true);
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t expect = src16[i] == MASK_COLOR_16 ? 0 :
+            Test_MakeColor(fmt, getr16(src16[i]), getg16(src16[i]), getb16(src16[i]), 0xFF);
+        assert(dst[i] == expect);
+    }
+    GfxConvert::ConvertRow16(src16, dst, count, fmt, false);
+    for (int i = 0; i < count; ++i)
+        assert(dst[i] == Test_MakeColor(fmt, getr16(src16[i]), getg16(src16[i]), getb16(src16[i]), 0xFF));
+
+    GfxConvert::ConvertRow32(src32, dst, count, fmt, true, true);
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t expect = src32[i] == MASK_COLOR_32 ? 0 :
+            Test_MakeColor(fmt, getr32(src32[i]), getg32(src32[i]), getb32(src32[i]), geta32(src32[i]));
+        assert(dst[i] == expect);
+    }
+    GfxConvert::ConvertRow32(src32, dst, count, fmt, false, false);
+    for (int i = 0; i < count; ++i)
+        assert(dst[i] == Test_MakeColor(fmt, getr32(src32[i]), getg32(src32[i]), getb32(src32[i]), 0xFF));
+}
+
+static void Test_GetPixel32(const uint32_t *pixel, uint32_t *red, uint32_t *green, uint32_t *blue, uint32_t *divisor)
+{
+    if (pixel[0] != MASK_COLOR_32)
+    {
+        *red += getr32(pixel[0]);
+        *green += getg32(pixel[0]);
+        *blue += getb32(pixel[0]);
+        divisor[0]++;
+    }
+}
+
+// Test that the transparent pixels take colour of their neighbours
+static void Test_FixTransparentRow(const GfxConvert::VMemFormat &fmt)
+{
+    const int count = 5;
+    const uint32_t M = MASK_COLOR_32;
+    const uint32_t p1 = makeacol32(0x10, 0x20, 0x30, 0xFF);
+    const uint32_t p2 = makeacol32(0x40, 0x60, 0x80, 0xFF);
+    const uint32_t q = makeacol32(0x08, 0x08, 0x08, 0xFF);
+    const uint32_t row[count] = { M, p1, M, M, p2 };
+    const uint32_t above[count] = { M, M, q, M, M };
+    auto make_color = [&fmt](uint32_t r, uint32_t g, uint32_t b) { return Test_MakeColor(fmt, r, g, b, 0); };
+    uint32_t dst[count];
+
+    // transparent pixel followed by the opaque one takes its colour
+    GfxConvert::ConvertRow32(row, dst, count, fmt, false, true);
+    GfxConvert::FixTransparentRow<uint32_t, uint32_t>(row, above, nullptr, count, M, true, false,
+        Test_GetPixel32, make_color, dst);
+    assert(dst[0] == make_color(0x10, 0x20, 0x30));
+    assert(dst[2] == 0);
+    assert(dst[3] == make_color(0x40, 0x60, 0x80));
+
+    // with linear filtering other transparent pixels get the average colour
+    GfxConvert::ConvertRow32(row, dst, count, fmt, false, true);
+    GfxConvert::FixTransparentRow<uint32_t, uint32_t>(row, above, nullptr, count, M, true, true,
+        Test_GetPixel32, make_color, dst);
+    assert(dst[0] == make_color(0x10, 0x20, 0x30));
+    assert(dst[2] == make_color(0x0C, 0x14, 0x1C));
+    assert(dst[3] == make_color(0x40, 0x60, 0x80));
+
+    // without the row above and the colour of the next pixel
+    GfxConvert::ConvertRow32(row, dst, count, fmt, false, true);
+    GfxConvert::FixTransparentRow<uint32_t, uint32_t>(row, nullptr, nullptr, count, M, false, true,
+        Test_GetPixel32, make_color, dst);
+    assert(dst[0] == make_color(0x10, 0x20, 0x30));
+    assert(dst[2] == make_color(0x10, 0x20, 0x30));
+    assert(dst[3] == make_color(0x40, 0x60, 0x80));
+    assert(dst[1] == Test_MakeColor(fmt, 0x10, 0x20, 0x30, 0xFF));
+}
+
+// Test that the span blenders give same results as the per-pixel ones
+static void Test_BlendSpans()
+{
+    const int count = 37;
+    const int alphas[] = { 0, 1, 100, 128, 254, 255 };
+    uint32_t src[count], dst[count], res[count];
+    for (int i = 0; i < count; ++i)
+    {
+        src[i] = (i % 7 == 3) ? MASK_COLOR_32 : (uint32_t)(i * 0x1F3A5C71u + 0x0102);
+        dst[i] = (uint32_t)(i * 0x2C1B3D97u + 0x5A5A);
+    }
+
+    for (int alpha : alphas)
+    {
+        const int alpha_mul = alpha > 0 ? alpha + 1 : 256;
+        memcpy(res, dst, sizeof(res));
+        blend_span_argb2rgb(src, res, count, alpha_mul);
+        for (int i = 0; i < count; ++i)
+            assert(res[i] == (src[i] == MASK_COLOR_32 ? dst[i] : _argb2rgb_blender(src[i], dst[i], alpha)));
+
+        memcpy(res, dst, sizeof(res));
+        blend_span_trans(src, res, count, alpha, true);
+        for (int i = 0; i < count; ++i)
+            assert(res[i] == (src[i] == MASK_COLOR_32 ? dst[i] : _myblender_alpha_trans24(src[i], dst[i], alpha)));
+        memcpy(res, dst, sizeof(res));
+        blend_span_trans(src, res, count, alpha, false);
+        for (int i = 0; i < count; ++i)
+            assert(res[i] == (src[i] == MASK_COLOR_32 ? dst[i] : _myblender_alpha_trans24(src[i], dst[i], alpha) & 0xFFFFFF));
+
+        const uint32_t color = 0x00F80810;
+        memcpy(res, dst, sizeof(res));
+        blend_span_lit(src, res, count, color, alpha, true);
+        for (int i = 0; i < count; ++i)
+            assert(res[i] == (src[i] == MASK_COLOR_32 ? dst[i] : _myblender_alpha_trans24(color, src[i], alpha)));
+    }
+}
 
 void Test_Gfx()
 {
+    Test_BlendSpans();
+
+    // OpenGL and Direct3D texture formats
+    const GfxConvert::VMemFormat ogl_fmt = { 0, 8, 16, 24 };
+    const GfxConvert::VMemFormat d3d_fmt = { 16, 8, 0, 24 };
+    Test_GfxConvert(ogl_fmt);
+    Test_GfxConvert(d3d_fmt);
+    Test_FixTransparentRow(ogl_fmt);
+    Test_FixTransparentRow(d3d_fmt);
+
     // Test that every transparency which is a multiple of 10 is converted
     // forth and back without loosing precision
     const size_t arr_sz = 11;
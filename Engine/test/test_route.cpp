@@ -0,0 +1,119 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "core/platform.h"
+#ifdef AGS_RUN_TESTS
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include "ac/route_finder_impl.h"
+#include "debug/assert.h"
+
+using namespace AGS::Engine::RouteFinder;
+
+static const int TestMapWidth = 320;
+static const int TestMapHeight = 200;
+
+// Makes the room mask with the walls across it, each with a few passages,
+// and the scattered blocks
+static std::vector<unsigned char> MakeTestMask()
+{
+    std::vector<unsigned char> mask(TestMapWidth * TestMapHeight, 1);
+    for (int wall = 0; wall < 4; ++wall)
+    {
+        const int wx = 50 + wall * 70;
+        for (int y = 0; y < TestMapHeight; ++y)
+        {
+            if ((y + wall * 37) % 90 < 6)
+                continue; // passage
+            for (int x = wx; x < wx + 4; ++x)
+                mask[y * TestMapWidth + x] = 0;
+        }
+    }
+    uint32_t seed = 7;
+    for (int block = 0; block < 60; ++block)
+    {
+        seed = seed * 1103515245 + 12345;
+        const int bx = (seed >> 8) % (TestMapWidth - 10);
+        const int by = (seed >> 20) % (TestMapHeight - 10);
+        for (int y = by; y < by + 8; ++y)
+            for (int x = bx; x < bx + 8; ++x)
+                mask[y * TestMapWidth + x] = 0;
+    }
+    return mask;
+}
+
+static float PathLength(const std::vector<std::pair<int, int>> &path)
+{
+    float len = 0.f;
+    for (size_t i = 1; i < path.size(); ++i)
+        len += hypotf((float)(path[i].first - path[i - 1].first), (float)(path[i].second - path[i - 1].second));
+    return len;
+}
+
+// Tests that the path starts and ends at the given points, and that every
+// straight segment of it is passable
+static void Test_PathValid(const std::vector<const unsigned char *> &rows, const std::vector<std::pair<int, int>> &path,
+    int fromx, int fromy, int destx, int desty)
+{
+    assert(path.size() >= 2);
+    assert(path.front().first == fromx && path.front().second == fromy);
+    assert(path.back().first == destx && path.back().second == desty);
+    for (size_t i = 1; i < path.size(); ++i)
+        assert(can_see_on_mask(rows, TestMapWidth, path[i - 1].first, path[i - 1].second, path[i].first, path[i].second));
+}
+
+// Tests that the search over the cluster graph gives valid routes between
+// the same points as the plain JPS search, of comparable length
+void Test_Route()
+{
+    const std::vector<unsigned char> mask = MakeTestMask();
+    std::vector<const unsigned char *> rows(TestMapHeight);
+    for (int y = 0; y < TestMapHeight; ++y)
+        rows[y] = &mask[y * TestMapWidth];
+
+    std::vector<std::pair<int, int>> jps_path, hpa_path;
+    uint32_t seed = 1;
+    int tested = 0;
+    for (int attempt = 0; attempt < 60; ++attempt)
+    {
+        seed = seed * 1103515245 + 12345;
+        const int fromx = (seed >> 8) % 40;
+        const int fromy = (seed >> 16) % TestMapHeight;
+        seed = seed * 1103515245 + 12345;
+        const int destx = TestMapWidth - 1 - (seed >> 8) % 40;
+        const int desty = (seed >> 16) % TestMapHeight;
+        if (!mask[fromy * TestMapWidth + fromx] || !mask[desty * TestMapWidth + destx])
+            continue;
+
+        assert(find_path_on_mask(rows, TestMapWidth, false, fromx, fromy, destx, desty, jps_path));
+        Test_PathValid(rows, jps_path, fromx, fromy, destx, desty);
+        assert(find_path_on_mask(rows, TestMapWidth, true, fromx, fromy, destx, desty, hpa_path));
+        Test_PathValid(rows, hpa_path, fromx, fromy, destx, desty);
+        assert(PathLength(hpa_path) <= PathLength(jps_path) * 1.25f);
+        tested++;
+    }
+    assert(tested > 30);
+
+    // the room part behind the closed wall is not reachable
+    std::vector<unsigned char> closed = mask;
+    for (int y = 0; y < TestMapHeight; ++y)
+        closed[y * TestMapWidth + 300] = 0;
+    for (int y = 0; y < TestMapHeight; ++y)
+        rows[y] = &closed[y * TestMapWidth];
+    assert(!find_path_on_mask(rows, TestMapWidth, true, 10, 10, 310, 100, hpa_path));
+}
+
+#endif // AGS_RUN_TESTS
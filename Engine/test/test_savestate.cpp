@@ -0,0 +1,104 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "core/platform.h"
+#ifdef AGS_RUN_TESTS
+
+#include <algorithm>
+#include <vector>
+#include "debug/assert.h"
+#include "game/savestate.h"
+
+using namespace AGS::Engine;
+
+// Makes a state which mostly matches the other states, with a few bytes
+// depending on the state number, like the consecutive game saves do
+static std::vector<uint8_t> MakeTestState(int num, size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = (uint8_t)(i * 31 + (i >> 8));
+    for (size_t i = num; i < size; i += 97)
+        data[i] = (uint8_t)(num + 1);
+    return data;
+}
+
+static void Test_SaveStateRing(bool use_delta)
+{
+    const size_t max_count = 4;
+    // the newer states are both longer and shorter than the older ones
+    const size_t sizes[] = { 3000, 3500, 2000, 2000, 4100, 1000, 2500 };
+    const int num_states = sizeof(sizes) / sizeof(sizes[0]);
+
+    SaveStateRing ring;
+    ring.SetOptions(max_count, use_delta);
+    assert(ring.GetMaxCount() == max_count);
+    assert(ring.GetCount() == 0);
+
+    std::vector<uint8_t> data;
+    assert(!ring.Get(0, data));
+
+    std::vector<std::vector<uint8_t>> pushed;
+    for (int num = 0; num < num_states; ++num)
+    {
+        pushed.push_back(MakeTestState(num, sizes[num]));
+        std::vector<uint8_t> state = pushed.back();
+        ring.Push(std::move(state));
+        const size_t count = std::min<size_t>(num + 1, max_count);
+        assert(ring.GetCount() == count);
+        // all kept states are restored, from the newest to the oldest
+        for (size_t index = 0; index < count; ++index)
+        {
+            assert(ring.Get(index, data));
+            assert(data == pushed[num - index]);
+        }
+        // the evicted states are gone
+        assert(!ring.Get(count, data));
+    }
+
+    // restoring does not change the kept states
+    assert(ring.Get(max_count - 1, data));
+    assert(ring.Get(0, data));
+    assert(data == pushed[num_states - 1]);
+
+    // empty states are not kept
+    ring.Push(std::vector<uint8_t>());
+    assert(ring.GetCount() == max_count);
+
+    ring.Clear();
+    assert(ring.GetCount() == 0);
+    assert(!ring.Get(0, data));
+}
+
+void Test_SaveState()
+{
+    Test_SaveStateRing(false);
+    Test_SaveStateRing(true);
+
+    // the disabled ring does not keep anything
+    SaveStateRing ring;
+    ring.Push(MakeTestState(0, 100));
+    assert(ring.GetMaxCount() == 0);
+    assert(ring.GetCount() == 0);
+
+    // changing options drops the current states
+    ring.SetOptions(2, true);
+    ring.Push(MakeTestState(0, 100));
+    ring.Push(MakeTestState(1, 100));
+    assert(ring.GetCount() == 2);
+    ring.SetOptions(2, false);
+    assert(ring.GetCount() == 0);
+}
+
+#endif // AGS_RUN_TESTS
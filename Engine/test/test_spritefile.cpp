@@ -0,0 +1,325 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "core/platform.h"
+#ifdef AGS_RUN_TESTS
+
+#include <string.h>
+#include <vector>
+#include "ac/spritecache.h"
+#include "debug/assert.h"
+#include "util/compress.h"
+#include "util/memorystream.h"
+
+using namespace AGS::Common;
+
+static const int TestSprWidth = 13;
+static const int TestSprHeight = 7;
+
+// Makes 16-bit sprite pixels
+static std::vector<int16_t> MakeTestPixels()
+{
+    std::vector<int16_t> pixels(TestSprWidth * TestSprHeight);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = (int16_t)(i * 1031);
+    return pixels;
+}
+
+// Writes uncompressed 16-bit sprite as stored in the file of the given version
+static std::vector<uint8_t> WriteRawSprite(SpriteFileVersion vers, const std::vector<int16_t> &pixels)
+{
+    MemoryStream out;
+    out.WriteInt16(2);
+    out.WriteInt16(TestSprWidth);
+    out.WriteInt16(TestSprHeight);
+    if (vers >= kSprfVersion_StorageFormats)
+    {
+        out.WriteInt8(kSprCompress_None);
+        out.WriteInt32(pixels.size() * sizeof(int16_t));
+    }
+    out.WriteArrayOfInt16(pixels.data(), pixels.size());
+    std::vector<uint8_t> data;
+    out.ReleaseBuffer(data);
+    return data;
+}
+
+// Tests reading the raw sprite from memory and from the stream, including
+// the data which ends too early, like in the incomplete mapped file
+static void Test_ReadRawSprite(SpriteFileVersion vers)
+{
+    const std::vector<int16_t> pixels = MakeTestPixels();
+    const std::vector<uint8_t> data = WriteRawSprite(vers, pixels);
+    const size_t header_size = data.size() - pixels.size() * sizeof(int16_t);
+    std::vector<int16_t> read_pixels(pixels.size());
+    const size_t pitch = TestSprWidth * sizeof(int16_t);
+
+    const uint8_t *p = data.data();
+    SpriteDataHeader hdr;
+    assert(SpriteCache::ReadSpriteHeader(p, data.data() + data.size(), vers, kSprCompress_None, hdr));
+    assert(p == data.data() + header_size);
+    assert(hdr.ColorDepth == 2 && hdr.Width == TestSprWidth && hdr.Height == TestSprHeight);
+    assert(hdr.Compression == kSprCompress_None);
+    assert(hdr.DataSize == pixels.size() * sizeof(int16_t));
+    assert(SpriteCache::ReadSpritePixels(p, data.data() + data.size(), hdr, (uint8_t*)read_pixels.data(), pitch));
+    assert(read_pixels == pixels);
+
+    // the pixel data is cut
+    assert(!SpriteCache::ReadSpritePixels(p, data.data() + data.size() - 1, hdr, (uint8_t*)read_pixels.data(), pitch));
+    assert(!SpriteCache::ReadSpritePixels(p, p, hdr, (uint8_t*)read_pixels.data(), pitch));
+    // the header is cut
+    for (size_t len = 1; len < header_size; ++len)
+    {
+        p = data.data();
+        assert(!SpriteCache::ReadSpriteHeader(p, data.data() + len, vers, kSprCompress_None, hdr));
+    }
+
+    // same from the stream
+    {
+        MemoryStream in(std::vector<uint8_t>(data), kFile_Read);
+        assert(SpriteCache::ReadSpriteHeader(&in, vers, kSprCompress_None, hdr));
+        std::fill(read_pixels.begin(), read_pixels.end(), 0);
+        assert(SpriteCache::ReadSpritePixels(&in, hdr, (uint8_t*)read_pixels.data(), pitch));
+        assert(read_pixels == pixels);
+    }
+    {
+        MemoryStream in(std::vector<uint8_t>(data.begin(), data.end() - 1), kFile_Read);
+        assert(SpriteCache::ReadSpriteHeader(&in, vers, kSprCompress_None, hdr));
+        assert(!SpriteCache::ReadSpritePixels(&in, hdr, (uint8_t*)read_pixels.data(), pitch));
+    }
+}
+
+// Tests LZ4 packing, and unpacking of the complete, cut and damaged data
+static void Test_LZ4(const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> packed;
+    lz4_compress(data.data(), data.size(), packed);
+    // the output is followed by the guard bytes, which must stay untouched
+    const uint8_t guard = 0xCD;
+    std::vector<uint8_t> out(data.size() + 16, guard);
+    assert(lz4_decompress(packed.data(), packed.size(), out.data(), data.size()));
+    assert(memcmp(out.data(), data.data(), data.size()) == 0);
+
+    // the data does not unpack into the exact size
+    if (data.size() > 0)
+        assert(!lz4_decompress(packed.data(), packed.size(), out.data(), data.size() - 1));
+    assert(!lz4_decompress(packed.data(), packed.size(), out.data(), data.size() + 1));
+    // the data is cut
+    for (size_t len = 0; len < packed.size(); ++len)
+        assert(!lz4_decompress(packed.data(), len, out.data(), data.size()));
+    // the data is damaged; it may unpack into garbage, but never out of bounds
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        std::vector<uint8_t> damaged = packed;
+        damaged[i] ^= 0x5A;
+        lz4_decompress(damaged.data(), damaged.size(), out.data(), data.size());
+        for (size_t g = data.size(); g < out.size(); ++g)
+            assert(out[g] == guard);
+    }
+}
+
+// Makes sprite pixels of the given color depth; the smooth ones compress well
+static std::vector<uint8_t> MakeSpritePixels(int coldep, bool smooth)
+{
+    std::vector<uint8_t> pixels(TestSprWidth * TestSprHeight * coldep);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < pixels.size() / coldep; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32_t value = smooth ? (uint32_t)(i / 8) * 0x01030507 : seed;
+        memcpy(&pixels[i * coldep], &value, coldep);
+    }
+    return pixels;
+}
+
+// Writes RLE compressed sprite as stored in the file of the given version
+static std::vector<uint8_t> WriteRLESprite(SpriteFileVersion vers, int coldep, const std::vector<uint8_t> &pixels)
+{
+    MemoryStream rle;
+    for (int y = 0; y < TestSprHeight; ++y)
+    {
+        const uint8_t *line = &pixels[y * TestSprWidth * coldep];
+        if (coldep == 1)
+            cpackbitl(line, TestSprWidth, &rle);
+        else if (coldep == 2)
+            cpackbitl16((const uint16_t*)line, TestSprWidth, &rle);
+        else
+            cpackbitl32((const uint32_t*)line, TestSprWidth, &rle);
+    }
+    MemoryStream out;
+    out.WriteInt16(coldep);
+    out.WriteInt16(TestSprWidth);
+    out.WriteInt16(TestSprHeight);
+    if (vers >= kSprfVersion_StorageFormats)
+        out.WriteInt8(kSprCompress_RLE);
+    out.WriteInt32(rle.GetLength());
+    out.Write(rle.GetBuffer().data(), rle.GetLength());
+    std::vector<uint8_t> data;
+    out.ReleaseBuffer(data);
+    return data;
+}
+
+// Reads the sprite from memory and from the stream, and compares with the
+// expected pixels; pixels are read into the buffer with the wider lines too
+static void Test_ReadSprite(const std::vector<uint8_t> &data, SpriteFileVersion vers, SpriteCompression file_cmp,
+    int coldep, SpriteCompression expect_cmp, const std::vector<uint8_t> &pixels)
+{
+    const size_t line_len = TestSprWidth * coldep;
+    for (size_t pitch = line_len; pitch <= line_len + 3; pitch += 3)
+    {
+        std::vector<uint8_t> read_pixels(pitch * TestSprHeight);
+        const uint8_t *p = data.data();
+        SpriteDataHeader hdr;
+        assert(SpriteCache::ReadSpriteHeader(p, data.data() + data.size(), vers, file_cmp, hdr));
+        assert(hdr.ColorDepth == coldep && hdr.Width == TestSprWidth && hdr.Height == TestSprHeight);
+        assert(hdr.Compression == expect_cmp);
+        assert(p + hdr.DataSize == data.data() + data.size());
+        assert(SpriteCache::ReadSpritePixels(p, data.data() + data.size(), hdr, read_pixels.data(), pitch));
+        for (int y = 0; y < TestSprHeight; ++y)
+            assert(memcmp(&read_pixels[y * pitch], &pixels[y * line_len], line_len) == 0);
+        // the compressed data is cut
+        if (hdr.Compression != kSprCompress_None)
+        {
+            for (size_t len = 0; len < hdr.DataSize; ++len)
+                assert(!SpriteCache::ReadSpritePixels(p, p + len, hdr, read_pixels.data(), pitch));
+        }
+
+        MemoryStream in(std::vector<uint8_t>(data), kFile_Read);
+        std::fill(read_pixels.begin(), read_pixels.end(), 0);
+        assert(SpriteCache::ReadSpriteHeader(&in, vers, file_cmp, hdr));
+        assert(SpriteCache::ReadSpritePixels(&in, hdr, read_pixels.data(), pitch));
+        assert(in.EOS());
+        for (int y = 0; y < TestSprHeight; ++y)
+            assert(memcmp(&read_pixels[y * pitch], &pixels[y * line_len], line_len) == 0);
+    }
+}
+
+// Tests that the written sprite reads back, and is stored in little-endian order
+static void Test_WriteSprite(int coldep, SpriteCompression cmp, bool smooth)
+{
+    const std::vector<uint8_t> pixels = MakeSpritePixels(coldep, smooth);
+    MemoryStream out;
+    SpriteCache::WriteSprite(&out, pixels.data(), TestSprWidth * coldep, TestSprWidth, TestSprHeight, coldep, cmp);
+    std::vector<uint8_t> data;
+    out.ReleaseBuffer(data);
+    // the random pixels do not compress, and are stored raw
+    const SpriteCompression expect_cmp = (cmp == kSprCompress_LZ4) && smooth ? kSprCompress_LZ4 : kSprCompress_None;
+    Test_ReadSprite(data, kSprfVersion_Current, kSprCompress_None, coldep, expect_cmp, pixels);
+
+    if (expect_cmp == kSprCompress_None)
+    {
+        const size_t header_size = data.size() - pixels.size();
+        uint32_t value = 0, stored = 0;
+        memcpy(&value, pixels.data(), coldep);
+        for (int i = 0; i < coldep; ++i)
+            stored |= data[header_size + i] << (i * 8);
+        assert(stored == value);
+    }
+}
+
+static void Test_ReadRLESprite(SpriteFileVersion vers, int coldep)
+{
+    const std::vector<uint8_t> pixels = MakeSpritePixels(coldep, true);
+    std::vector<uint8_t> data = WriteRLESprite(vers, coldep, pixels);
+    const SpriteCompression file_cmp = vers >= kSprfVersion_StorageFormats ? kSprCompress_None : kSprCompress_RLE;
+    Test_ReadSprite(data, vers, file_cmp, coldep, kSprCompress_RLE, pixels);
+
+    // the run is longer than the sprite line
+    const uint8_t *p = data.data();
+    SpriteDataHeader hdr;
+    assert(SpriteCache::ReadSpriteHeader(p, data.data() + data.size(), vers, file_cmp, hdr));
+    data[p - data.data()] = 0x81;
+    std::vector<uint8_t> read_pixels(pixels.size());
+    assert(!SpriteCache::ReadSpritePixels(p, data.data() + data.size(), hdr, read_pixels.data(), TestSprWidth * coldep));
+}
+
+// Tests copying the stored sprite data into the current sprite file format
+static void Test_CopySprite(const std::vector<uint8_t> &data, SpriteFileVersion vers, SpriteCompression file_cmp,
+    int coldep, bool compressed, const std::vector<uint8_t> &pixels)
+{
+    {
+        // the sprite is not copied into the output of other kind
+        MemoryStream in(std::vector<uint8_t>(data), kFile_Read);
+        MemoryStream out;
+        SpriteDataHeader hdr;
+        assert(!SpriteCache::CopySprite(&in, vers, file_cmp, &out, !compressed, hdr));
+        assert(out.GetLength() == 0);
+    }
+
+    MemoryStream in(std::vector<uint8_t>(data), kFile_Read);
+    MemoryStream out;
+    SpriteDataHeader hdr;
+    assert(SpriteCache::CopySprite(&in, vers, file_cmp, &out, compressed, hdr));
+    assert(in.EOS());
+    assert(hdr.ColorDepth == coldep && hdr.Width == TestSprWidth && hdr.Height == TestSprHeight);
+    // the data in the current format is copied without changes
+    if (vers == kSprfVersion_Current)
+        assert(out.GetBuffer() == data);
+    Test_ReadSprite(out.GetBuffer(), kSprfVersion_Current, kSprCompress_None, coldep, hdr.Compression, pixels);
+}
+
+void Test_SpriteFile()
+{
+    Test_ReadRawSprite(kSprfVersion_HighSpriteLimit);
+    Test_ReadRawSprite(kSprfVersion_StorageFormats);
+
+    std::vector<uint8_t> data;
+    Test_LZ4(data);
+    data.assign(5, 7);
+    Test_LZ4(data);
+    for (size_t i = 0; i < 5000; ++i)
+        data.push_back((uint8_t)(i / 300)); // long matches
+    Test_LZ4(data);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data.push_back((uint8_t)(seed >> 16)); // long literals
+    }
+    Test_LZ4(data);
+
+    const int coldeps[] = { 1, 2, 4 };
+    for (int coldep : coldeps)
+    {
+        Test_WriteSprite(coldep, kSprCompress_None, true);
+        Test_WriteSprite(coldep, kSprCompress_LZ4, true);
+        Test_WriteSprite(coldep, kSprCompress_LZ4, false);
+        Test_ReadRLESprite(kSprfVersion_HighSpriteLimit, coldep);
+        Test_ReadRLESprite(kSprfVersion_StorageFormats, coldep);
+
+        const std::vector<uint8_t> pixels = MakeSpritePixels(coldep, true);
+        Test_CopySprite(WriteRLESprite(kSprfVersion_HighSpriteLimit, coldep, pixels),
+            kSprfVersion_HighSpriteLimit, kSprCompress_RLE, coldep, true, pixels);
+        Test_CopySprite(WriteRLESprite(kSprfVersion_StorageFormats, coldep, pixels),
+            kSprfVersion_StorageFormats, kSprCompress_None, coldep, true, pixels);
+        MemoryStream out;
+        SpriteCache::WriteSprite(&out, pixels.data(), TestSprWidth * coldep, TestSprWidth, TestSprHeight, coldep, kSprCompress_LZ4);
+        Test_CopySprite(out.GetBuffer(), kSprfVersion_StorageFormats, kSprCompress_None, coldep, true, pixels);
+        out.Seek(0, kSeekBegin);
+        SpriteCache::WriteSprite(&out, pixels.data(), TestSprWidth * coldep, TestSprWidth, TestSprHeight, coldep, kSprCompress_None);
+        Test_CopySprite(out.GetBuffer(), kSprfVersion_StorageFormats, kSprCompress_None, coldep, false, pixels);
+    }
+
+    // no sprite in this slot
+    const uint8_t empty[] = { 0, 0 };
+    const uint8_t *p = empty;
+    SpriteDataHeader hdr;
+    assert(SpriteCache::ReadSpriteHeader(p, empty + sizeof(empty), kSprfVersion_Current, kSprCompress_None, hdr));
+    assert(hdr.ColorDepth == 0);
+    MemoryStream in(std::vector<uint8_t>(empty, empty + sizeof(empty)), kFile_Read);
+    MemoryStream out;
+    assert(SpriteCache::CopySprite(&in, kSprfVersion_Current, kSprCompress_None, &out, true, hdr));
+    assert(out.GetBuffer() == std::vector<uint8_t>(empty, empty + sizeof(empty)));
+}
+
+#endif // AGS_RUN_TESTS